@@ -5,9 +5,12 @@
  * José Alexandre Nalon
  **************************************************************************************************
  * This program doesn't need much to be compiled and run. It can be done, as far as I know, with
- * any C++ compiler, just remember to link the math library. In my box, I used the command:
+ * any C++ compiler, just remember to link the math library. Optimizations should be turned on, so
+ * the compiler can vectorize the butterflies of the mixed radix transform (the -fopenmp-simd flag
+ * enables the directives that mark the loops to be vectorized, without the rest of OpenMP). In my
+ * box, I used the command:
  *
- * $ g++ -o anyfft anyfft.cpp -lm
+ * $ g++ -O3 -march=native -fopenmp-simd -o anyfft anyfft.cpp -lm
  *
  * It can be run with the command (remember to change permission to execute):
  *
@@ -28,6 +31,8 @@
 #include <array>                               // Deals with arrays;
 #include <cmath>                               // Math Functions;
 #include <chrono>                              // Time measurement;
+#include <map>                                 // Cache of plans;
+#include <vector>                              // Plans and buffers;
 
 using namespace std;
 
@@ -36,6 +41,7 @@ using namespace std;
  Definitions:
  **************************************************************************************************/
 #define REPEAT 500                             // Number of executions to compute average time;
+#define LANES 8                                // Transforms needed to vectorize over them;
 
 
 /**************************************************************************************************
@@ -145,7 +151,7 @@ float time_it(void (*f)(Complex *, Complex *, int), int size, int repeat)
     for(int j=0; j<repeat; j++)
         (*f)(x, X, size);
     auto t1 = chrono::steady_clock::now();     // End of time measuring;
-    return chrono::duration_cast<chrono::seconds>(t1 - t0).count() / (float) repeat;
+    return chrono::duration<float>(t1 - t0).count() / (float) repeat;
 }
 
 
@@ -250,34 +256,397 @@ void recursive_fft(Complex x[], Complex X[], int N)
 }
 
 
+/**************************************************************************************************
+ Plans for the mixed radix transform. Every stage combines P subsequences of length n/P; its
+ twiddle factors are kept in separate buffers for real and imaginary parts, with the factor
+ W_n^(qj) in the position (j-1)*(n/P) + q. Generic stages also keep the roots of unity of order P:
+ **************************************************************************************************/
+struct Stage {
+    int P;                                     // Radix;
+    int n;                                     // Length of the transforms of the stage;
+    int s;                                     // Distance between elements of the same transform;
+    vector<float> wr, wi;                      // Twiddle factors;
+    vector<float> cr, ci;                      // Roots of unity, for generic stages;
+};
+
+struct Plan {
+    int N;                                     // Length of the transform;
+    vector<Stage> stages;                      // Stages of the transform;
+    vector<float> xr, xi, yr, yi;              // Buffers, real and imaginary parts;
+};
+
+map<int, Plan *> plans;                        // Cache of plans, indexed by the length;
+
+
+/**************************************************************************************************
+ * Function: get_plan
+ *   Looks for a plan in the cache, creating it if it doesn't exist. The length is decomposed in
+ *   factors 4, 2, 3, 5, 7, 11 and 13, in that order, that have specialized butterflies. Any other
+ *   prime factor is computed by a generic stage.
+ *
+ * Parameters:
+ *   N
+ *     The length of the transform.
+ *
+ * Returns:
+ *   A pointer to the plan. It is owned by the cache and must not be released.
+ **************************************************************************************************/
+Plan *get_plan(int N)
+{
+    auto p = plans.find(N);
+    if(p != plans.end())                       // Plan was already computed;
+        return p->second;
+
+    Plan *plan = new Plan;
+    plan->N = N;
+    plan->xr.resize(N);
+    plan->xi.resize(N);
+    plan->yr.resize(N);
+    plan->yi.resize(N);
+    int RADICES[] = { 4, 2, 3, 5, 7, 11, 13 };
+    int n = N, s = 1;
+    while(n > 1) {
+        int P = factor(n);
+        for(int r: RADICES)
+            if(n % r == 0) {
+                P = r;
+                break;
+            }
+        Stage st;
+        st.P = P;
+        st.n = n;
+        st.s = s;
+        int m = n / P;
+        st.wr.resize((P-1) * m);
+        st.wi.resize((P-1) * m);
+        for(int j=1; j<P; j++)                 // Twiddle factors computed directly;
+            for(int q=0; q<m; q++) {
+                Complex w = cexpn(-2*M_PI*((long) q*j % n)/n);
+                st.wr[(j-1)*m + q] = w.r;
+                st.wi[(j-1)*m + q] = w.i;
+            }
+        for(int k=0; k<P; k++) {               // Roots of unity;
+            Complex w = cexpn(-2*M_PI*k/P);
+            st.cr.push_back(w.r);
+            st.ci.push_back(w.i);
+        }
+        plan->stages.push_back(st);
+        n = m;
+        s = s * P;
+    }
+    plans[N] = plan;
+    return plan;
+}
+
+
+/**************************************************************************************************
+ Roots of unity of order P, cos(2 pi k/P) and sin(2 pi k/P), for the specialized butterflies:
+ **************************************************************************************************/
+template<int P>
+struct Roots {
+    float c[P], s[P];
+    Roots() {
+        for(int k=0; k<P; k++) {
+            c[k] = cos(2*M_PI*k/P);
+            s[k] = sin(2*M_PI*k/P);
+        }
+    }
+};
+
+template<int P> Roots<P> roots;                // Global, so it isn't initialized in the loops;
+
+
+/**************************************************************************************************
+ * Auxiliary function: unroll
+ *   Calls a function for every integer from I to N-1, known at compile time, so the loop is
+ *   always unrolled and the indices of the arrays in the butterflies are constants.
+ *
+ * Parameters:
+ *   f
+ *     The function, that receives the index.
+ **************************************************************************************************/
+template<int I, int N, class F>
+__attribute__((always_inline))
+inline void unroll(F f)
+{
+    if constexpr(I < N) {
+        f(I);
+        unroll<I+1, N>(f);
+    }
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: butterfly
+ *   Computes a butterfly of radix P: the DFT of P elements, with the results multiplied by the
+ *   twiddle factors. For an odd radix, the elements r and P-r are added and subtracted first, so
+ *   only about half the products of the direct DFT are needed. This is always inlined and
+ *   completely unrolled, so the loops over independent butterflies that call it are vectorized.
+ *
+ * Parameters:
+ *   xr, xi
+ *     First element of the butterfly, real and imaginary parts;
+ *   is
+ *     Distance between the elements of the butterfly;
+ *   yr, yi
+ *     First result, real and imaginary parts;
+ *   os
+ *     Distance between the results;
+ *   wr, wi
+ *     Twiddle factor of the second result; the next ones are at multiples of ws;
+ *   ws
+ *     Distance between the twiddle factors.
+ **************************************************************************************************/
+template<int P>
+__attribute__((always_inline))
+inline void butterfly(const float *xr, const float *xi, int is, float *yr, float *yi, int os,
+                      const float *wr, const float *wi, int ws)
+{
+    const Roots<P> &w = roots<P>;
+    float ar[P], ai[P], br[P], bi[P];
+    unroll<0, P>([&](int r) __attribute__((always_inline)) {
+        ar[r] = xr[r*is];
+        ai[r] = xi[r*is];
+    });
+    if constexpr(P == 2) {
+        br[0] = ar[0] + ar[1];
+        bi[0] = ai[0] + ai[1];
+        br[1] = ar[0] - ar[1];
+        bi[1] = ai[0] - ai[1];
+    } else if constexpr(P == 4) {              // Multiplications by -i are exchanges;
+        float t0r = ar[0] + ar[2], t0i = ai[0] + ai[2];
+        float t1r = ar[0] - ar[2], t1i = ai[0] - ai[2];
+        float t2r = ar[1] + ar[3], t2i = ai[1] + ai[3];
+        float t3r = ar[1] - ar[3], t3i = ai[1] - ai[3];
+        br[0] = t0r + t2r;
+        bi[0] = t0i + t2i;
+        br[1] = t1r + t3i;
+        bi[1] = t1i - t3r;
+        br[2] = t0r - t2r;
+        bi[2] = t0i - t2i;
+        br[3] = t1r - t3i;
+        bi[3] = t1i + t3r;
+    } else {                                   // Odd radix;
+        const int H = (P - 1) / 2;
+        float tr[H+1], ti[H+1], ur[H+1], ui[H+1];
+        br[0] = ar[0];
+        bi[0] = ai[0];
+        unroll<1, H+1>([&](int r) __attribute__((always_inline)) {
+            tr[r] = ar[r] + ar[P-r];
+            ti[r] = ai[r] + ai[P-r];
+            ur[r] = ar[r] - ar[P-r];
+            ui[r] = ai[r] - ai[P-r];
+            br[0] += tr[r];
+            bi[0] += ti[r];
+        });
+        unroll<1, H+1>([&](int j) __attribute__((always_inline)) {
+            float cr = ar[0], ci = ai[0], sr = 0, si = 0;
+            unroll<1, H+1>([&](int r) __attribute__((always_inline)) {
+                int k = (j*r) % P;
+                cr += tr[r] * w.c[k];
+                ci += ti[r] * w.c[k];
+                sr += ur[r] * w.s[k];
+                si += ui[r] * w.s[k];
+            });
+            br[j] = cr + si;                   // Results j and P-j share the products;
+            bi[j] = ci - sr;
+            br[P-j] = cr - si;
+            bi[P-j] = ci + sr;
+        });
+    }
+    yr[0] = br[0];
+    yi[0] = bi[0];
+    unroll<1, P>([&](int j) __attribute__((always_inline)) {
+        float c = wr[(j-1)*ws], d = wi[(j-1)*ws];
+        yr[j*os] = br[j]*c - bi[j]*d;          // Twiddle factors;
+        yi[j*os] = br[j]*d + bi[j]*c;
+    });
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: stage
+ *   Computes a stage of the mixed radix transform (Stockham algorithm). The element q + r*(n/P) of
+ *   every transform of length n goes to the butterfly q, and the result j goes to the position
+ *   P*q + j. There are n/P butterflies for each of the s transforms, all of them independent; the
+ *   inner loop runs over the transforms when there are enough of them, or else over the
+ *   butterflies of the same transform, and it is vectorized.
+ *
+ * Parameters:
+ *   st
+ *     The stage;
+ *   xr, xi
+ *     The input, real and imaginary parts;
+ *   yr, yi
+ *     The output, real and imaginary parts.
+ **************************************************************************************************/
+template<int P>
+void stage(Stage &st, float *__restrict xr, float *__restrict xi, float *__restrict yr,
+           float *__restrict yi)
+{
+    int m = st.n / P, s = st.s;
+    const float *wr = st.wr.data(), *wi = st.wi.data();
+    if(s >= LANES)
+        for(int q=0; q<m; q++) {
+            #pragma omp simd
+            for(int k=0; k<s; k++)             // Same twiddle factors for all transforms;
+                butterfly<P>(xr + k + s*q, xi + k + s*q, s*m, yr + k + s*P*q, yi + k + s*P*q, s,
+                             wr + q, wi + q, m);
+        }
+    else
+        for(int k=0; k<s; k++) {
+            #pragma omp simd
+            for(int q=0; q<m; q++)
+                butterfly<P>(xr + k + s*q, xi + k + s*q, s*m, yr + k + s*P*q, yi + k + s*P*q, s,
+                             wr + q, wi + q, m);
+        }
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: generic_stage
+ *   Computes a stage of the mixed radix transform for a radix without a specialized butterfly,
+ *   with the DFT of every butterfly computed directly.
+ *
+ * Parameters:
+ *   st
+ *     The stage;
+ *   xr, xi
+ *     The input, real and imaginary parts;
+ *   yr, yi
+ *     The output, real and imaginary parts.
+ **************************************************************************************************/
+void generic_stage(Stage &st, float *xr, float *xi, float *yr, float *yi)
+{
+    int P = st.P, m = st.n / P, s = st.s;
+    for(int q=0; q<m; q++)
+        for(int k=0; k<s; k++)
+            for(int j=0; j<P; j++) {
+                Complex b = Complex(0, 0);
+                for(int r=0; r<P; r++) {
+                    int l = (j*r) % P;
+                    int i = k + s*(q + r*m);
+                    b = b + Complex(xr[i], xi[i]) * Complex(st.cr[l], st.ci[l]);
+                }
+                if(j > 0)
+                    b = b * Complex(st.wr[(j-1)*m + q], st.wi[(j-1)*m + q]);
+                yr[k + s*(P*q + j)] = b.r;
+                yi[k + s*(P*q + j)] = b.i;
+            }
+}
+
+
+/**************************************************************************************************
+ * Function: mixed_fft
+ *   Fast Fourier Transform using an iterative mixed radix algorithm (Stockham). Every stage reads
+ *   one buffer and writes the other, so the results end in natural order with no reordering. The
+ *   butterflies of radices 2, 3, 4, 5, 7, 11 and 13 are specialized and vectorized over many
+ *   independent butterflies at once.
+ *
+ * Parameters:
+ *   x
+ *     The vector of which the FFT will be computed. There is no restriction on its length, but it
+ *     will be faster when it has only small prime factors;
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call;
+ *   N
+ *     The number of elements in the vector.
+ **************************************************************************************************/
+void mixed_fft(Complex x[], Complex X[], int N)
+{
+    Plan *plan = get_plan(N);
+    float *xr = plan->xr.data(), *xi = plan->xi.data();
+    float *yr = plan->yr.data(), *yi = plan->yi.data();
+    for(int n=0; n<N; n++) {                   // Separate real and imaginary parts;
+        xr[n] = x[n].r;
+        xi[n] = x[n].i;
+    }
+    for(Stage &st: plan->stages) {
+        switch(st.P) {
+            case 2: stage<2>(st, xr, xi, yr, yi); break;
+            case 3: stage<3>(st, xr, xi, yr, yi); break;
+            case 4: stage<4>(st, xr, xi, yr, yi); break;
+            case 5: stage<5>(st, xr, xi, yr, yi); break;
+            case 7: stage<7>(st, xr, xi, yr, yi); break;
+            case 11: stage<11>(st, xr, xi, yr, yi); break;
+            case 13: stage<13>(st, xr, xi, yr, yi); break;
+            default: generic_stage(st, xr, xi, yr, yi);
+        }
+        swap(xr, yr);                          // Results are the input of the next stage;
+        swap(xi, yi);
+    }
+    for(int n=0; n<N; n++)
+        X[n] = Complex(xr[n], xi[n]);
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: mixed_error
+ *   Relative error of the mixed radix transform, in the euclidean norm, against the transform
+ *   computed from the definition in double precision.
+ *
+ * Parameters:
+ *  N
+ *    Number of elements in the vector.
+ *
+ * Returns:
+ *   The relative error.
+ **************************************************************************************************/
+float mixed_error(int N)
+{
+    vector<Complex> x(N), X(N);
+    for(int j=0; j<N; j++)                     // Initialize the vector;
+        x[j] = Complex(j % 7 - 3, j % 5 - 2);
+    mixed_fft(x.data(), X.data(), N);
+    double e = 0, s = 0;
+    for(int k=0; k<N; k++) {
+        double yr = 0, yi = 0;                 // Definition, in double precision;
+        for(int n=0; n<N; n++) {
+            double a = -2*M_PI * ((long) k*n % N) / N;
+            yr += x[n].r * cos(a) - x[n].i * sin(a);
+            yi += x[n].r * sin(a) + x[n].i * cos(a);
+        }
+        e += (X[k].r - yr) * (X[k].r - yr) + (X[k].i - yi) * (X[k].i - yi);
+        s += yr*yr + yi*yi;
+    }
+    return sqrt(e / s);
+}
+
+
 /**************************************************************************************************
  Main Function:
  **************************************************************************************************/
 int main(int argc, char *argv[]) {
 
-    int SIZES[] = { 2*3, 2*2*3, 2*3*3, 2*3*5, 2*2*3*3, 2*2*5*5, 2*3*5*7, 2*2*3*3*5*5 };
+    int SIZES[] = { 2*3, 2*2*3, 2*3*3, 2*3*5, 2*2*3*3, 2*2*11, 2*3*13, 2*2*5*5, 2*3*5*7, 2*11*13,
+                    2*2*3*3*5*5, 2*2*3*7*11 };
 
     // Start by printing the table with time comparisons:
-    cout << "+---------+---------+---------+---------+" << endl;
-    cout << "|    N    |   N^2   | Direct  | Recurs. |" << endl;
-    cout << "+---------+---------+---------+---------+" << endl;
+    cout << "+---------+---------+---------+---------+---------+---------+" << endl;
+    cout << "|    N    |   N^2   | Direct  | Recurs. |  Mixed  | Error   |" << endl;
+    cout << "+---------+---------+---------+---------+---------+---------+" << endl;
 
     // Try it with vectors with the given sizes:
-    for(int i=0; i<8; i++) {
+    for(int i=0; i<12; i++) {
 
-        // Compute the average execution time:
+        // Compute the average execution time and the error of the mixed radix transform:
         int n = SIZES[i];
         float dtime = time_it(direct_ft, n, REPEAT);
         float rtime = time_it(recursive_fft, n, REPEAT);
+        float mtime = time_it(mixed_fft, n, REPEAT);
+        float error = mixed_error(n);
 
         // Print the results:
         cout << "| " << setw(7) <<     n << " ";
         cout << "| " << setw(7) <<   n*n << " ";
         cout << "| " << setw(7) << setprecision(7) << dtime << " ";
-        cout << "| " << setw(7) << setprecision(7) << rtime << " |" << endl;
+        cout << "| " << setw(7) << setprecision(7) << rtime << " ";
+        cout << "| " << setw(7) << setprecision(7) << mtime << " ";
+        cout << "| " << setw(7) << setprecision(7) << error << " |" << endl;
     }
 
-    cout << "+---------+---------+---------+---------+" << endl;
+    cout << "+---------+---------+---------+---------+---------+---------+" << endl;
 
     return 0;
 }
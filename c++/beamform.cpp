@@ -0,0 +1,529 @@
+/**************************************************************************************************
+ * Fast Fourier Transform -- C++ Version
+ * This version implements a frequency domain beamformer for an array of sensors.
+ *
+ * José Alexandre Nalon
+ **************************************************************************************************
+ * This program doesn't need much to be compiled and run. It can be done, as far as I know, with
+ * any C++ compiler, just remember to link the math and threads libraries. Optimizations should be
+ * turned on, so the compiler can vectorize the inner loops. In my box, I used the command:
+ *
+ * $ g++ -O3 -march=native -o beamform beamform.cpp -lm -lpthread
+ *
+ * It can be run with the command (remember to change permission to execute):
+ *
+ * $ ./beamform
+ *
+ * Obs.: A beamformer combines the signals of an array of sensors (microphones, for instance) so
+ *   that the sound coming from a given direction is reinforced. In the frequency domain, every
+ *   bin of every beam is a weighted sum of the same bin in every channel, so there are three
+ *   steps: transform every channel, multiply the vector of channels by a matrix of weights in
+ *   every bin, and compute the inverse transform of every beam. Here, many frames are processed
+ *   at once. The spectra are kept in a layout with bins first, then channels, then frames, with
+ *   separate buffers for real and imaginary parts; that way, the weights of a bin multiply a
+ *   small matrix of channels by frames, and the innermost loop (over frames) is contiguous and
+ *   can be vectorized. Bins are processed in blocks that fit in the cache, and the transforms of
+ *   channels and beams are split among threads.
+ **************************************************************************************************/
+
+/**************************************************************************************************
+ Include necessary libraries:
+ **************************************************************************************************/
+#include <iostream>                            // Input and Output;
+#include <iomanip>                             // I/O Manipulation;
+#include <cmath>                               // Math Functions;
+#include <chrono>                              // Time measurement;
+#include <vector>                              // Buffers;
+#include <functional>                          // Work given to threads;
+#include <thread>                              // Threads;
+
+using namespace std;
+
+
+/**************************************************************************************************
+ Definitions:
+ **************************************************************************************************/
+#define REPEAT 20                              // Number of executions to compute average time;
+#define LENGTH 512                             // Length of the frames;
+#define FRAMES 16                              // Number of frames processed at once;
+#define BEAMS 8                                // Number of beams;
+#define BIN_BLOCK 16                           // Number of bins processed together;
+
+
+/**************************************************************************************************
+ Small class to operate with complex numbers:
+ **************************************************************************************************/
+class Complex {
+    public:
+        float r;                               // Real part;
+        float i;                               // Imaginary part;
+        Complex();                             // Constructors;
+        Complex(float re, float im);
+        void set(float re, float im);
+        void set(Complex c);
+        Complex operator+(Complex c);          // Addition (overload + operator);
+        Complex operator-(Complex c);          // Subtraction (overload - operator);
+        Complex operator*(Complex c);          // Product (overload * operator);
+        Complex operator*(float a);            // Product with a scalar;
+        Complex cexp();                        // Complex exponential;
+};
+
+Complex::Complex() {                           // Constructor;
+    r = 0.0;                                   // Real part;
+    i = 0.0;                                   // Imaginary part;
+}
+
+Complex::Complex(float re, float im) {         // Constructor;
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(float re, float im) {
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(Complex c) {
+    r = c.r;                                   // Real part;
+    i = c.i;                                   // Imaginary part;
+}
+
+Complex Complex::operator+(Complex c) {
+    return Complex(r + c.r, i + c.i);
+}
+
+Complex Complex::operator-(Complex c) {
+    return Complex(r - c.r, i - c.i);
+}
+
+Complex Complex::operator*(Complex c) {
+    return Complex(r*c.r - i*c.i, r*c.i + i*c.r);
+}
+
+Complex Complex::operator*(float a) {
+    return Complex(a*r, a*i);
+}
+
+Complex Complex::cexp() {
+    return Complex(exp(r)*cos(i), exp(r)*sin(i));
+}
+
+Complex cexpn(float a) {                       // Convenience function to compute the exponential;
+    return Complex(cos(a), sin(a));
+}
+
+
+/**************************************************************************************************
+ * Function: bit_reverse
+ *   Bit-reversed version of an integer number.
+ *
+ * Parameters:
+ *   k
+ *     The number to be bit-reversed;
+ *   r
+ *     The number of bits to take into consideration when reversing.
+ *
+ * Returns:
+ *   The number k, bit-reversed according to integers with r bits.
+ **************************************************************************************************/
+int bit_reverse(int k, int r)
+{
+    int l = 0;                                 // Accumulate the results;
+    for(int i=0; i<r; i++) {                   // Loop on every bit;
+        l = (l << 1) + (k & 1);                // Test less signficant bit and add;
+        k >>= 1;                               // Test next bit;
+    }
+    return l;
+}
+
+
+/**************************************************************************************************
+ Plans hold everything that depends only on the length of the transform:
+ **************************************************************************************************/
+struct Plan {
+    int N;                                     // Length of the transform;
+    vector<int> rev;                           // Bit-reversed indices;
+    vector<Complex> W;                         // Twiddle factors, W[n] = exp(-2 pi n/N);
+};
+
+
+/**************************************************************************************************
+ * Function: make_plan
+ *   Computes the plan for a given length.
+ *
+ * Parameters:
+ *   N
+ *     The length of the transform. It must be a power of two.
+ *
+ * Returns:
+ *   The plan.
+ **************************************************************************************************/
+Plan make_plan(int N)
+{
+    Plan plan;
+    plan.N = N;
+    int r = (int) floor(log2(N));              // Number of bits;
+    plan.rev.resize(N);
+    for(int k=0; k<N; k++)                     // Bit-reversed order;
+        plan.rev[k] = bit_reverse(k, r);
+    plan.W.resize(N/2 + 1);
+    for(int n=0; n<=N/2; n++)                  // Twiddle factors computed directly;
+        plan.W[n] = cexpn(-2*M_PI*n/N);
+    return plan;
+}
+
+
+/**************************************************************************************************
+ * Function: fft
+ *   Fast Fourier Transform using an iterative in-place decimation in time algorithm, with the
+ *   twiddle factors taken from the plan. The inverse transform is computed by conjugation, and
+ *   it is not divided by N.
+ *
+ * Parameters:
+ *   plan
+ *     Plan for the length of the transform;
+ *   x
+ *     The vector of which the FFT will be computed;
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call, and it can't be the same as the input;
+ *   inverse
+ *     If true, computes the inverse transform.
+ **************************************************************************************************/
+void fft(Plan &plan, Complex x[], Complex X[], bool inverse)
+{
+    int N = plan.N;
+    for(int k=0; k<N; k++) {                   // Reorder the vector according to the
+        int l = plan.rev[k];                   //   bit-reversed order;
+        X[l] = inverse ? Complex(x[k].r, -x[k].i) : x[k];
+    }
+
+    for(int step=1; step<N; step<<=1) {
+        int stride = N / (2*step);             // Distance between twiddle factors in the table;
+        for(int l=0; l<N; l+=2*step)
+            for(int n=0; n<step; n++) {
+                int p = l + n;
+                int q = p + step;
+                Complex w = plan.W[n*stride] * X[q];
+                X[q] = X[p] - w;               // Recombine results;
+                X[p] = X[p] + w;
+            }
+    }
+
+    if(inverse)                                // Conjugate back;
+        for(int k=0; k<N; k++)
+            X[k].i = -X[k].i;
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: parallel_for
+ *   Splits a range of indices among a number of threads, and waits for all of them.
+ *
+ * Parameters:
+ *   n
+ *     Number of indices; they range from 0 to n-1;
+ *   threads
+ *     Number of threads;
+ *   f
+ *     Function to be called by every thread, with the first and one past the last index.
+ **************************************************************************************************/
+void parallel_for(int n, int threads, function<void(int, int)> f)
+{
+    vector<thread> workers;
+    int per = (n + threads - 1) / threads;
+    for(int i=per; i<n; i+=per)                // First part is computed by this thread;
+        workers.push_back(thread(f, i, min(n, i + per)));
+    f(0, min(n, per));
+    for(auto &w : workers)
+        w.join();
+}
+
+
+/**************************************************************************************************
+ Class that implements the beamformer. The weights are given for every bin, beam and channel, and
+ the beams are the sums of the channels multiplied by the weights:
+ **************************************************************************************************/
+class Beamformer {
+    public:
+        Beamformer(int C, int B, int N, int F, vector<Complex> &weights, int threads);
+        void process(Complex x[], Complex y[]);
+    private:
+        int C;                                 // Number of channels;
+        int B;                                 // Number of beams;
+        int N;                                 // Length of the frames;
+        int F;                                 // Number of frames;
+        int threads;                           // Number of threads;
+        Plan plan;                             // Plan of the transforms;
+        vector<float> Wr, Wi;                  // Weights, by bin, beam and channel;
+        vector<float> Xr, Xi;                  // Spectra of channels, by bin, channel and frame;
+        vector<float> Yr, Yi;                  // Spectra of beams, by bin, beam and frame;
+};
+
+
+/**************************************************************************************************
+ * Method: Beamformer::Beamformer
+ *   Creates the beamformer.
+ *
+ * Parameters:
+ *   C
+ *     The number of channels;
+ *   B
+ *     The number of beams;
+ *   N
+ *     The length of the frames. It must be a power of two;
+ *   F
+ *     The number of frames processed in every call;
+ *   weights
+ *     The weights of every bin, beam and channel, in this order (that is, the weight of channel c
+ *     in beam b at bin k is weights[(k*B + b)*C + c]);
+ *   threads
+ *     The number of threads.
+ **************************************************************************************************/
+Beamformer::Beamformer(int C, int B, int N, int F, vector<Complex> &weights, int threads)
+    : Wr(N*B*C), Wi(N*B*C), Xr(N*C*F), Xi(N*C*F), Yr(N*B*F), Yi(N*B*F) {
+    this->C = C;
+    this->B = B;
+    this->N = N;
+    this->F = F;
+    this->threads = threads;
+    plan = make_plan(N);
+    for(int j=0; j<N*B*C; j++) {               // Separate real and imaginary parts;
+        Wr[j] = weights[j].r;
+        Wi[j] = weights[j].i;
+    }
+}
+
+
+/**************************************************************************************************
+ * Method: Beamformer::process
+ *   Computes the beams for a number of frames of every channel.
+ *
+ * Parameters:
+ *   x
+ *     The frames of every channel. Frame f of channel c starts at x[(c*F + f)*N];
+ *   y
+ *     Receives the frames of every beam. Frame f of beam b starts at y[(b*F + f)*N].
+ **************************************************************************************************/
+void Beamformer::process(Complex x[], Complex y[])
+{
+    // Transform every frame of every channel:
+    parallel_for(C, threads, [&](int c0, int c1) {
+        vector<Complex> X(N);
+        for(int c=c0; c<c1; c++)
+            for(int f=0; f<F; f++) {
+                fft(plan, x + (long) (c*F + f)*N, X.data(), false);
+                for(int k=0; k<N; k++) {       // Bins first, then channels and frames;
+                    long j = ((long) k*C + c)*F + f;
+                    Xr[j] = X[k].r;
+                    Xi[j] = X[k].i;
+                }
+            }
+    });
+
+    // Multiply the channels by the weights, in every bin:
+    int blocks = (N + BIN_BLOCK - 1) / BIN_BLOCK;
+    parallel_for(blocks, threads, [&](int b0, int b1) {
+        for(int k=b0*BIN_BLOCK; k<min(N, b1*BIN_BLOCK); k++)
+            for(int b=0; b<B; b++) {
+                float *yr = &Yr[((long) k*B + b)*F], *yi = &Yi[((long) k*B + b)*F];
+                for(int f=0; f<F; f++) {
+                    yr[f] = 0;
+                    yi[f] = 0;
+                }
+                for(int c=0; c<C; c++) {
+                    float wr = Wr[((long) k*B + b)*C + c], wi = Wi[((long) k*B + b)*C + c];
+                    float *xr = &Xr[((long) k*C + c)*F], *xi = &Xi[((long) k*C + c)*F];
+                    for(int f=0; f<F; f++) {   // This loop is vectorized;
+                        yr[f] += wr*xr[f] - wi*xi[f];
+                        yi[f] += wr*xi[f] + wi*xr[f];
+                    }
+                }
+            }
+    });
+
+    // Inverse transform of every frame of every beam:
+    parallel_for(B, threads, [&](int e0, int e1) {
+        vector<Complex> Y(N);
+        for(int b=e0; b<e1; b++)
+            for(int f=0; f<F; f++) {
+                for(int k=0; k<N; k++) {
+                    long j = ((long) k*B + b)*F + f;
+                    Y[k] = Complex(Yr[j], Yi[j]);
+                }
+                Complex *yb = y + (long) (b*F + f)*N;
+                fft(plan, Y.data(), yb, true);
+                for(int n=0; n<N; n++)
+                    yb[n] = yb[n] * (1.0 / N);
+            }
+    });
+}
+
+
+/**************************************************************************************************
+ * Function: simple_beamformer
+ *   Computes the beams frame by frame, with no care for the layout of the data. It is used as a
+ *   reference.
+ *
+ * Parameters:
+ *   C, B, N, F
+ *     Number of channels, beams, length of frames and number of frames;
+ *   weights
+ *     The weights, with the same layout used in the Beamformer class;
+ *   x
+ *     The frames of every channel. Frame f of channel c starts at x[(c*F + f)*N];
+ *   y
+ *     Receives the frames of every beam. Frame f of beam b starts at y[(b*F + f)*N].
+ **************************************************************************************************/
+void simple_beamformer(int C, int B, int N, int F, vector<Complex> &weights, Complex x[],
+                       Complex y[])
+{
+    Plan plan = make_plan(N);
+    vector<Complex> X(C*N), Y(N);
+    for(int f=0; f<F; f++) {
+        for(int c=0; c<C; c++)
+            fft(plan, x + (long) (c*F + f)*N, &X[c*N], false);
+        for(int b=0; b<B; b++) {
+            for(int k=0; k<N; k++) {
+                Y[k] = Complex(0, 0);
+                for(int c=0; c<C; c++)
+                    Y[k] = Y[k] + weights[((long) k*B + b)*C + c] * X[c*N + k];
+            }
+            Complex *yb = y + (long) (b*F + f)*N;
+            fft(plan, Y.data(), yb, true);
+            for(int n=0; n<N; n++)
+                yb[n] = yb[n] * (1.0 / N);
+        }
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: steering_weights
+ *   Weights of a delay and sum beamformer, for a linear array of equally spaced sensors. The beam
+ *   b points to an angle between -60 and 60 degrees, and the delay of every sensor is compensated
+ *   by a phase rotation.
+ *
+ * Parameters:
+ *   C, B, N
+ *     Number of channels, beams and length of frames;
+ *   spacing
+ *     Spacing between sensors, in samples of propagation.
+ *
+ * Returns:
+ *   The weights, in the layout used by the Beamformer class.
+ **************************************************************************************************/
+vector<Complex> steering_weights(int C, int B, int N, float spacing)
+{
+    vector<Complex> w((long) N*B*C);
+    for(int b=0; b<B; b++) {
+        float angle = (B == 1) ? 0 : M_PI/3 * (2.0*b/(B-1) - 1);
+        for(int c=0; c<C; c++) {
+            float tau = c * spacing * sin(angle);      // Delay of the sensor, in samples;
+            for(int k=0; k<N; k++) {
+                int f = (k <= N/2) ? k : k - N;        // Signed frequency of the bin;
+                w[((long) k*B + b)*C + c] = cexpn(2*M_PI*f*tau/N) * (1.0 / C);
+            }
+        }
+    }
+    return w;
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: time_it
+ *   Measure execution time through repeated calls to the beamformer.
+ *
+ * Parameters:
+ *  simple
+ *    If true, uses the simple beamformer; if false, uses the Beamformer class;
+ *  channels
+ *    Number of channels;
+ *  repeat
+ *    Number of times the beamformer will be called.
+ *
+ * Returns:
+ *   The average execution time per frame.
+ **************************************************************************************************/
+float time_it(bool simple, int channels, int repeat)
+{
+    int threads = max(1, (int) thread::hardware_concurrency());
+    vector<Complex> w = steering_weights(channels, BEAMS, LENGTH, 0.5);
+    vector<Complex> x((long) channels*FRAMES*LENGTH), y((long) BEAMS*FRAMES*LENGTH);
+    for(long j=0; j<(long) x.size(); j++)      // Initialize the vector;
+        x[j] = Complex(sin(0.1*j), 0);
+    Beamformer bf(channels, BEAMS, LENGTH, FRAMES, w, threads);
+
+    auto t0 = chrono::steady_clock::now();     // Start counting time;
+    for(int j=0; j<repeat; j++)
+        if(simple)
+            simple_beamformer(channels, BEAMS, LENGTH, FRAMES, w, x.data(), y.data());
+        else
+            bf.process(x.data(), y.data());
+    auto t1 = chrono::steady_clock::now();     // End of time measuring;
+    return chrono::duration<float>(t1 - t0).count() / (repeat * FRAMES);
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: difference
+ *   Compares the beams computed by the Beamformer class with the beams computed by the simple
+ *   beamformer, for the same frames.
+ *
+ * Parameters:
+ *  channels
+ *    Number of channels.
+ *
+ * Returns:
+ *   The largest magnitude of the difference between the two results.
+ **************************************************************************************************/
+float difference(int channels)
+{
+    int threads = max(1, (int) thread::hardware_concurrency());
+    vector<Complex> w = steering_weights(channels, BEAMS, LENGTH, 0.5);
+    vector<Complex> x((long) channels*FRAMES*LENGTH);
+    vector<Complex> y((long) BEAMS*FRAMES*LENGTH), z((long) BEAMS*FRAMES*LENGTH);
+    for(long j=0; j<(long) x.size(); j++)      // Initialize the vector;
+        x[j] = Complex(sin(0.1*j), cos(0.37*j));
+    Beamformer bf(channels, BEAMS, LENGTH, FRAMES, w, threads);
+    bf.process(x.data(), y.data());
+    simple_beamformer(channels, BEAMS, LENGTH, FRAMES, w, x.data(), z.data());
+
+    float e = 0;
+    for(long j=0; j<(long) y.size(); j++) {
+        Complex d = y[j] - z[j];
+        e = max(e, (float) sqrt(d.r*d.r + d.i*d.i));
+    }
+    return e;
+}
+
+
+/**************************************************************************************************
+ Main Function:
+ **************************************************************************************************/
+int main(int argc, char *argv[]) {
+
+    // Start by printing the table with time comparisons:
+    cout << "+---------+---------+---------+---------+" << endl;
+    cout << "|    C    | Simple  | Beamf.  |  Diff.  |" << endl;
+    cout << "+---------+---------+---------+---------+" << endl;
+
+    // Try it with the number of channels ranging from 4 to 64:
+    for(int r=2; r<7; r++) {
+
+        // Compute the average execution time:
+        int c = (int) exp2(r);
+        float stime = time_it(true, c, REPEAT);
+        float btime = time_it(false, c, REPEAT);
+        float diff = difference(c);
+
+        // Print the results:
+        cout << "| " << setw(7) <<     c << " ";
+        cout << "| " << setw(7) << setprecision(7) << stime << " ";
+        cout << "| " << setw(7) << setprecision(7) << btime << " ";
+        cout << "| " << setw(7) << setprecision(2) << diff << " |" << endl;
+    }
+
+    cout << "+---------+---------+---------+---------+" << endl;
+    return 0;
+}
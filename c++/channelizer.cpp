@@ -0,0 +1,445 @@
+/**************************************************************************************************
+ * Fast Fourier Transform -- C++ Version
+ * This version implements a polyphase filter bank, that splits a signal in uniform channels.
+ *
+ * José Alexandre Nalon
+ **************************************************************************************************
+ * This program doesn't need much to be compiled and run. It can be done, as far as I know, with
+ * any C++ compiler, just remember to link the math and threads libraries. Optimizations should be
+ * turned on, so the compiler can vectorize the inner loops. In my box, I used the command:
+ *
+ * $ g++ -O3 -march=native -o channelizer channelizer.cpp -lm -lpthread
+ *
+ * It can be run with the command (remember to change permission to execute):
+ *
+ * $ ./channelizer
+ *
+ * Obs.: A channelizer splits a wideband complex signal in M channels of the same bandwidth, each
+ *   one shifted to the base band and decimated. Channel k is the signal multiplied by
+ *   exp(-2 pi k n/M), filtered by a prototype low-pass filter and decimated by D. The polyphase
+ *   implementation computes all of them at once: every frame of M*P samples is weighted by the
+ *   filter, folded in M samples (the commutator), rotated to keep the phase reference, and
+ *   transformed by a FFT. With D = M, the filter bank is critically sampled; with D = M/2, it is
+ *   oversampled by two, and the channels don't lose the transition bands of the filter to
+ *   aliasing. Frames are computed in batches, with the innermost loop running across frames, and
+ *   batches are split among threads.
+ **************************************************************************************************/
+
+/**************************************************************************************************
+ Include necessary libraries:
+ **************************************************************************************************/
+#include <iostream>                            // Input and Output;
+#include <iomanip>                             // I/O Manipulation;
+#include <cmath>                               // Math Functions;
+#include <chrono>                              // Time measurement;
+#include <vector>                              // Buffers;
+#include <thread>                              // Threads;
+
+using namespace std;
+
+
+/**************************************************************************************************
+ Definitions:
+ **************************************************************************************************/
+#define SAMPLES (1 << 20)                      // Number of samples to compute throughput;
+#define TAPS 8                                 // Taps of the filter in every branch;
+#define BATCH 8                                // Number of frames transformed together;
+#define BLOCK 64                               // Frames given to a thread at a time;
+
+
+/**************************************************************************************************
+ Small class to operate with complex numbers:
+ **************************************************************************************************/
+class Complex {
+    public:
+        float r;                               // Real part;
+        float i;                               // Imaginary part;
+        Complex();                             // Constructors;
+        Complex(float re, float im);
+        void set(float re, float im);
+        void set(Complex c);
+        Complex operator+(Complex c);          // Addition (overload + operator);
+        Complex operator-(Complex c);          // Subtraction (overload - operator);
+        Complex operator*(Complex c);          // Product (overload * operator);
+        Complex operator*(float a);            // Product with a scalar;
+        Complex cexp();                        // Complex exponential;
+};
+
+Complex::Complex() {                           // Constructor;
+    r = 0.0;                                   // Real part;
+    i = 0.0;                                   // Imaginary part;
+}
+
+Complex::Complex(float re, float im) {         // Constructor;
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(float re, float im) {
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(Complex c) {
+    r = c.r;                                   // Real part;
+    i = c.i;                                   // Imaginary part;
+}
+
+Complex Complex::operator+(Complex c) {
+    return Complex(r + c.r, i + c.i);
+}
+
+Complex Complex::operator-(Complex c) {
+    return Complex(r - c.r, i - c.i);
+}
+
+Complex Complex::operator*(Complex c) {
+    return Complex(r*c.r - i*c.i, r*c.i + i*c.r);
+}
+
+Complex Complex::operator*(float a) {
+    return Complex(a*r, a*i);
+}
+
+Complex Complex::cexp() {
+    return Complex(exp(r)*cos(i), exp(r)*sin(i));
+}
+
+Complex cexpn(float a) {                       // Convenience function to compute the exponential;
+    return Complex(cos(a), sin(a));
+}
+
+
+/**************************************************************************************************
+ * Function: bit_reverse
+ *   Bit-reversed version of an integer number.
+ *
+ * Parameters:
+ *   k
+ *     The number to be bit-reversed;
+ *   r
+ *     The number of bits to take into consideration when reversing.
+ *
+ * Returns:
+ *   The number k, bit-reversed according to integers with r bits.
+ **************************************************************************************************/
+int bit_reverse(int k, int r)
+{
+    int l = 0;                                 // Accumulate the results;
+    for(int i=0; i<r; i++) {                   // Loop on every bit;
+        l = (l << 1) + (k & 1);                // Test less signficant bit and add;
+        k >>= 1;                               // Test next bit;
+    }
+    return l;
+}
+
+
+/**************************************************************************************************
+ Class that implements the channelizer. It keeps the last samples of the signal between calls, so
+ a stream can be processed in blocks of any length:
+ **************************************************************************************************/
+class Channelizer {
+    public:
+        Channelizer(int M, int P, int D, int threads);
+        int process(Complex x[], int n, Complex y[]);
+    private:
+        int M;                                 // Number of channels;
+        int P;                                 // Taps of the filter in every branch;
+        int D;                                 // Decimation;
+        int L;                                 // Length of the filter;
+        int threads;                           // Number of threads;
+        long count;                            // Samples already processed;
+        vector<float> h;                       // Prototype filter, time reversed;
+        vector<int> rev;                       // Bit-reversed indices;
+        vector<Complex> W;                     // Twiddle factors;
+        vector<Complex> buffer;                // Last samples and the current block;
+        void frames(Complex x[], long first, int n, Complex y[]);
+};
+
+
+/**************************************************************************************************
+ * Method: Channelizer::Channelizer
+ *   Creates the channelizer, and designs the prototype filter: a windowed sinc with cutoff in
+ *   the border of the channels. The window is a Blackman window.
+ *
+ * Parameters:
+ *   M
+ *     The number of channels. It must be a power of two;
+ *   P
+ *     The number of taps of the filter in every branch, so the filter has M*P taps;
+ *   D
+ *     The decimation of the channels. It must be M (critically sampled) or M/2 (oversampled);
+ *   threads
+ *     The number of threads used to compute the frames.
+ **************************************************************************************************/
+Channelizer::Channelizer(int M, int P, int D, int threads)
+    : h(M*P), rev(M), W(M/2 + 1), buffer(M*P - 1) {
+    this->M = M;
+    this->P = P;
+    this->D = D;
+    this->L = M*P;
+    this->threads = threads;
+    count = 0;
+
+    float sum = 0;
+    for(int j=0; j<L; j++) {                   // Design the filter;
+        float t = (j - (L-1)/2.0) / M;
+        float s = (t == 0) ? 1 : sin(M_PI*t) / (M_PI*t);
+        float w = 0.42 - 0.5*cos(2*M_PI*j/(L-1)) + 0.08*cos(4*M_PI*j/(L-1));
+        h[L-1-j] = s * w;                      // Filter is stored time reversed;
+        sum = sum + s*w;
+    }
+    for(int j=0; j<L; j++)                     // Unitary gain in the pass band;
+        h[j] = h[j] / sum;
+
+    int r = (int) floor(log2(M));
+    for(int k=0; k<M; k++)                     // Bit-reversed order;
+        rev[k] = bit_reverse(k, r);
+    for(int n=0; n<=M/2; n++)                  // Twiddle factors;
+        W[n] = cexpn(-2*M_PI*n/M);
+}
+
+
+/**************************************************************************************************
+ * Method: Channelizer::frames
+ *   Computes a number of consecutive frames. Every frame is weighted and folded directly in the
+ *   bit-reversed order of the FFT, so the commutator and the reordering are done in the same
+ *   pass; then the frames are transformed in batches.
+ *
+ * Parameters:
+ *   x
+ *     Pointer to the first sample of the first frame;
+ *   first
+ *     Index, in the whole signal, of the first sample of the first frame;
+ *   n
+ *     Number of frames to be computed;
+ *   y
+ *     Pointer to the output of the first frame. Every frame has M channels.
+ **************************************************************************************************/
+void Channelizer::frames(Complex x[], long first, int n, Complex y[])
+{
+    vector<float> re(M*BATCH), im(M*BATCH);    // Frames transposed, index of the frame faster;
+    vector<float> ur(M), ui(M);                // Folded frame;
+
+    for(int f0=0; f0<n; f0+=BATCH) {
+        int B = min(BATCH, n - f0);
+        for(int b=0; b<B; b++) {
+            Complex *s = x + (long) (f0+b)*D;  // First sample of the frame;
+            for(int m=0; m<M; m++) {           // Weight and fold the frame;
+                ur[m] = 0;
+                ui[m] = 0;
+            }
+            for(int p=0; p<P; p++) {
+                float *hp = &h[p*M];
+                Complex *sp = s + p*M;
+                for(int m=0; m<M; m++) {       // This loop is vectorized;
+                    ur[m] += hp[m] * sp[m].r;
+                    ui[m] += hp[m] * sp[m].i;
+                }
+            }
+            int c = (int) ((first + (long) (f0+b)*D) % M);
+            for(int m=0; m<M; m++) {           // Rotate to keep the phase reference;
+                int l = rev[(m + c) & (M-1)] * BATCH + b;
+                re[l] = ur[m];
+                im[l] = ui[m];
+            }
+        }
+
+        for(int step=1; step<M; step<<=1) {   // Transform the batch;
+            int stride = M / (2*step);
+            for(int l=0; l<M; l+=2*step)
+                for(int k=0; k<step; k++) {
+                    float wr = W[k*stride].r, wi = W[k*stride].i;
+                    float *pr = &re[(l+k)*BATCH], *pi = &im[(l+k)*BATCH];
+                    float *qr = &re[(l+k+step)*BATCH], *qi = &im[(l+k+step)*BATCH];
+                    for(int b=0; b<BATCH; b++) {   // This loop is vectorized;
+                        float tr = wr*qr[b] - wi*qi[b];
+                        float ti = wr*qi[b] + wi*qr[b];
+                        qr[b] = pr[b] - tr;
+                        qi[b] = pi[b] - ti;
+                        pr[b] = pr[b] + tr;
+                        pi[b] = pi[b] + ti;
+                    }
+                }
+        }
+
+        for(int b=0; b<B; b++) {               // Write the channels;
+            Complex *yb = y + (long) (f0+b)*M;
+            for(int k=0; k<M; k++)
+                yb[k] = Complex(re[k*BATCH + b], im[k*BATCH + b]);
+        }
+    }
+}
+
+
+/**************************************************************************************************
+ * Method: Channelizer::process
+ *   Processes a block of samples of the stream. A frame is computed every D samples; the first
+ *   frames use the samples of the previous blocks (or zeros, in the beginning of the stream).
+ *
+ * Parameters:
+ *   x
+ *     The block of samples;
+ *   n
+ *     The number of samples in the block;
+ *   y
+ *     Receives the frames computed, M channels each. It must have room for at least n/D + 1
+ *     frames.
+ *
+ * Returns:
+ *   The number of frames computed.
+ **************************************************************************************************/
+int Channelizer::process(Complex x[], int n, Complex y[])
+{
+    int keep = L - 1;                          // Samples kept from previous blocks;
+    buffer.resize(keep + n);
+    for(int j=0; j<n; j++)
+        buffer[keep + j] = x[j];
+
+    long first = count - keep;                 // Index of the first sample in the buffer;
+    long start = (count + D - 1) / D * D;      // First frame ending in this block;
+    int F = 0;
+    if(start < count + n)
+        F = (int) ((count + n - 1 - start) / D) + 1;
+    int skip = (int) (start - count);          // Offset of the first frame in the buffer;
+
+    vector<thread> workers;
+    int per = (F + threads - 1) / threads;     // Frames computed by every thread;
+    per = (per + BLOCK - 1) / BLOCK * BLOCK;
+    for(int f=0; f<F; f+=per) {
+        int nf = min(per, F - f);
+        Complex *s = buffer.data() + skip + (long) f*D;
+        long sfirst = first + skip + (long) f*D;
+        Complex *yf = y + (long) f*M;
+        if(f + per >= F)                       // Last part is computed by this thread;
+            frames(s, sfirst, nf, yf);
+        else
+            workers.push_back(thread(&Channelizer::frames, this, s, sfirst, nf, yf));
+    }
+    for(auto &w : workers)
+        w.join();
+
+    for(int j=0; j<keep; j++)                  // Keep the last samples for the next block;
+        buffer[j] = buffer[n + j];
+    buffer.resize(keep);
+    count = count + n;
+    return F;
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: throughput
+ *   Measure the rate in which a channelizer processes samples.
+ *
+ * Parameters:
+ *  M
+ *    Number of channels;
+ *  D
+ *    Decimation;
+ *  samples
+ *    Number of samples processed.
+ *
+ * Returns:
+ *   The number of samples processed per second, in millions.
+ **************************************************************************************************/
+float throughput(int M, int D, int samples)
+{
+    int threads = max(1, (int) thread::hardware_concurrency());
+    Channelizer ch(M, TAPS, D, threads);
+    int block = 1 << 16;                       // Samples in every call;
+    vector<Complex> x(block), y((block/D + 1) * (long) M);
+    for(int j=0; j<block; j++)
+        x[j] = cexpn(0.3*j);
+
+    auto t0 = chrono::steady_clock::now();     // Start counting time;
+    for(int j=0; j<samples; j+=block)
+        ch.process(x.data(), block, y.data());
+    auto t1 = chrono::steady_clock::now();     // End of time measuring;
+    return samples / chrono::duration<float>(t1 - t0).count() / 1e6;
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: error
+ *   Largest difference between one channel computed by a channelizer and the same channel
+ *   computed directly: the signal is multiplied by exp(-2 pi k n/M), filtered by the prototype
+ *   filter (designed again in double precision) and decimated by D. The signal is given to the
+ *   channelizer in blocks of different lengths, so the samples kept between calls are checked too.
+ *
+ * Parameters:
+ *  M
+ *    Number of channels;
+ *  D
+ *    Decimation;
+ *  samples
+ *    Number of samples processed.
+ *
+ * Returns:
+ *   The largest magnitude of the difference, over every frame of the channel.
+ **************************************************************************************************/
+float error(int M, int D, int samples)
+{
+    int L = M * TAPS, k = M/4 + 1;             // Length of the filter, and channel checked;
+    vector<double> h(L);
+    double sum = 0;
+    for(int j=0; j<L; j++) {                   // Same filter of the channelizer;
+        double t = (j - (L-1)/2.0) / M;
+        double s = (t == 0) ? 1 : sin(M_PI*t) / (M_PI*t);
+        h[j] = s * (0.42 - 0.5*cos(2*M_PI*j/(L-1)) + 0.08*cos(4*M_PI*j/(L-1)));
+        sum = sum + h[j];
+    }
+
+    vector<Complex> x(samples), y((samples/D + 2) * (long) M);
+    for(int n=0; n<samples; n++)               // Tones inside and outside the channel;
+        x[n] = cexpn(2*M_PI*(k + 0.3)*n/M) + cexpn(-1.7*n) * 0.5;
+    Channelizer ch(M, TAPS, D, 2);
+    int F = 0, block = samples/3 + 7;
+    for(int j=0; j<samples; j+=block)
+        F += ch.process(&x[j], min(block, samples - j), &y[(long) F*M]);
+
+    float e = 0;
+    for(int f=0; f<F; f++) {
+        long n0 = (long) f * D;                // Last sample of the frame;
+        double zr = 0, zi = 0;
+        for(int j=0; j<L && j<=n0; j++) {      // Downconvert and filter;
+            double a = -2*M_PI*((k * (n0-j)) % M)/M;
+            double xr = x[n0-j].r, xi = x[n0-j].i;
+            zr += h[j] * (xr*cos(a) - xi*sin(a));
+            zi += h[j] * (xr*sin(a) + xi*cos(a));
+        }
+        Complex d = y[(long) f*M + k] - Complex(zr/sum, zi/sum);
+        e = max(e, (float) sqrt(d.r*d.r + d.i*d.i));
+    }
+    return e;
+}
+
+
+/**************************************************************************************************
+ Main Function:
+ **************************************************************************************************/
+int main(int argc, char *argv[]) {
+
+    // Start by printing the table with throughput comparisons, in millions of samples per second:
+    cout << "+---------+---------+---------+---------+" << endl;
+    cout << "|    M    | Critic. | Oversa. |  Error  |" << endl;
+    cout << "+---------+---------+---------+---------+" << endl;
+
+    // Try it with the number of channels ranging from 32 to 1024:
+    for(int r=5; r<11; r++) {
+
+        // Compute the throughput:
+        int m = (int) exp2(r);
+        float ctime = throughput(m, m, SAMPLES);
+        float otime = throughput(m, m/2, SAMPLES);
+        float e = max(error(m, m, 4096), error(m, m/2, 4096));
+
+        // Print the results:
+        cout << "| " << setw(7) <<     m << " ";
+        cout << "| " << setw(7) << setprecision(7) << ctime << " ";
+        cout << "| " << setw(7) << setprecision(7) << otime << " ";
+        cout << "| " << setw(7) << setprecision(2) << e << " |" << endl;
+    }
+
+    cout << "+---------+---------+---------+---------+" << endl;
+    return 0;
+}
@@ -0,0 +1,774 @@
+/**************************************************************************************************
+ * Fast Fourier Transform -- C++ Version
+ * This version implements two-dimensional convolution and correlation of images.
+ *
+ * José Alexandre Nalon
+ **************************************************************************************************
+ * This program doesn't need much to be compiled and run. It can be done, as far as I know, with
+ * any C++ compiler, just remember to link the math library. Optimizations should be turned on, so
+ * the compiler can vectorize the inner loops. In my box, I used the command:
+ *
+ * $ g++ -O3 -march=native -o conv2d conv2d.cpp -lm
+ *
+ * It can be run with the command (remember to change permission to execute):
+ *
+ * $ ./conv2d
+ *
+ * Obs.: The two-dimensional transform is computed by rows and then by columns. Images are real,
+ *   so every row is transformed by a complex FFT of half the length, and only half of the
+ *   columns (plus one) are kept. The columns are all transformed at the same time, with the
+ *   butterflies applied to whole rows, so the innermost loop runs over contiguous memory and can
+ *   be vectorized. The correlation of an image with a kernel is the inverse transform of the
+ *   product of the spectrum of the image by the conjugated spectrum of the kernel; the
+ *   convolution is the correlation with the kernel flipped. Only the valid part of the results
+ *   is computed (where the kernel is entirely inside the image), so the image needs to be padded
+ *   only to the next power of two. Very large images are split in tiles that overlap by the size
+ *   of the kernel, and the valid part of every tile is kept (overlap-save). The spectra of the
+ *   kernels are kept in a cache, for every size of transform. The normalized cross-correlation
+ *   uses the correlation with the template for the numerator, and the sums of the image and of
+ *   its square in every window, computed from integral images, for the denominator. The rows of
+ *   the spectra are never reordered: the forward transform of the columns decimates in frequency
+ *   and leaves them in bit-reversed order, and the inverse decimates in time and takes them from
+ *   that order.
+ **************************************************************************************************/
+
+/**************************************************************************************************
+ Include necessary libraries:
+ **************************************************************************************************/
+#include <iostream>                            // Input and Output;
+#include <iomanip>                             // I/O Manipulation;
+#include <cmath>                               // Math Functions;
+#include <chrono>                              // Time measurement;
+#include <map>                                 // Caches;
+#include <vector>                              // Buffers;
+
+using namespace std;
+
+
+/**************************************************************************************************
+ Definitions:
+ **************************************************************************************************/
+#define TEMPLATE 128                           // Size of the template;
+#define TILE 512                               // Size of the tiles;
+#define ROWS 4                                 // Rows computed by the direct method, to estimate;
+
+
+/**************************************************************************************************
+ Small class to operate with complex numbers:
+ **************************************************************************************************/
+class Complex {
+    public:
+        float r;                               // Real part;
+        float i;                               // Imaginary part;
+        Complex();                             // Constructors;
+        Complex(float re, float im);
+        void set(float re, float im);
+        void set(Complex c);
+        Complex operator+(Complex c);          // Addition (overload + operator);
+        Complex operator-(Complex c);          // Subtraction (overload - operator);
+        Complex operator*(Complex c);          // Product (overload * operator);
+        Complex operator*(float a);            // Product with a scalar;
+        Complex cexp();                        // Complex exponential;
+};
+
+Complex::Complex() {                           // Constructor;
+    r = 0.0;                                   // Real part;
+    i = 0.0;                                   // Imaginary part;
+}
+
+Complex::Complex(float re, float im) {         // Constructor;
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(float re, float im) {
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(Complex c) {
+    r = c.r;                                   // Real part;
+    i = c.i;                                   // Imaginary part;
+}
+
+Complex Complex::operator+(Complex c) {
+    return Complex(r + c.r, i + c.i);
+}
+
+Complex Complex::operator-(Complex c) {
+    return Complex(r - c.r, i - c.i);
+}
+
+Complex Complex::operator*(Complex c) {
+    return Complex(r*c.r - i*c.i, r*c.i + i*c.r);
+}
+
+Complex Complex::operator*(float a) {
+    return Complex(a*r, a*i);
+}
+
+Complex Complex::cexp() {
+    return Complex(exp(r)*cos(i), exp(r)*sin(i));
+}
+
+Complex cexpn(float a) {                       // Convenience function to compute the exponential;
+    return Complex(cos(a), sin(a));
+}
+
+
+/**************************************************************************************************
+ * Function: bit_reverse
+ *   Bit-reversed version of an integer number.
+ *
+ * Parameters:
+ *   k
+ *     The number to be bit-reversed;
+ *   r
+ *     The number of bits to take into consideration when reversing.
+ *
+ * Returns:
+ *   The number k, bit-reversed according to integers with r bits.
+ **************************************************************************************************/
+int bit_reverse(int k, int r)
+{
+    int l = 0;                                 // Accumulate the results;
+    for(int i=0; i<r; i++) {                   // Loop on every bit;
+        l = (l << 1) + (k & 1);                // Test less signficant bit and add;
+        k >>= 1;                               // Test next bit;
+    }
+    return l;
+}
+
+
+/**************************************************************************************************
+ Plans hold everything that depends only on the length of the transform, and are kept in a cache:
+ **************************************************************************************************/
+struct Plan {
+    int N;                                     // Length of the transform;
+    vector<int> rev;                           // Bit-reversed indices;
+    vector<Complex> W;                         // Twiddle factors, W[n] = exp(-2 pi n/N);
+};
+
+map<int, Plan *> plans;                        // Cache of plans, indexed by the length;
+
+
+/**************************************************************************************************
+ * Function: get_plan
+ *   Looks for a plan in the cache, creating it if it doesn't exist.
+ *
+ * Parameters:
+ *   N
+ *     The length of the transform. It must be a power of two.
+ *
+ * Returns:
+ *   A pointer to the plan. It is owned by the cache and must not be released.
+ **************************************************************************************************/
+Plan *get_plan(int N)
+{
+    auto p = plans.find(N);
+    if(p != plans.end())                       // Plan was already computed;
+        return p->second;
+
+    Plan *plan = new Plan;
+    plan->N = N;
+    int r = (int) floor(log2(N));              // Number of bits;
+    plan->rev.resize(N);
+    for(int k=0; k<N; k++)                     // Bit-reversed order;
+        plan->rev[k] = bit_reverse(k, r);
+    plan->W.resize(N/2 + 1);
+    for(int n=0; n<=N/2; n++)                  // Twiddle factors computed directly;
+        plan->W[n] = cexpn(-2*M_PI*n/N);
+    plans[N] = plan;
+    return plan;
+}
+
+
+/**************************************************************************************************
+ * Function: fft
+ *   Fast Fourier Transform using an iterative in-place decimation in time algorithm, with the
+ *   twiddle factors taken from the plan.
+ *
+ * Parameters:
+ *   plan
+ *     Plan for the length of the transform;
+ *   x
+ *     The vector of which the FFT will be computed;
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call, and it can't be the same as the input.
+ **************************************************************************************************/
+void fft(Plan *plan, Complex x[], Complex X[])
+{
+    int N = plan->N;
+    for(int k=0; k<N; k++)                     // Reorder the vector according to the
+        X[plan->rev[k]] = x[k];                //   bit-reversed order;
+
+    for(int step=1; step<N; step<<=1) {
+        int stride = N / (2*step);             // Distance between twiddle factors in the table;
+        for(int l=0; l<N; l+=2*step)
+            for(int n=0; n<step; n++) {
+                int p = l + n;
+                int q = p + step;
+                Complex w = plan->W[n*stride] * X[q];
+                X[q] = X[p] - w;               // Recombine results;
+                X[p] = X[p] + w;
+            }
+    }
+}
+
+
+/**************************************************************************************************
+ Spectrum of a real image. Only the columns from 0 to Q/2 are kept, and real and imaginary parts
+ are kept in separate buffers, with the element (r, c) in the position r*(Q/2 + 1) + c. The rows
+ are kept in bit-reversed order, which doesn't matter for products element by element:
+ **************************************************************************************************/
+struct Spectrum {
+    int P;                                     // Number of rows of the transform;
+    int Q;                                     // Number of columns of the transform;
+    vector<float> re, im;                      // Real and imaginary parts;
+};
+
+
+/**************************************************************************************************
+ * Function: columns
+ *   Transforms every column of a spectrum, in place. The forward transform decimates in frequency,
+ *   so it takes the rows in natural order and leaves them in bit-reversed order; the inverse
+ *   transform decimates in time, and takes them back to natural order. No rows are ever swapped.
+ *   The butterflies combine whole rows, so the innermost loop can be vectorized.
+ *
+ * Parameters:
+ *   S
+ *     The spectrum;
+ *   inverse
+ *     If true, computes the inverse transform (not divided by the number of rows).
+ **************************************************************************************************/
+void columns(Spectrum &S, bool inverse)
+{
+    int P = S.P, C = S.Q/2 + 1;
+    Plan *plan = get_plan(P);
+    for(int s=1; s<P; s<<=1) {
+        int step = inverse ? s : P / (2*s);    // Decimation in time goes from the small to the
+        int stride = P / (2*step);             //   large butterflies, in frequency the opposite;
+        for(int l=0; l<P; l+=2*step)
+            for(int n=0; n<step; n++) {
+                Complex W = plan->W[n*stride];
+                float *pr = &S.re[(long) (l+n)*C], *pi = &S.im[(long) (l+n)*C];
+                float *qr = &S.re[(long) (l+n+step)*C], *qi = &S.im[(long) (l+n+step)*C];
+                if(inverse)
+                    for(int c=0; c<C; c++) {   // This loop is vectorized;
+                        float tr = W.r*qr[c] + W.i*qi[c];
+                        float ti = W.r*qi[c] - W.i*qr[c];
+                        qr[c] = pr[c] - tr;    // Recombine results;
+                        qi[c] = pi[c] - ti;
+                        pr[c] = pr[c] + tr;
+                        pi[c] = pi[c] + ti;
+                    }
+                else
+                    for(int c=0; c<C; c++) {   // This loop is vectorized;
+                        float dr = pr[c] - qr[c];
+                        float di = pi[c] - qi[c];
+                        pr[c] = pr[c] + qr[c]; // Recombine results;
+                        pi[c] = pi[c] + qi[c];
+                        qr[c] = W.r*dr - W.i*di;
+                        qi[c] = W.r*di + W.i*dr;
+                    }
+            }
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: forward
+ *   Two-dimensional transform of a real image, padded with zeros. Every row is transformed by a
+ *   complex FFT of half the length, and then every column.
+ *
+ * Parameters:
+ *   x
+ *     The image;
+ *   h, w
+ *     The number of rows and columns of the image that are used;
+ *   stride
+ *     Distance between rows of the image;
+ *   S
+ *     The spectrum, with P and Q already set.
+ **************************************************************************************************/
+void forward(float x[], int h, int w, long stride, Spectrum &S)
+{
+    int P = S.P, Q = S.Q, H = Q/2, C = H + 1;
+    Plan *half = get_plan(H), *full = get_plan(Q);
+    S.re.assign((long) P*C, 0);
+    S.im.assign((long) P*C, 0);
+    vector<Complex> z(H), Z(H + 1);
+    for(int r=0; r<min(h, P); r++) {
+        float *row = x + r*stride;
+        for(int n=0; n<H; n++)                 // Pack the real row;
+            z[n] = Complex((2*n < w) ? row[2*n] : 0, (2*n+1 < w) ? row[2*n+1] : 0);
+        fft(half, z.data(), Z.data());
+        Z[H] = Z[0];
+        for(int k=0; k<=H; k++) {              // Split the spectrum;
+            Complex a = Z[k];
+            Complex b = Complex(Z[H-k].r, -Z[H-k].i);
+            Complex O = a - b;
+            Complex X = (a + b) * 0.5 + full->W[k] * Complex(O.i * 0.5, -O.r * 0.5);
+            S.re[(long) r*C + k] = X.r;
+            S.im[(long) r*C + k] = X.i;
+        }
+    }
+    columns(S, false);
+}
+
+
+/**************************************************************************************************
+ * Function: inverse
+ *   Inverse of the two-dimensional transform, divided by the number of elements. Only the first
+ *   rows and columns of the result are computed. The spectrum is changed.
+ *
+ * Parameters:
+ *   S
+ *     The spectrum;
+ *   y
+ *     Receives the image;
+ *   h, w
+ *     Number of rows and columns of the image that are needed;
+ *   stride
+ *     Distance between rows of the image.
+ **************************************************************************************************/
+void inverse(Spectrum &S, float y[], int h, int w, long stride)
+{
+    int P = S.P, Q = S.Q, H = Q/2, C = H + 1;
+    Plan *half = get_plan(H), *full = get_plan(Q);
+    columns(S, true);
+    vector<Complex> Z(H), z(H);
+    float scale = 1.0 / ((float) P * Q);
+    for(int r=0; r<h; r++) {
+        float *re = &S.re[(long) r*C], *im = &S.im[(long) r*C];
+        for(int k=0; k<H; k++) {               // Join the transforms of even and odd samples,
+            Complex a = Complex(re[k], im[k]); //   conjugated to compute the inverse;
+            Complex b = Complex(re[H-k], -im[H-k]);
+            Complex E = a + b;
+            Complex O = (a - b) * Complex(full->W[k].r, -full->W[k].i);
+            Z[k] = Complex(E.r - O.i, -(E.i + O.r));
+        }
+        fft(half, Z.data(), z.data());
+        float *row = y + r*stride;
+        for(int n=0; n<H; n++) {               // Unpack the real row;
+            if(2*n < w)
+                row[2*n] = z[n].r * scale;
+            if(2*n+1 < w)
+                row[2*n+1] = -z[n].i * scale;
+        }
+    }
+}
+
+
+/**************************************************************************************************
+ Class that holds a kernel and a cache of its spectra, one for every size of transform:
+ **************************************************************************************************/
+class Kernel {
+    public:
+        Kernel(float k[], int h, int w, bool flip);
+        int h, w;                              // Number of rows and columns;
+        Spectrum &spectrum(int P, int Q);
+        float at(int r, int c);
+    private:
+        vector<float> data;                    // The kernel, flipped if needed;
+        map<pair<int, int>, Spectrum> cache;   // Conjugated spectra, indexed by size;
+};
+
+
+/**************************************************************************************************
+ * Method: Kernel::Kernel
+ *   Keeps a copy of the kernel.
+ *
+ * Parameters:
+ *   k
+ *     The kernel, row by row;
+ *   h, w
+ *     Number of rows and columns;
+ *   flip
+ *     If true, the kernel is flipped in both directions. Correlation with a flipped kernel is a
+ *     convolution.
+ **************************************************************************************************/
+Kernel::Kernel(float k[], int h, int w, bool flip)
+{
+    this->h = h;
+    this->w = w;
+    data.resize(h*w);
+    for(int r=0; r<h; r++)
+        for(int c=0; c<w; c++)
+            data[r*w + c] = flip ? k[(h-1-r)*w + (w-1-c)] : k[r*w + c];
+}
+
+
+/**************************************************************************************************
+ * Method: Kernel::at
+ *   Element of the kernel, as used in the correlation.
+ **************************************************************************************************/
+float Kernel::at(int r, int c)
+{
+    return data[r*w + c];
+}
+
+
+/**************************************************************************************************
+ * Method: Kernel::spectrum
+ *   Looks for the conjugated spectrum of the kernel in the cache, computing it if it doesn't
+ *   exist.
+ *
+ * Parameters:
+ *   P, Q
+ *     Size of the transform.
+ *
+ * Returns:
+ *   The conjugated spectrum.
+ **************************************************************************************************/
+Spectrum &Kernel::spectrum(int P, int Q)
+{
+    auto p = cache.find(make_pair(P, Q));
+    if(p != cache.end())                       // Spectrum was already computed;
+        return p->second;
+
+    Spectrum &S = cache[make_pair(P, Q)];
+    S.P = P;
+    S.Q = Q;
+    forward(data.data(), h, w, w, S);
+    for(long j=0; j<(long) S.im.size(); j++)
+        S.im[j] = -S.im[j];
+    return S;
+}
+
+
+/**************************************************************************************************
+ * Function: correlate_block
+ *   Correlates a block of the image with the kernel, with transforms of a given size, and keeps
+ *   the valid part.
+ *
+ * Parameters:
+ *   x
+ *     First element of the block of the image;
+ *   h, w
+ *     Number of rows and columns of the block;
+ *   stride
+ *     Distance between rows of the image;
+ *   k
+ *     The kernel;
+ *   P, Q
+ *     Size of the transforms. They must be powers of two, not smaller than h and w;
+ *   y
+ *     First element of the results;
+ *   oh, ow
+ *     Number of rows and columns of the results that are kept;
+ *   ostride
+ *     Distance between rows of the results.
+ **************************************************************************************************/
+void correlate_block(float x[], int h, int w, long stride, Kernel &k, int P, int Q, float y[],
+                     int oh, int ow, long ostride)
+{
+    Spectrum &K = k.spectrum(P, Q);
+    Spectrum S;
+    S.P = P;
+    S.Q = Q;
+    forward(x, h, w, stride, S);
+    for(long j=0; j<(long) S.re.size(); j++) { // Multiply by the conjugated spectrum (vectorized);
+        float r = S.re[j]*K.re[j] - S.im[j]*K.im[j];
+        float i = S.re[j]*K.im[j] + S.im[j]*K.re[j];
+        S.re[j] = r;
+        S.im[j] = i;
+    }
+    inverse(S, y, oh, ow, ostride);
+}
+
+
+/**************************************************************************************************
+ * Function: correlate
+ *   Correlates an image with a kernel, with transforms of the whole image. Only the valid part is
+ *   computed; it has (H - h + 1) rows and (W - w + 1) columns, where h and w are the size of the
+ *   kernel.
+ *
+ * Parameters:
+ *   x
+ *     The image;
+ *   H, W
+ *     Number of rows and columns of the image;
+ *   k
+ *     The kernel;
+ *   y
+ *     Receives the results.
+ **************************************************************************************************/
+void correlate(float x[], int H, int W, Kernel &k, float y[])
+{
+    int P = 1, Q = 1;
+    while(P < H)                               // Circular correlation doesn't touch the valid
+        P <<= 1;                               //   part, if the image fits;
+    while(Q < W)
+        Q <<= 1;
+    correlate_block(x, H, W, W, k, P, Q, y, H - k.h + 1, W - k.w + 1, W - k.w + 1);
+}
+
+
+/**************************************************************************************************
+ * Function: correlate_tiled
+ *   Correlates an image with a kernel, by tiles (overlap-save). Every tile is T by T, and gives
+ *   T - h + 1 by T - w + 1 results; tiles overlap by the size of the kernel.
+ *
+ * Parameters:
+ *   x
+ *     The image;
+ *   H, W
+ *     Number of rows and columns of the image;
+ *   k
+ *     The kernel;
+ *   y
+ *     Receives the results;
+ *   T
+ *     Size of the tiles. It must be a power of two greater than the kernel.
+ **************************************************************************************************/
+void correlate_tiled(float x[], int H, int W, Kernel &k, float y[], int T)
+{
+    int OH = H - k.h + 1, OW = W - k.w + 1;    // Size of the results;
+    int sh = T - k.h + 1, sw = T - k.w + 1;    // Valid part of every tile;
+    for(int r=0; r<OH; r+=sh)
+        for(int c=0; c<OW; c+=sw)
+            correlate_block(x + (long) r*W + c, min(T, H - r), min(T, W - c), W, k, T, T,
+                            y + (long) r*OW + c, min(sh, OH - r), min(sw, OW - c), OW);
+}
+
+
+/**************************************************************************************************
+ * Function: correlate_direct
+ *   Correlates an image with a kernel directly from the definition. Only the first rows of the
+ *   results are computed (no more than the rows in the valid part).
+ *
+ * Parameters:
+ *   x
+ *     The image;
+ *   H, W
+ *     Number of rows and columns of the image;
+ *   k
+ *     The kernel;
+ *   y
+ *     Receives the results;
+ *   rows
+ *     Number of rows of the results to compute.
+ **************************************************************************************************/
+void correlate_direct(float x[], int H, int W, Kernel &k, float y[], int rows)
+{
+    int OW = W - k.w + 1;
+    rows = min(rows, H - k.h + 1);
+    for(int r=0; r<rows; r++)
+        for(int c=0; c<OW; c++) {
+            float acc = 0;
+            for(int i=0; i<k.h; i++)
+                for(int j=0; j<k.w; j++)
+                    acc += x[(long) (r+i)*W + c + j] * k.at(i, j);
+            y[(long) r*OW + c] = acc;
+        }
+}
+
+
+/**************************************************************************************************
+ * Function: convolve_direct
+ *   Convolves an image with a kernel directly from the definition, without flipping the kernel
+ *   first. It is used to check the convolution made by correlation with a flipped kernel. Only
+ *   the first rows of the results are computed.
+ *
+ * Parameters:
+ *   x
+ *     The image;
+ *   H, W
+ *     Number of rows and columns of the image;
+ *   t
+ *     The kernel, row by row;
+ *   h, w
+ *     Number of rows and columns of the kernel;
+ *   y
+ *     Receives the results;
+ *   rows
+ *     Number of rows of the results to compute.
+ **************************************************************************************************/
+void convolve_direct(float x[], int H, int W, float t[], int h, int w, float y[], int rows)
+{
+    int OW = W - w + 1;
+    rows = min(rows, H - h + 1);
+    for(int r=0; r<rows; r++)
+        for(int c=0; c<OW; c++) {
+            float acc = 0;                     // Output (r, c) is at (r+h-1, c+w-1) in the
+            for(int i=0; i<h; i++)             //   full convolution;
+                for(int j=0; j<w; j++)
+                    acc += x[(long) (r+h-1-i)*W + c+w-1-j] * t[i*w + j];
+            y[(long) r*OW + c] = acc;
+        }
+}
+
+
+/**************************************************************************************************
+ * Function: ncc
+ *   Normalized cross-correlation of an image with a template, in the valid part. Every result is
+ *   the correlation coefficient between the template and the window of the image under it, from
+ *   -1 to 1. The numerator is the correlation of the image with the template minus its mean; the
+ *   sums of the image and of its square in every window are computed from integral images.
+ *
+ * Parameters:
+ *   x
+ *     The image;
+ *   H, W
+ *     Number of rows and columns of the image;
+ *   t
+ *     The template;
+ *   h, w
+ *     Number of rows and columns of the template;
+ *   y
+ *     Receives the results.
+ **************************************************************************************************/
+void ncc(float x[], int H, int W, float t[], int h, int w, float y[])
+{
+    int n = h * w, OH = H - h + 1, OW = W - w + 1;
+    double mean = 0, var = 0;
+    for(int j=0; j<n; j++)
+        mean += t[j];
+    mean /= n;
+    vector<float> t0(n);                       // Template with zero mean;
+    for(int j=0; j<n; j++) {
+        t0[j] = t[j] - mean;
+        var += t0[j] * t0[j];
+    }
+    Kernel k(t0.data(), h, w, false);
+    if(H > 2*TILE || W > 2*TILE)
+        correlate_tiled(x, H, W, k, y, TILE);
+    else
+        correlate(x, H, W, k, y);
+
+    vector<double> s1((long) (H+1)*(W+1)), s2((long) (H+1)*(W+1));
+    for(int r=0; r<H; r++)                     // Integral images, with a row and a column of
+        for(int c=0; c<W; c++) {               //   zeros before;
+            double v = x[(long) r*W + c];
+            long j = (long) (r+1)*(W+1) + c + 1;
+            s1[j] = v + s1[j-1] + s1[j-W-1] - s1[j-W-2];
+            s2[j] = v*v + s2[j-1] + s2[j-W-1] - s2[j-W-2];
+        }
+    for(int r=0; r<OH; r++)
+        for(int c=0; c<OW; c++) {
+            long a = (long) r*(W+1) + c, b = a + w, d = a + (long) h*(W+1), e = d + w;
+            double sum = s1[e] - s1[b] - s1[d] + s1[a];
+            double sq = s2[e] - s2[b] - s2[d] + s2[a];
+            double den = sqrt(fmax(sq - sum*sum/n, 0) * var);
+            float &v = y[(long) r*OW + c];
+            v = (den > 1e-9) ? v / den : 0;
+        }
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: measure
+ *   Correlates an image with a template with every method, and measures the time. The direct
+ *   method computes only ROWS rows, and its time is estimated for the whole image.
+ *
+ * Parameters:
+ *  N
+ *    Size of the image;
+ *  times
+ *    Receives the times of the direct, whole image and tiled methods, and of the normalized
+ *    cross-correlation;
+ *  errors
+ *    Receive the largest difference between the methods, and between the convolution with a
+ *    flipped kernel and the convolution computed directly;
+ *
+ * Returns:
+ *   The position (row times the width plus column) of the best match of the normalized
+ *   cross-correlation.
+ **************************************************************************************************/
+long measure(int N, float times[], float errors[])
+{
+    vector<float> x((long) N*N), t(TEMPLATE*TEMPLATE);
+    for(long j=0; j<(long) x.size(); j++)      // Some texture;
+        x[j] = sin(0.05 * (j % N)) * cos(0.03 * (j / N)) + ((j * 7919) % 101) / 101.0;
+    int r0 = N/3, c0 = N/5;                    // The template is a piece of the image;
+    for(int r=0; r<TEMPLATE; r++)
+        for(int c=0; c<TEMPLATE; c++)
+            t[r*TEMPLATE + c] = 2 * x[(long) (r0+r)*N + c0 + c] + 1;
+    Kernel k(t.data(), TEMPLATE, TEMPLATE, false);
+    int O = N - TEMPLATE + 1;
+    vector<float> y1((long) O*O), y2((long) O*O), y3((long) O*O);
+
+    auto t0 = chrono::steady_clock::now();
+    correlate_direct(x.data(), N, N, k, y1.data(), ROWS);
+    auto t1 = chrono::steady_clock::now();
+    times[0] = chrono::duration<float>(t1 - t0).count() * O / ROWS;
+
+    k.spectrum(N, N);                          // Kernel spectrum in the cache;
+    t0 = chrono::steady_clock::now();
+    correlate(x.data(), N, N, k, y2.data());
+    t1 = chrono::steady_clock::now();
+    times[1] = chrono::duration<float>(t1 - t0).count();
+
+    k.spectrum(TILE, TILE);                    // Kernel spectrum in the cache;
+    t0 = chrono::steady_clock::now();
+    correlate_tiled(x.data(), N, N, k, y3.data(), TILE);
+    t1 = chrono::steady_clock::now();
+    times[2] = chrono::duration<float>(t1 - t0).count();
+
+    float error = 0, peak = 0;
+    for(long j=0; j<(long) O*O; j++) {
+        error = fmax(error, fabs(y2[j] - y3[j]));
+        peak = fmax(peak, fabs(y2[j]));
+    }
+    for(long j=0; j<(long) ROWS*O; j++)
+        error = fmax(error, fabs(y1[j] - y2[j]));
+    errors[0] = error / peak;
+
+    Kernel f(t.data(), TEMPLATE, TEMPLATE, true);
+    correlate(x.data(), N, N, f, y2.data());   // Convolution;
+    convolve_direct(x.data(), N, N, t.data(), TEMPLATE, TEMPLATE, y3.data(), ROWS);
+    error = 0;
+    peak = 0;
+    for(long j=0; j<(long) ROWS*O; j++) {
+        error = fmax(error, fabs(y2[j] - y3[j]));
+        peak = fmax(peak, fabs(y3[j]));
+    }
+    errors[1] = error / peak;
+
+    t0 = chrono::steady_clock::now();
+    ncc(x.data(), N, N, t.data(), TEMPLATE, TEMPLATE, y1.data());
+    t1 = chrono::steady_clock::now();
+    times[3] = chrono::duration<float>(t1 - t0).count();
+    long best = 0;
+    for(long j=0; j<(long) O*O; j++)
+        if(y1[j] > y1[best])
+            best = j;
+    return best / O * N + best % O;
+}
+
+
+/**************************************************************************************************
+ Main Function:
+ **************************************************************************************************/
+int main(int argc, char *argv[]) {
+
+    // Start by printing the table with time comparisons:
+    cout << "+---------+---------+---------+---------+---------+---------+---------+---------+" << endl;
+    cout << "|    N    | Direct  |  Whole  |  Tiled  |   NCC   |  Match  | Error   |  Conv.  |" << endl;
+    cout << "+---------+---------+---------+---------+---------+---------+---------+---------+" << endl;
+
+    // Try it with images with size ranging from 256 to 2048 pixels:
+    for(int r=8; r<12; r++) {
+
+        // Compute the execution time:
+        int n = (int) exp2(r);
+        float times[4], errors[2];
+        long best = measure(n, times, errors);
+        bool found = (best == (long) (n/3) * n + n/5);
+
+        // Print the results:
+        cout << "| " << setw(7) <<     n << " ";
+        cout << "| " << setw(7) << setprecision(7) << times[0] << " ";
+        cout << "| " << setw(7) << setprecision(7) << times[1] << " ";
+        cout << "| " << setw(7) << setprecision(7) << times[2] << " ";
+        cout << "| " << setw(7) << setprecision(7) << times[3] << " ";
+        cout << "| " << setw(7) << (found ? "yes" : "no") << " ";
+        cout << "| " << setw(7) << setprecision(7) << errors[0] << " ";
+        cout << "| " << setw(7) << setprecision(7) << errors[1] << " |" << endl;
+    }
+
+    cout << "+---------+---------+---------+---------+---------+---------+---------+---------+" << endl;
+    return 0;
+}
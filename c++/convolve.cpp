@@ -0,0 +1,477 @@
+/**************************************************************************************************
+ * Fast Fourier Transform -- C++ Version
+ * This version implements convolution and correlation without reordering the samples.
+ *
+ * José Alexandre Nalon
+ **************************************************************************************************
+ * This program doesn't need much to be compiled and run. It can be done, as far as I know, with
+ * any C++ compiler, just remember to link the math library. Optimizations should be turned on, so
+ * the compiler can vectorize the inner loops. In my box, I used the command:
+ *
+ * $ g++ -O3 -march=native -o convolve convolve.cpp -lm
+ *
+ * It can be run with the command (remember to change permission to execute):
+ *
+ * $ ./convolve
+ *
+ * Obs.: The in-place FFT needs the samples in bit-reversed order, either at the input (decimation
+ *   in time) or at the output (decimation in frequency). When the transform is used only to
+ *   compute a convolution, the order of the spectrum doesn't matter, since the spectra are only
+ *   multiplied element by element. So the forward transform decimates in frequency, taking the
+ *   samples in natural order and leaving the spectrum in bit-reversed order, and the inverse
+ *   transform decimates in time, taking the spectrum in bit-reversed order and giving back the
+ *   samples in natural order. No permutation is ever done. The correlation is the convolution
+ *   with the second sequence reversed and conjugated. The table compares the time with the usual
+ *   transforms, which reorder the samples before the butterflies.
+ **************************************************************************************************/
+
+/**************************************************************************************************
+ Include necessary libraries:
+ **************************************************************************************************/
+#include <iostream>                            // Input and Output;
+#include <iomanip>                             // I/O Manipulation;
+#include <cmath>                               // Math Functions;
+#include <chrono>                              // Time measurement;
+#include <map>                                 // Caches;
+#include <vector>                              // Buffers;
+
+using namespace std;
+
+
+/**************************************************************************************************
+ Definitions:
+ **************************************************************************************************/
+#define REPEAT 50                              // Number of executions to compute average time;
+#define CHECKS 64                              // Number of results compared to the direct method;
+
+
+/**************************************************************************************************
+ Small class to operate with complex numbers:
+ **************************************************************************************************/
+class Complex {
+    public:
+        float r;                               // Real part;
+        float i;                               // Imaginary part;
+        Complex();                             // Constructors;
+        Complex(float re, float im);
+        void set(float re, float im);
+        void set(Complex c);
+        Complex operator+(Complex c);          // Addition (overload + operator);
+        Complex operator-(Complex c);          // Subtraction (overload - operator);
+        Complex operator*(Complex c);          // Product (overload * operator);
+        Complex operator*(float a);            // Product with a scalar;
+        Complex cexp();                        // Complex exponential;
+};
+
+Complex::Complex() {                           // Constructor;
+    r = 0.0;                                   // Real part;
+    i = 0.0;                                   // Imaginary part;
+}
+
+Complex::Complex(float re, float im) {         // Constructor;
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(float re, float im) {
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(Complex c) {
+    r = c.r;                                   // Real part;
+    i = c.i;                                   // Imaginary part;
+}
+
+Complex Complex::operator+(Complex c) {
+    return Complex(r + c.r, i + c.i);
+}
+
+Complex Complex::operator-(Complex c) {
+    return Complex(r - c.r, i - c.i);
+}
+
+Complex Complex::operator*(Complex c) {
+    return Complex(r*c.r - i*c.i, r*c.i + i*c.r);
+}
+
+Complex Complex::operator*(float a) {
+    return Complex(a*r, a*i);
+}
+
+Complex Complex::cexp() {
+    return Complex(exp(r)*cos(i), exp(r)*sin(i));
+}
+
+Complex cexpn(float a) {                       // Convenience function to compute the exponential;
+    return Complex(cos(a), sin(a));
+}
+
+
+/**************************************************************************************************
+ * Function: bit_reverse
+ *   Bit-reversed version of an integer number.
+ *
+ * Parameters:
+ *   k
+ *     The number to be bit-reversed;
+ *   r
+ *     The number of bits to take into consideration when reversing.
+ *
+ * Returns:
+ *   The number k, bit-reversed according to integers with r bits.
+ **************************************************************************************************/
+int bit_reverse(int k, int r)
+{
+    int l = 0;                                 // Accumulate the results;
+    for(int i=0; i<r; i++) {                   // Loop on every bit;
+        l = (l << 1) + (k & 1);                // Test less signficant bit and add;
+        k >>= 1;                               // Test next bit;
+    }
+    return l;
+}
+
+
+/**************************************************************************************************
+ Plans hold everything that depends only on the length of the transform, and are kept in a cache:
+ **************************************************************************************************/
+struct Plan {
+    int N;                                     // Length of the transform;
+    vector<int> rev;                           // Bit-reversed indices;
+    vector<Complex> W;                         // Twiddle factors, W[n] = exp(-2 pi n/N);
+};
+
+map<int, Plan *> plans;                        // Cache of plans, indexed by the length;
+
+
+/**************************************************************************************************
+ * Function: get_plan
+ *   Looks for a plan in the cache, creating it if it doesn't exist.
+ *
+ * Parameters:
+ *   N
+ *     The length of the transform. It must be a power of two.
+ *
+ * Returns:
+ *   A pointer to the plan. It is owned by the cache and must not be released.
+ **************************************************************************************************/
+Plan *get_plan(int N)
+{
+    auto p = plans.find(N);
+    if(p != plans.end())                       // Plan was already computed;
+        return p->second;
+
+    Plan *plan = new Plan;
+    plan->N = N;
+    int r = (int) floor(log2(N));              // Number of bits;
+    plan->rev.resize(N);
+    for(int k=0; k<N; k++)                     // Bit-reversed order;
+        plan->rev[k] = bit_reverse(k, r);
+    plan->W.resize(N/2 + 1);
+    for(int n=0; n<=N/2; n++)                  // Twiddle factors computed directly;
+        plan->W[n] = cexpn(-2*M_PI*n/N);
+    plans[N] = plan;
+    return plan;
+}
+
+
+/**************************************************************************************************
+ * Function: fft
+ *   Fast Fourier Transform using an iterative in-place decimation in time algorithm, with the
+ *   twiddle factors taken from the plan. The samples are reordered before the butterflies, so the
+ *   spectrum is in natural order.
+ *
+ * Parameters:
+ *   plan
+ *     Plan for the length of the transform;
+ *   x
+ *     The vector of which the FFT will be computed;
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call, and it can't be the same as the input.
+ **************************************************************************************************/
+void fft(Plan *plan, Complex x[], Complex X[])
+{
+    int N = plan->N;
+    for(int k=0; k<N; k++)                     // Reorder the vector according to the
+        X[plan->rev[k]] = x[k];                //   bit-reversed order;
+
+    for(int step=1; step<N; step<<=1) {
+        int stride = N / (2*step);             // Distance between twiddle factors in the table;
+        for(int l=0; l<N; l+=2*step)
+            for(int n=0; n<step; n++) {
+                int p = l + n;
+                int q = p + step;
+                Complex w = plan->W[n*stride] * X[q];
+                X[q] = X[p] - w;               // Recombine results;
+                X[p] = X[p] + w;
+            }
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: dif_fft
+ *   Fast Fourier Transform using an in-place decimation in frequency algorithm. The samples are
+ *   taken in natural order, and the spectrum is left in bit-reversed order: X[rev[k]] holds the
+ *   coefficient k.
+ *
+ * Parameters:
+ *   plan
+ *     Plan for the length of the transform;
+ *   X
+ *     The samples, that are replaced by the scrambled spectrum.
+ **************************************************************************************************/
+void dif_fft(Plan *plan, Complex X[])
+{
+    int N = plan->N;
+    for(int step=N/2; step>0; step>>=1) {
+        int stride = N / (2*step);             // Distance between twiddle factors in the table;
+        for(int l=0; l<N; l+=2*step)
+            for(int n=0; n<step; n++) {
+                int p = l + n;
+                int q = p + step;
+                Complex d = X[p] - X[q];
+                X[p] = X[p] + X[q];            // Recombine results;
+                X[q] = plan->W[n*stride] * d;
+            }
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: dit_ifft
+ *   Inverse Fast Fourier Transform using an in-place decimation in time algorithm, not divided by
+ *   the length. The spectrum is taken in bit-reversed order, as left by dif_fft, and the samples
+ *   are given back in natural order.
+ *
+ * Parameters:
+ *   plan
+ *     Plan for the length of the transform;
+ *   X
+ *     The scrambled spectrum, that is replaced by the samples.
+ **************************************************************************************************/
+void dit_ifft(Plan *plan, Complex X[])
+{
+    int N = plan->N;
+    for(int step=1; step<N; step<<=1) {
+        int stride = N / (2*step);             // Distance between twiddle factors in the table;
+        for(int l=0; l<N; l+=2*step)
+            for(int n=0; n<step; n++) {
+                int p = l + n;
+                int q = p + step;
+                Complex W = plan->W[n*stride];
+                Complex w = Complex(W.r, -W.i) * X[q];
+                X[q] = X[p] - w;               // Recombine results;
+                X[p] = X[p] + w;
+            }
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: multiply
+ *   Linear convolution of two sequences, computed with transforms of the next power of two. The
+ *   spectra are multiplied in the scrambled order, since the order doesn't matter.
+ *
+ * Parameters:
+ *   x
+ *     The first sequence;
+ *   Nx
+ *     Length of the first sequence;
+ *   h
+ *     The second sequence;
+ *   Nh
+ *     Length of the second sequence;
+ *   y
+ *     Receives the Nx + Nh - 1 results;
+ *   reverse
+ *     If true, the second sequence is reversed and conjugated before the convolution.
+ **************************************************************************************************/
+void multiply(Complex x[], int Nx, Complex h[], int Nh, Complex y[], bool reverse)
+{
+    int M = Nx + Nh - 1, N = 1;
+    while(N < M)
+        N <<= 1;
+    Plan *plan = get_plan(N);
+    vector<Complex> X(N), H(N);
+    for(int n=0; n<Nx; n++)                    // Pad with zeros;
+        X[n] = x[n];
+    for(int n=0; n<Nh; n++)
+        H[n] = reverse ? Complex(h[Nh-1-n].r, -h[Nh-1-n].i) : h[n];
+    dif_fft(plan, X.data());
+    dif_fft(plan, H.data());
+    float scale = 1.0 / N;
+    for(int k=0; k<N; k++)                     // Same order in both spectra;
+        X[k] = X[k] * H[k] * scale;
+    dit_ifft(plan, X.data());
+    for(int n=0; n<M; n++)
+        y[n] = X[n];
+}
+
+
+/**************************************************************************************************
+ * Function: convolve
+ *   Linear convolution of two sequences, y[n] = sum_m x[m] h[n - m].
+ *
+ * Parameters:
+ *   x
+ *     The first sequence;
+ *   Nx
+ *     Length of the first sequence;
+ *   h
+ *     The second sequence;
+ *   Nh
+ *     Length of the second sequence;
+ *   y
+ *     Receives the Nx + Nh - 1 results.
+ **************************************************************************************************/
+void convolve(Complex x[], int Nx, Complex h[], int Nh, Complex y[])
+{
+    multiply(x, Nx, h, Nh, y, false);
+}
+
+
+/**************************************************************************************************
+ * Function: correlate
+ *   Cross-correlation of two sequences, y[j] = sum_m x[m + j - Nh + 1] conj(h[m]). The element j
+ *   of the result corresponds to the lag j - Nh + 1.
+ *
+ * Parameters:
+ *   x
+ *     The first sequence;
+ *   Nx
+ *     Length of the first sequence;
+ *   h
+ *     The second sequence;
+ *   Nh
+ *     Length of the second sequence;
+ *   y
+ *     Receives the Nx + Nh - 1 results.
+ **************************************************************************************************/
+void correlate(Complex x[], int Nx, Complex h[], int Nh, Complex y[])
+{
+    multiply(x, Nx, h, Nh, y, true);
+}
+
+
+/**************************************************************************************************
+ * Function: convolve_reordered
+ *   Linear convolution computed with the usual transforms, that reorder the samples, to compare.
+ *   The inverse transform conjugates the spectrum before and after the forward transform.
+ *
+ * Parameters:
+ *   x
+ *     The first sequence;
+ *   Nx
+ *     Length of the first sequence;
+ *   h
+ *     The second sequence;
+ *   Nh
+ *     Length of the second sequence;
+ *   y
+ *     Receives the Nx + Nh - 1 results.
+ **************************************************************************************************/
+void convolve_reordered(Complex x[], int Nx, Complex h[], int Nh, Complex y[])
+{
+    int M = Nx + Nh - 1, N = 1;
+    while(N < M)
+        N <<= 1;
+    Plan *plan = get_plan(N);
+    vector<Complex> xp(N), hp(N), X(N), H(N);
+    for(int n=0; n<Nx; n++)                    // Pad with zeros;
+        xp[n] = x[n];
+    for(int n=0; n<Nh; n++)
+        hp[n] = h[n];
+    fft(plan, xp.data(), X.data());
+    fft(plan, hp.data(), H.data());
+    float scale = 1.0 / N;
+    for(int k=0; k<N; k++) {
+        Complex Y = X[k] * H[k] * scale;
+        X[k] = Complex(Y.r, -Y.i);
+    }
+    fft(plan, X.data(), xp.data());
+    for(int n=0; n<M; n++)
+        y[n] = Complex(xp[n].r, -xp[n].i);
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: measure
+ *   Measures the time of the convolution of two sequences of N/2 samples, with both methods, and
+ *   compares some results of the convolution and the correlation with the direct computation.
+ *
+ * Parameters:
+ *  N
+ *    Length of the transforms;
+ *  times
+ *    Receives the average times with reordering and without;
+ *  error
+ *    Receives the largest difference to the direct computation, divided by the length.
+ **************************************************************************************************/
+void measure(int N, float times[], float &error)
+{
+    int L = N/2, M = 2*L - 1;
+    vector<Complex> x(L), h(L), y(M), c(M);
+    for(int n=0; n<L; n++) {                   // Initialize the vectors;
+        x[n] = Complex(sin(0.1*n), cos(0.3*n));
+        h[n] = Complex(cos(0.7*n), sin(0.01*n*n));
+    }
+    void (*methods[])(Complex *, int, Complex *, int, Complex *) = { convolve_reordered, convolve };
+    for(int j=0; j<2; j++) {
+        methods[j](x.data(), L, h.data(), L, y.data());    // Warm-up, creates the plan;
+        auto t0 = chrono::steady_clock::now(); // Start counting time;
+        for(int r=0; r<REPEAT; r++)
+            methods[j](x.data(), L, h.data(), L, y.data());
+        auto t1 = chrono::steady_clock::now(); // End of time measuring;
+        times[j] = chrono::duration<float>(t1 - t0).count() / REPEAT;
+    }
+
+    correlate(x.data(), L, h.data(), L, c.data());
+    error = 0;
+    for(int j=0; j<CHECKS; j++) {              // Some results, by the direct method;
+        int n = (int) ((long) j * (M - 1) / (CHECKS - 1));
+        Complex sy = Complex(0, 0), sc = Complex(0, 0);
+        for(int m=0; m<L; m++) {
+            if(n - m >= 0 && n - m < L)
+                sy = sy + x[m] * h[n-m];
+            int k = m + n - L + 1;
+            if(k >= 0 && k < L)
+                sc = sc + x[k] * Complex(h[m].r, -h[m].i);
+        }
+        Complex dy = y[n] - sy, dc = c[n] - sc;
+        error = fmax(error, sqrt(dy.r*dy.r + dy.i*dy.i) / L);
+        error = fmax(error, sqrt(dc.r*dc.r + dc.i*dc.i) / L);
+    }
+}
+
+
+/**************************************************************************************************
+ Main Function:
+ **************************************************************************************************/
+int main(int argc, char *argv[]) {
+
+    // Start by printing the table with time comparisons:
+    cout << "+---------+---------+---------+---------+---------+" << endl;
+    cout << "|    N    | Reorder.| Scrambl.| Speedup | Error   |" << endl;
+    cout << "+---------+---------+---------+---------+---------+" << endl;
+
+    // Try it with transforms with size ranging from 64 to 262144 samples:
+    for(int r=6; r<19; r+=2) {
+
+        // Compute the execution time:
+        int n = (int) exp2(r);
+        float times[2], error;
+        measure(n, times, error);
+
+        // Print the results:
+        cout << "| " << setw(7) <<     n << " ";
+        cout << "| " << setw(7) << setprecision(7) << times[0] << " ";
+        cout << "| " << setw(7) << setprecision(7) << times[1] << " ";
+        cout << "| " << setw(7) << setprecision(3) << times[0] / times[1] << " ";
+        cout << "| " << setw(7) << setprecision(7) << error << " |" << endl;
+    }
+
+    cout << "+---------+---------+---------+---------+---------+" << endl;
+    return 0;
+}
@@ -0,0 +1,572 @@
+/**************************************************************************************************
+ * Fast Fourier Transform -- C++ Version
+ * This version implements the continuous wavelet transform with Morlet wavelets.
+ *
+ * José Alexandre Nalon
+ **************************************************************************************************
+ * This program doesn't need much to be compiled and run. It can be done, as far as I know, with
+ * any C++ compiler, just remember to link the math and threads libraries. Optimizations should be
+ * turned on, so the compiler can vectorize the inner loops. In my box, I used the command:
+ *
+ * $ g++ -O3 -march=native -o cwt cwt.cpp -lm -lpthread
+ *
+ * It can be run with the command (remember to change permission to execute):
+ *
+ * $ ./cwt
+ *
+ * Obs.: The continuous wavelet transform correlates the signal with scaled versions of a wavelet.
+ *   For every scale, that is a convolution, and it is computed in the frequency domain: the
+ *   spectrum of the signal is computed only once (with a real FFT of half the length), and it is
+ *   multiplied by the spectrum of the wavelet in every scale, followed by an inverse transform.
+ *   The Morlet wavelet is a complex exponential under a gaussian envelope, and its spectrum is a
+ *   gaussian around the center frequency of the scale, with no negative frequencies; so the
+ *   spectra are computed once, when the object is created, and only the bins where they are not
+ *   negligible are kept. The inverse transforms are computed in batches of scales, with the index
+ *   of the scale running faster, so the innermost loop can be vectorized, and the batches are
+ *   split among threads. Every scale is given to a function as soon as it is computed, so the
+ *   memory needed doesn't depend on the number of scales.
+ **************************************************************************************************/
+
+/**************************************************************************************************
+ Include necessary libraries:
+ **************************************************************************************************/
+#include <iostream>                            // Input and Output;
+#include <iomanip>                             // I/O Manipulation;
+#include <cmath>                               // Math Functions;
+#include <chrono>                              // Time measurement;
+#include <vector>                              // Buffers;
+#include <functional>                          // Work given to threads;
+#include <thread>                              // Threads;
+
+using namespace std;
+
+
+/**************************************************************************************************
+ Definitions:
+ **************************************************************************************************/
+#define REPEAT 4                               // Number of executions to compute average time;
+#define SCALES 128                             // Number of scales;
+#define VOICES 16                              // Number of scales per octave;
+#define BATCH 8                                // Number of scales in a batch of transforms;
+#define OMEGA0 6                               // Center frequency of the mother wavelet;
+#define TOLERANCE 1e-7                         // Wavelet spectra below this are discarded;
+
+
+/**************************************************************************************************
+ Small class to operate with complex numbers:
+ **************************************************************************************************/
+class Complex {
+    public:
+        float r;                               // Real part;
+        float i;                               // Imaginary part;
+        Complex();                             // Constructors;
+        Complex(float re, float im);
+        void set(float re, float im);
+        void set(Complex c);
+        Complex operator+(Complex c);          // Addition (overload + operator);
+        Complex operator-(Complex c);          // Subtraction (overload - operator);
+        Complex operator*(Complex c);          // Product (overload * operator);
+        Complex operator*(float a);            // Product with a scalar;
+        Complex cexp();                        // Complex exponential;
+};
+
+Complex::Complex() {                           // Constructor;
+    r = 0.0;                                   // Real part;
+    i = 0.0;                                   // Imaginary part;
+}
+
+Complex::Complex(float re, float im) {         // Constructor;
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(float re, float im) {
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(Complex c) {
+    r = c.r;                                   // Real part;
+    i = c.i;                                   // Imaginary part;
+}
+
+Complex Complex::operator+(Complex c) {
+    return Complex(r + c.r, i + c.i);
+}
+
+Complex Complex::operator-(Complex c) {
+    return Complex(r - c.r, i - c.i);
+}
+
+Complex Complex::operator*(Complex c) {
+    return Complex(r*c.r - i*c.i, r*c.i + i*c.r);
+}
+
+Complex Complex::operator*(float a) {
+    return Complex(a*r, a*i);
+}
+
+Complex Complex::cexp() {
+    return Complex(exp(r)*cos(i), exp(r)*sin(i));
+}
+
+Complex cexpn(float a) {                       // Convenience function to compute the exponential;
+    return Complex(cos(a), sin(a));
+}
+
+
+/**************************************************************************************************
+ * Function: bit_reverse
+ *   Bit-reversed version of an integer number.
+ *
+ * Parameters:
+ *   k
+ *     The number to be bit-reversed;
+ *   r
+ *     The number of bits to take into consideration when reversing.
+ *
+ * Returns:
+ *   The number k, bit-reversed according to integers with r bits.
+ **************************************************************************************************/
+int bit_reverse(int k, int r)
+{
+    int l = 0;                                 // Accumulate the results;
+    for(int i=0; i<r; i++) {                   // Loop on every bit;
+        l = (l << 1) + (k & 1);                // Test less signficant bit and add;
+        k >>= 1;                               // Test next bit;
+    }
+    return l;
+}
+
+
+/**************************************************************************************************
+ Plans hold everything that depends only on the length of the transform:
+ **************************************************************************************************/
+struct Plan {
+    int N;                                     // Length of the transform;
+    vector<int> rev;                           // Bit-reversed indices;
+    vector<Complex> W;                         // Twiddle factors, W[n] = exp(-2 pi n/N);
+};
+
+
+/**************************************************************************************************
+ * Function: make_plan
+ *   Computes the plan for a given length.
+ *
+ * Parameters:
+ *   N
+ *     The length of the transform. It must be a power of two.
+ *
+ * Returns:
+ *   The plan.
+ **************************************************************************************************/
+Plan make_plan(int N)
+{
+    Plan plan;
+    plan.N = N;
+    int r = (int) floor(log2(N));              // Number of bits;
+    plan.rev.resize(N);
+    for(int k=0; k<N; k++)                     // Bit-reversed order;
+        plan.rev[k] = bit_reverse(k, r);
+    plan.W.resize(N/2 + 1);
+    for(int n=0; n<=N/2; n++)                  // Twiddle factors computed directly;
+        plan.W[n] = cexpn(-2*M_PI*n/N);
+    return plan;
+}
+
+
+/**************************************************************************************************
+ * Function: fft
+ *   Fast Fourier Transform using an iterative in-place decimation in time algorithm, with the
+ *   twiddle factors taken from the plan.
+ *
+ * Parameters:
+ *   plan
+ *     Plan for the length of the transform;
+ *   x
+ *     The vector of which the FFT will be computed;
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call, and it can't be the same as the input.
+ **************************************************************************************************/
+void fft(Plan &plan, Complex x[], Complex X[])
+{
+    int N = plan.N;
+    for(int k=0; k<N; k++)                     // Reorder the vector according to the
+        X[plan.rev[k]] = x[k];                 //   bit-reversed order;
+
+    for(int step=1; step<N; step<<=1) {
+        int stride = N / (2*step);             // Distance between twiddle factors in the table;
+        for(int l=0; l<N; l+=2*step)
+            for(int n=0; n<step; n++) {
+                int p = l + n;
+                int q = p + step;
+                Complex w = plan.W[n*stride] * X[q];
+                X[q] = X[p] - w;               // Recombine results;
+                X[p] = X[p] + w;
+            }
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: real_fft
+ *   Transform of a real vector of even length N. The even samples are put in the real part and
+ *   the odd samples in the imaginary part of a complex vector of length N/2, and the spectrum is
+ *   separated after the transform.
+ *
+ * Parameters:
+ *   half
+ *     Plan for the length N/2;
+ *   full
+ *     Plan for the length N (only the twiddle factors are used);
+ *   x
+ *     The real vector of which the FFT will be computed;
+ *   X
+ *     The vector that will receive the first N/2 + 1 bins of the spectrum (the others are the
+ *     complex conjugates of those).
+ **************************************************************************************************/
+void real_fft(Plan &half, Plan &full, float x[], Complex X[])
+{
+    int H = half.N;
+    vector<Complex> z(H), Z(H + 1);
+    for(int n=0; n<H; n++)                     // Pack the real vector;
+        z[n] = Complex(x[2*n], x[2*n+1]);
+    fft(half, z.data(), Z.data());
+    Z[H] = Z[0];
+
+    for(int k=0; k<=H; k++) {                  // Split the spectrum;
+        Complex a = Z[k];
+        Complex b = Complex(Z[H-k].r, -Z[H-k].i);
+        Complex E = (a + b) * 0.5;             // Transform of the even samples;
+        Complex O = a - b;                     // Transform of the odd samples;
+        O = Complex(O.i * 0.5, -O.r * 0.5);
+        X[k] = E + full.W[k] * O;
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: batch_ifft
+ *   Computes a batch of inverse transforms, in place, over transposed buffers: the element k of
+ *   the transform b is in re[k*B + b] and im[k*B + b], and the elements must already be in
+ *   bit-reversed order. The inverse is computed by conjugation, so the imaginary parts must be
+ *   given conjugated, and they are conjugated in the result as well. The twiddle factors are read
+ *   only once for the whole batch, and the innermost loop can be vectorized.
+ *
+ * Parameters:
+ *   plan
+ *     Plan for the length of the transforms;
+ *   re, im
+ *     Real and imaginary parts of the transposed buffers;
+ *   B
+ *     Number of transforms in the batch.
+ **************************************************************************************************/
+void batch_ifft(Plan &plan, float re[], float im[], int B)
+{
+    int N = plan.N;
+    for(int step=1; step<N; step<<=1) {
+        int stride = N / (2*step);
+        for(int l=0; l<N; l+=2*step)
+            for(int n=0; n<step; n++) {
+                Complex W = plan.W[n*stride];
+                float *pr = &re[(l+n)*B], *pi = &im[(l+n)*B];
+                float *qr = &re[(l+n+step)*B], *qi = &im[(l+n+step)*B];
+                for(int b=0; b<B; b++) {       // This loop is vectorized;
+                    float tr = W.r*qr[b] - W.i*qi[b];
+                    float ti = W.r*qi[b] + W.i*qr[b];
+                    qr[b] = pr[b] - tr;        // Recombine results;
+                    qi[b] = pi[b] - ti;
+                    pr[b] = pr[b] + tr;
+                    pi[b] = pi[b] + ti;
+                }
+            }
+    }
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: parallel_for
+ *   Splits a range of indices among a number of threads, and waits for all of them.
+ *
+ * Parameters:
+ *   n
+ *     Number of indices; they range from 0 to n-1;
+ *   threads
+ *     Number of threads;
+ *   f
+ *     Function to be called by every thread, with the first and one past the last index.
+ **************************************************************************************************/
+void parallel_for(int n, int threads, function<void(int, int)> f)
+{
+    vector<thread> workers;
+    int per = (n + threads - 1) / threads;
+    for(int i=per; i<n; i+=per)                // First part is computed by this thread;
+        workers.push_back(thread(f, i, min(n, i + per)));
+    f(0, min(n, per));
+    for(auto &w : workers)
+        w.join();
+}
+
+
+/**************************************************************************************************
+ Spectrum of the wavelet in one scale. Only the bins from `first` on, where the spectrum is not
+ negligible, are kept:
+ **************************************************************************************************/
+struct Scale {
+    float s;                                   // Scale, in samples;
+    int first;                                 // First bin kept;
+    vector<float> psi;                         // Spectrum of the wavelet (it is real);
+};
+
+
+/**************************************************************************************************
+ Class that implements the wavelet transform for signals of a given length, over a given set of
+ scales:
+ **************************************************************************************************/
+class CWT {
+    public:
+        CWT(int N, vector<float> &scales, int threads);
+        void transform(float x[], function<void(int, Complex *)> sink);
+    private:
+        int N;                                 // Length of the signals;
+        int threads;                           // Number of threads;
+        Plan full;                             // Plan for the inverse transforms;
+        Plan half;                             // Plan for the real transform;
+        vector<Scale> scales;                  // Spectra of the wavelets;
+};
+
+
+/**************************************************************************************************
+ * Method: CWT::CWT
+ *   Computes the spectra of the wavelets. The wavelet of scale s is
+ *
+ *     psi_s(t) = pi^(-1/4) exp(i w0 t/s) exp(-t^2/(2 s^2)) / sqrt(s)
+ *
+ *   and its spectrum is sqrt(2 pi s) pi^(-1/4) exp(-(s w - w0)^2/2), for w = 2 pi k/N.
+ *
+ * Parameters:
+ *   N
+ *     Length of the signals. It must be a power of two;
+ *   scales
+ *     Scales of the transform, in samples;
+ *   threads
+ *     Number of threads.
+ **************************************************************************************************/
+CWT::CWT(int N, vector<float> &scales, int threads)
+{
+    this->N = N;
+    this->threads = threads;
+    full = make_plan(N);
+    half = make_plan(N/2);
+    for(float s : scales) {
+        Scale sc;
+        sc.s = s;
+        sc.first = -1;
+        float A = sqrt(2*M_PI*s) / pow(M_PI, 0.25);
+        for(int k=0; k<=N/2; k++) {            // Keep only the bins that matter;
+            float w = 2*M_PI*k/N;
+            float p = A * exp(-0.5 * (s*w - OMEGA0) * (s*w - OMEGA0));
+            if(p < TOLERANCE * A) {
+                if(sc.first < 0)
+                    continue;
+                break;
+            }
+            if(sc.first < 0)
+                sc.first = k;
+            sc.psi.push_back(p);
+        }
+        if(sc.first < 0)
+            sc.first = 0;
+        this->scales.push_back(sc);
+    }
+}
+
+
+/**************************************************************************************************
+ * Method: CWT::transform
+ *   Computes the wavelet transform of a real signal. The spectrum of the signal is computed once;
+ *   the scales are split in batches, every thread computes its batches with its own buffers, and
+ *   every scale is given to the sink when its batch is done. Different scales can be given to the
+ *   sink at the same time by different threads.
+ *
+ * Parameters:
+ *   x
+ *     The signal, with N samples;
+ *   sink
+ *     Function that receives the index of the scale and the N coefficients of that scale. The
+ *     coefficients are valid only during the call.
+ **************************************************************************************************/
+void CWT::transform(float x[], function<void(int, Complex *)> sink)
+{
+    vector<Complex> X(N/2 + 1);
+    real_fft(half, full, x, X.data());
+
+    int S = scales.size();
+    int batches = (S + BATCH - 1) / BATCH;
+    parallel_for(batches, threads, [&](int b0, int b1) {
+        vector<float> re((long) N*BATCH), im((long) N*BATCH);
+        vector<Complex> row(N);
+        for(int b=b0; b<b1; b++) {
+            int s0 = b*BATCH, B = min(S, s0 + BATCH) - s0;
+            fill(re.begin(), re.begin() + (long) N*B, 0.0f);
+            fill(im.begin(), im.begin() + (long) N*B, 0.0f);
+            for(int j=0; j<B; j++) {           // Multiply by the spectra, in bit-reversed order;
+                Scale &sc = scales[s0 + j];
+                for(int k=0; k<(int) sc.psi.size(); k++) {
+                    long l = (long) full.rev[sc.first + k]*B + j;
+                    re[l] = X[sc.first + k].r * sc.psi[k];
+                    im[l] = -X[sc.first + k].i * sc.psi[k];
+                }
+            }
+            batch_ifft(full, re.data(), im.data(), B);
+            for(int j=0; j<B; j++) {           // Give the scales to the sink;
+                for(int n=0; n<N; n++)
+                    row[n] = Complex(re[(long) n*B + j] / N, -im[(long) n*B + j] / N);
+                sink(s0 + j, row.data());
+            }
+        }
+    });
+}
+
+
+/**************************************************************************************************
+ * Function: direct_cwt
+ *   Computes one scale of the wavelet transform by correlation in the time domain, with the
+ *   wavelet truncated where its envelope is negligible. The signal is taken as periodic, as in
+ *   the frequency domain.
+ *
+ * Parameters:
+ *   x
+ *     The signal;
+ *   N
+ *     Number of samples in the signal;
+ *   s
+ *     The scale;
+ *   W
+ *     Receives the N coefficients.
+ **************************************************************************************************/
+void direct_cwt(float x[], int N, float s, Complex W[])
+{
+    int L = (int) ceil(s * sqrt(-2 * log(TOLERANCE)));
+    vector<Complex> psi(2*L + 1);
+    float A = 1 / (pow(M_PI, 0.25) * sqrt(s));
+    for(int m=-L; m<=L; m++)                   // Conjugated wavelet;
+        psi[m + L] = cexpn(-OMEGA0 * m / s) * (A * exp(-0.5 * m * m / (s * s)));
+    for(int n=0; n<N; n++) {
+        Complex acc = Complex(0, 0);
+        for(int m=-L; m<=L; m++)
+            acc = acc + psi[m + L] * x[((n + m) % N + N) % N];
+        W[n] = acc;
+    }
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: make_scales
+ *   Scales in geometric progression, VOICES per octave, starting at four samples (smaller scales
+ *   have center frequencies too close to half the sampling rate, and the wavelet aliases).
+ *
+ * Returns:
+ *   The scales.
+ **************************************************************************************************/
+vector<float> make_scales()
+{
+    vector<float> s(SCALES);
+    for(int j=0; j<SCALES; j++)
+        s[j] = 4 * exp2((float) j / VOICES);
+    return s;
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: measure
+ *   Measures the time per scale of the direct correlation and of the transform in the frequency
+ *   domain, with one thread and with every thread, and the largest difference between them. The
+ *   direct correlation is measured only in every VOICES-th scale.
+ *
+ * Parameters:
+ *  N
+ *    Length of the signal;
+ *  times
+ *    Receives the three times;
+ *
+ * Returns:
+ *   The largest difference between the methods, relative to the largest coefficient.
+ **************************************************************************************************/
+float measure(int N, float times[])
+{
+    vector<float> s = make_scales();
+    vector<float> x(N);
+    for(int n=0; n<N; n++)                     // A chirp and some noise;
+        x[n] = sin(1e-5 * n * n) + 0.1 * ((n * 7919) % 101 - 50) / 50.0;
+    vector<Complex> W(N);
+
+    auto t0 = chrono::steady_clock::now();
+    float error = 0, peak = 0;
+    for(int j=0; j<SCALES; j+=VOICES)
+        direct_cwt(x.data(), N, s[j], W.data());
+    auto t1 = chrono::steady_clock::now();
+    times[0] = chrono::duration<float>(t1 - t0).count() / (SCALES / VOICES);
+
+    for(int i=0; i<2; i++) {
+        int threads = (i == 0) ? 1 : max(1, (int) thread::hardware_concurrency());
+        CWT cwt(N, s, threads);
+        vector<float> energy(SCALES);          // Energy of every scale, to use the results;
+        auto t0 = chrono::steady_clock::now();
+        for(int r=0; r<REPEAT; r++)
+            cwt.transform(x.data(), [&](int j, Complex *w) {
+                float e = 0;
+                for(int n=0; n<N; n++)
+                    e += w[n].r*w[n].r + w[n].i*w[n].i;
+                energy[j] = e;                 // Every scale is given only once;
+            });
+        auto t1 = chrono::steady_clock::now();
+        times[i+1] = chrono::duration<float>(t1 - t0).count() / (REPEAT * SCALES);
+    }
+
+    CWT cwt(N, s, 1);
+    vector<Complex> D(N);
+    cwt.transform(x.data(), [&](int j, Complex *w) {
+        if(j % VOICES != 0)
+            return;
+        direct_cwt(x.data(), N, s[j], D.data());
+        for(int n=0; n<N; n++) {
+            Complex d = w[n] - D[n];
+            error = fmax(error, sqrt(d.r*d.r + d.i*d.i));
+            peak = fmax(peak, sqrt(D[n].r*D[n].r + D[n].i*D[n].i));
+        }
+    });
+    return error / peak;
+}
+
+
+/**************************************************************************************************
+ Main Function:
+ **************************************************************************************************/
+int main(int argc, char *argv[]) {
+
+    // Start by printing the table with time comparisons:
+    cout << "+---------+---------+---------+---------+---------+" << endl;
+    cout << "|    N    | Direct  |   CWT   | Threads | Error   |" << endl;
+    cout << "+---------+---------+---------+---------+---------+" << endl;
+
+    // Try it with signals with size ranging from 1024 to 65536 samples:
+    for(int r=10; r<17; r++) {
+
+        // Compute the average execution time per scale:
+        int n = (int) exp2(r);
+        float times[3];
+        float error = measure(n, times);
+
+        // Print the results:
+        cout << "| " << setw(7) <<     n << " ";
+        cout << "| " << setw(7) << setprecision(7) << times[0] << " ";
+        cout << "| " << setw(7) << setprecision(7) << times[1] << " ";
+        cout << "| " << setw(7) << setprecision(7) << times[2] << " ";
+        cout << "| " << setw(7) << setprecision(7) << error << " |" << endl;
+    }
+
+    cout << "+---------+---------+---------+---------+---------+" << endl;
+    return 0;
+}
@@ -0,0 +1,464 @@
+/**************************************************************************************************
+ * Fast Fourier Transform -- C++ Version
+ * This version updates a spectrum when only a few samples of the signal change.
+ *
+ * José Alexandre Nalon
+ **************************************************************************************************
+ * This program doesn't need much to be compiled and run. It can be done, as far as I know, with
+ * any C++ compiler, just remember to link the math library. Optimizations should be turned on, so
+ * the compiler can vectorize the inner loops. In my box, I used the command:
+ *
+ * $ g++ -O3 -march=native -o dftupdate dftupdate.cpp -lm
+ *
+ * It can be run with the command (remember to change permission to execute):
+ *
+ * $ ./dftupdate
+ *
+ * Obs.: The DFT is linear, so if the sample x[n] changes by d, every coefficient X[k] changes by
+ *   d W^(kn), with W = exp(-2 pi i/N). Updating the spectrum costs O(N) operations for every
+ *   sample that changes, instead of the O(N log N) of a new transform, so it is worth when only
+ *   a few samples change. The twiddle factors W^(kn) are generated in a number of lanes: the lane
+ *   j starts at W^(jn), and every lane is multiplied by the same factor W^(Ln) at every step, so
+ *   the loop over the lanes can be vectorized. The lanes are taken again from a table from time
+ *   to time, so rounding errors don't accumulate. When the number of changed samples is large
+ *   enough, the spectrum is computed again with the iterative FFT; the limit is found when the
+ *   object is created, by timing one update and one transform, since the ratio between them
+ *   depends on the length and on the machine.
+ **************************************************************************************************/
+
+/**************************************************************************************************
+ Include necessary libraries:
+ **************************************************************************************************/
+#include <iostream>                            // Input and Output;
+#include <iomanip>                             // I/O Manipulation;
+#include <cmath>                               // Math Functions;
+#include <chrono>                              // Time measurement;
+#include <vector>                              // Buffers;
+
+using namespace std;
+
+
+/**************************************************************************************************
+ Definitions:
+ **************************************************************************************************/
+#define REPEAT 200                             // Number of executions to compute average time;
+#define LANES 16                               // Number of twiddle factors generated together;
+#define RESEED 16                              // Steps before the lanes are taken from the table;
+#define CALIBRATE 8                            // Runs timed to find the limit for the FFT;
+
+
+/**************************************************************************************************
+ Small class to operate with complex numbers:
+ **************************************************************************************************/
+class Complex {
+    public:
+        float r;                               // Real part;
+        float i;                               // Imaginary part;
+        Complex();                             // Constructors;
+        Complex(float re, float im);
+        void set(float re, float im);
+        void set(Complex c);
+        Complex operator+(Complex c);          // Addition (overload + operator);
+        Complex operator-(Complex c);          // Subtraction (overload - operator);
+        Complex operator*(Complex c);          // Product (overload * operator);
+        Complex operator*(float a);            // Product with a scalar;
+        Complex cexp();                        // Complex exponential;
+};
+
+Complex::Complex() {                           // Constructor;
+    r = 0.0;                                   // Real part;
+    i = 0.0;                                   // Imaginary part;
+}
+
+Complex::Complex(float re, float im) {         // Constructor;
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(float re, float im) {
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(Complex c) {
+    r = c.r;                                   // Real part;
+    i = c.i;                                   // Imaginary part;
+}
+
+Complex Complex::operator+(Complex c) {
+    return Complex(r + c.r, i + c.i);
+}
+
+Complex Complex::operator-(Complex c) {
+    return Complex(r - c.r, i - c.i);
+}
+
+Complex Complex::operator*(Complex c) {
+    return Complex(r*c.r - i*c.i, r*c.i + i*c.r);
+}
+
+Complex Complex::operator*(float a) {
+    return Complex(a*r, a*i);
+}
+
+Complex Complex::cexp() {
+    return Complex(exp(r)*cos(i), exp(r)*sin(i));
+}
+
+Complex cexpn(float a) {                       // Convenience function to compute the exponential;
+    return Complex(cos(a), sin(a));
+}
+
+
+/**************************************************************************************************
+ * Function: bit_reverse
+ *   Bit-reversed version of an integer number.
+ *
+ * Parameters:
+ *   k
+ *     The number to be bit-reversed;
+ *   r
+ *     The number of bits to take into consideration when reversing.
+ *
+ * Returns:
+ *   The number k, bit-reversed according to integers with r bits.
+ **************************************************************************************************/
+int bit_reverse(int k, int r)
+{
+    int l = 0;                                 // Accumulate the results;
+    for(int i=0; i<r; i++) {                   // Loop on every bit;
+        l = (l << 1) + (k & 1);                // Test less signficant bit and add;
+        k >>= 1;                               // Test next bit;
+    }
+    return l;
+}
+
+
+/**************************************************************************************************
+ * Function: iterative_fft
+ *   Fast Fourier Transform using an iterative in-place decimation in time algorithm. This has
+ *   O(N log_2(N)) complexity, and since there are less function calls, it will probably be
+ *   marginally faster than the recursive versions.
+ *
+ * Parameters:
+ *   x
+ *     The vector of which the FFT will be computed. This should always be called with a vector of
+ *     a power of two length, or it will fail. No checks on this are made.
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call;
+ *   N
+ *     The number of elements in the vector.
+ **************************************************************************************************/
+void iterative_fft(Complex x[], Complex X[], int N)
+{
+    int r = (int) floor(log2(N));              // Number of bits;
+    for(int k=0; k<N; k++) {
+        int l = bit_reverse(k, r);             // Reorder the vector according to the
+        X[l] = x[k];                           //   bit-reversed order;
+    }
+
+    int step = 1;                              // Auxiliary for computation of twiddle factors;
+    for(int k=0; k<r; k++) {
+        for(int l=0; l<N; l+=2*step) {
+            Complex W = cexpn(-M_PI/step);     // Twiddle factors;
+            Complex Wkn = Complex(1, 0);
+            for(int n=0; n<step; n++) {
+                int p = l + n;
+                int q = p + step;
+                X[q] = X[p] - Wkn * X[q];      // Recombine results;
+                X[p] = X[p]*2 - X[q];
+                Wkn = Wkn * W;                 // Update twiddle factors;
+            }
+        }
+        step <<= 1;
+    }
+}
+
+
+/**************************************************************************************************
+ Class that keeps a signal and its spectrum, and updates the spectrum when samples change:
+ **************************************************************************************************/
+class IncrementalDFT {
+    public:
+        IncrementalDFT(Complex x[], int N);
+        void change(int n[], Complex v[], int m);
+        Complex *spectrum();
+        int transforms;                        // Number of full transforms computed;
+        int limit;                             // Changes above which the FFT is used;
+    private:
+        int N;                                 // Length of the signal;
+        vector<Complex> x;                     // Signal;
+        vector<Complex> X;                     // Spectrum;
+        vector<float> Wr, Wi;                  // Table of twiddle factors, W^n;
+        vector<float> Xr, Xi;                  // Spectrum, in separate buffers while updating;
+        void add(int n, Complex d);
+};
+
+
+/**************************************************************************************************
+ * Method: IncrementalDFT::IncrementalDFT
+ *   Keeps a copy of the signal and computes its spectrum. The time of one update (averaged over
+ *   CALIBRATE updates) and of one transform are measured, keeping the fastest of CALIBRATE runs,
+ *   and their ratio is the number of changes above which the FFT is used.
+ *
+ * Parameters:
+ *   x
+ *     The signal;
+ *   N
+ *     The number of samples. It must be a power of two, not smaller than LANES.
+ **************************************************************************************************/
+IncrementalDFT::IncrementalDFT(Complex x[], int N)
+{
+    this->N = N;
+    this->x.assign(x, x + N);
+    X.resize(N);
+    Xr.resize(N);
+    Xi.resize(N);
+    Wr.resize(N);
+    Wi.resize(N);
+    for(int n=0; n<N; n++) {                   // Twiddle factors computed directly;
+        Complex w = cexpn(-2*M_PI*n/N);
+        Wr[n] = w.r;
+        Wi[n] = w.i;
+    }
+    iterative_fft(x, X.data(), N);
+    transforms = 1;
+
+    vector<Complex> Y(N);
+    float tu = 1e30, tf = 1e30;
+    for(int j=0; j<CALIBRATE; j++) {           // Updates and transform, in the scratch buffers;
+        auto t0 = chrono::steady_clock::now();
+        for(int i=0; i<CALIBRATE; i++)
+            add((j*CALIBRATE + i) * 7919 % N, Complex(1, 0));
+        auto t1 = chrono::steady_clock::now();
+        iterative_fft(x, Y.data(), N);
+        auto t2 = chrono::steady_clock::now();
+        tu = fmin(tu, chrono::duration<float>(t1 - t0).count() / CALIBRATE);
+        tf = fmin(tf, chrono::duration<float>(t2 - t1).count());
+    }
+    limit = max(1, (int) (tf / tu));
+}
+
+
+/**************************************************************************************************
+ * Method: IncrementalDFT::spectrum
+ *   The spectrum of the current signal.
+ **************************************************************************************************/
+Complex *IncrementalDFT::spectrum()
+{
+    return X.data();
+}
+
+
+/**************************************************************************************************
+ * Method: IncrementalDFT::add
+ *   Adds d W^(kn) to every coefficient of the spectrum, in the separate buffers. The twiddle
+ *   factors are generated in LANES lanes; lane j starts at W^(jn) and is multiplied by W^(LANES n)
+ *   at every step, and every RESEED steps the lanes are taken from the table again.
+ *
+ * Parameters:
+ *   n
+ *     Index of the sample that changed;
+ *   d
+ *     Change of the sample.
+ **************************************************************************************************/
+void IncrementalDFT::add(int n, Complex d)
+{
+    int mask = N - 1;
+    float cr[LANES], ci[LANES];                // Current twiddle factors of every lane;
+    int s = (LANES * n) & mask;
+    float sr = Wr[s], si = Wi[s];              // Factor of every step;
+    for(int k0=0; k0<N; k0+=LANES) {
+        if((k0 / LANES) % RESEED == 0)         // Take the lanes from the table;
+            for(int j=0; j<LANES; j++) {
+                int l = ((long) (k0 + j) * n) & mask;
+                cr[j] = Wr[l];
+                ci[j] = Wi[l];
+            }
+        float *xr = &Xr[k0], *xi = &Xi[k0];
+        for(int j=0; j<LANES; j++) {           // This loop is vectorized;
+            xr[j] += d.r*cr[j] - d.i*ci[j];
+            xi[j] += d.r*ci[j] + d.i*cr[j];
+            float t = cr[j]*sr - ci[j]*si;     // Next twiddle factor of the lane;
+            ci[j] = cr[j]*si + ci[j]*sr;
+            cr[j] = t;
+        }
+    }
+}
+
+
+/**************************************************************************************************
+ * Method: IncrementalDFT::change
+ *   Changes some samples of the signal and updates the spectrum. If the number of changes is
+ *   greater than the limit found when the object was created, the spectrum is computed again
+ *   with the FFT.
+ *
+ * Parameters:
+ *   n
+ *     Indices of the samples that change. They can be repeated;
+ *   v
+ *     New values of the samples;
+ *   m
+ *     Number of changes.
+ **************************************************************************************************/
+void IncrementalDFT::change(int n[], Complex v[], int m)
+{
+    if(m > limit) {                            // Dense enough, compute everything again;
+        for(int j=0; j<m; j++)
+            x[n[j]] = v[j];
+        iterative_fft(x.data(), X.data(), N);
+        transforms++;
+        return;
+    }
+
+    for(int k=0; k<N; k++) {                   // Separate buffers, so the loops are vectorized;
+        Xr[k] = X[k].r;
+        Xi[k] = X[k].i;
+    }
+    for(int j=0; j<m; j++) {
+        add(n[j], v[j] - x[n[j]]);
+        x[n[j]] = v[j];
+    }
+    for(int k=0; k<N; k++)
+        X[k] = Complex(Xr[k], Xi[k]);
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: time_it
+ *   Measures the time of changing a number of samples, with the incremental update (even if the
+ *   number is large) or with a full transform.
+ *
+ * Parameters:
+ *  N
+ *    Length of the signal;
+ *  m
+ *    Number of samples that change in every call;
+ *  full
+ *    If true, computes a full transform in every call;
+ *  error
+ *    Receives the largest difference between the updated spectrum and a full transform.
+ *
+ * Returns:
+ *   The average time of a call.
+ **************************************************************************************************/
+float time_it(int N, int m, bool full, float &error)
+{
+    vector<Complex> x(N), X(N), v(m);
+    vector<int> n(m);
+    for(int j=0; j<N; j++)                     // Initialize the vector;
+        x[j] = Complex(sin(j), cos(3*j));
+    IncrementalDFT dft(x.data(), N);
+
+    auto t0 = chrono::steady_clock::now();     // Start counting time;
+    for(int r=0; r<REPEAT; r++) {
+        for(int j=0; j<m; j++) {               // Some samples change;
+            n[j] = (r * 7919 + j * 104729) % N;
+            v[j] = Complex(sin(r + j), cos(r * j));
+            x[n[j]] = v[j];
+        }
+        if(full)
+            iterative_fft(x.data(), X.data(), N);
+        else
+            for(int j=0; j<m; j+=dft.limit)    // Keep every call incremental;
+                dft.change(&n[j], &v[j], min(m - j, dft.limit));
+    }
+    auto t1 = chrono::steady_clock::now();     // End of time measuring;
+
+    iterative_fft(x.data(), X.data(), N);
+    error = 0;
+    for(int k=0; k<N; k++) {
+        Complex d = X[k] - dft.spectrum()[k];
+        error = fmax(error, sqrt(d.r*d.r + d.i*d.i) / N);
+    }
+    return chrono::duration<float>(t1 - t0).count() / REPEAT;
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: dense
+ *   Changes more samples than the limit in a single call, so the spectrum is computed again with
+ *   the FFT, and checks the result.
+ *
+ * Parameters:
+ *  N
+ *    Length of the signal;
+ *  limit
+ *    Receives the limit found by the object;
+ *  error
+ *    Receives the largest difference between the spectrum and a full transform.
+ *
+ * Returns:
+ *   True if the call computed a full transform.
+ **************************************************************************************************/
+bool dense(int N, int &limit, float &error)
+{
+    vector<Complex> x(N), X(N);
+    for(int j=0; j<N; j++)                     // Initialize the vector;
+        x[j] = Complex(sin(j), cos(3*j));
+    IncrementalDFT dft(x.data(), N);
+    limit = dft.limit;
+
+    int m = min(N, 2*limit + 1);               // Changes, more than the limit;
+    vector<Complex> v(m);
+    vector<int> n(m);
+    for(int j=0; j<m; j++) {
+        n[j] = (j * 104729) % N;
+        v[j] = Complex(cos(j), sin(5*j));
+        x[n[j]] = v[j];
+    }
+    int before = dft.transforms;
+    dft.change(n.data(), v.data(), m);
+
+    iterative_fft(x.data(), X.data(), N);
+    error = 0;
+    for(int k=0; k<N; k++) {
+        Complex d = X[k] - dft.spectrum()[k];
+        error = fmax(error, sqrt(d.r*d.r + d.i*d.i) / N);
+    }
+    return dft.transforms == before + 1;
+}
+
+
+/**************************************************************************************************
+ Main Function:
+ **************************************************************************************************/
+int main(int argc, char *argv[]) {
+
+    // Start by printing the table with time comparisons:
+    cout << "+---------+---------+---------+---------+---------+---------+---------+---------+" << endl;
+    cout << "|    N    |  Itera. | 1 samp. | 4 samp. |  Cross  |  Limit  |  Dense  | Error   |" << endl;
+    cout << "+---------+---------+---------+---------+---------+---------+---------+---------+" << endl;
+
+    // Try it with vectors with size ranging from 64 to 65536 samples:
+    for(int r=6; r<17; r+=2) {
+
+        // Compute the average execution time:
+        int n = (int) exp2(r);
+        float error, e;
+        float ftime = time_it(n, 1, true, e);
+        float time1 = time_it(n, 1, false, error);
+        float time4 = time_it(n, 4, false, e);
+        error = fmax(error, e);
+        int limit;
+        bool full = dense(n, limit, e);
+        error = fmax(error, e);
+        int cross = 1;                         // Changes where the update costs the same as the
+        while(cross < n && time_it(n, cross, false, e) < ftime)    //   FFT;
+            cross *= 2;
+
+        // Print the results:
+        cout << "| " << setw(7) <<     n << " ";
+        cout << "| " << setw(7) << setprecision(7) << ftime << " ";
+        cout << "| " << setw(7) << setprecision(7) << time1 << " ";
+        cout << "| " << setw(7) << setprecision(7) << time4 << " ";
+        cout << "| " << setw(7) << cross << " ";
+        cout << "| " << setw(7) << limit << " ";
+        cout << "| " << setw(7) << (full ? "yes" : "no") << " ";
+        cout << "| " << setw(7) << setprecision(7) << error << " |" << endl;
+    }
+
+    cout << "+---------+---------+---------+---------+---------+---------+---------+---------+" << endl;
+    return 0;
+}
@@ -0,0 +1,912 @@
+/**************************************************************************************************
+ * Fast Fourier Transform -- C++ Version
+ * This version implements a three-dimensional FFT distributed among processes, with pencils.
+ *
+ * José Alexandre Nalon
+ **************************************************************************************************
+ * This program needs a Linux box (or any POSIX system) to be compiled and run, since it creates
+ * processes and uses shared memory and sockets. Besides the math library, it must be linked with
+ * the threads library. In my box, I used the command:
+ *
+ * $ g++ -O3 -o distfft distfft.cpp -lm -lpthread
+ *
+ * It can be run with the command (remember to change permission to execute):
+ *
+ * $ ./distfft
+ *
+ * Obs.: The grid is split among P processes, arranged in Pr rows and Pc columns. Every process
+ *   starts with a pencil of the grid: a block of Pr-th of the x axis, a block of Pc-th of the y
+ *   axis, and the whole z axis, so it can compute the transforms along z. Then, the processes in
+ *   the same row exchange blocks (an all-to-all transpose), so every process has the whole y axis
+ *   and a block of z; after the transforms along y, the processes in the same column exchange
+ *   blocks, so every process has the whole x axis, and the last transforms are computed. The
+ *   result stays distributed in x pencils. Communication is overlapped with computation: the
+ *   lines are transformed in chunks, and the pieces of a chunk are sent by a separate thread
+ *   while the next chunk is computed. The transport is pluggable; here, there is a transport over
+ *   shared memory (a ring buffer for every pair of processes) and a transport over TCP sockets on
+ *   the loopback interface, so everything runs in a single box. The processes are created with
+ *   fork, and the table shows the time of the transform with a number of processes, for a grid
+ *   whose messages fit in the rings and for a larger one. The result is compared with the serial
+ *   transform, and one of its bins with the definition of the transform.
+ **************************************************************************************************/
+
+/**************************************************************************************************
+ Include necessary libraries:
+ **************************************************************************************************/
+#include <iostream>                            // Input and Output;
+#include <iomanip>                             // I/O Manipulation;
+#include <cmath>                               // Math Functions;
+#include <cstring>                             // Memory and strings;
+#include <chrono>                              // Time measurement;
+#include <vector>                              // Buffers;
+#include <deque>                               // Queue of messages;
+#include <atomic>                              // Ring buffers in shared memory;
+#include <thread>                              // Sender thread;
+#include <mutex>                               // Mutual exclusion;
+#include <condition_variable>                  // Synchronization;
+#include <pthread.h>                           // Barrier shared among processes;
+#include <unistd.h>                            // POSIX functions;
+#include <sys/mman.h>                          // Shared memory;
+#include <sys/socket.h>                        // Sockets;
+#include <sys/wait.h>                          // Waiting for the processes;
+#include <netinet/in.h>                        // Internet addresses;
+#include <netinet/tcp.h>                       // TCP options;
+#include <arpa/inet.h>                         // Address conversion;
+
+using namespace std;
+
+
+/**************************************************************************************************
+ Definitions:
+ **************************************************************************************************/
+#define REPEAT 5                               // Number of executions to compute average time;
+#define SIZE 64                                // Size of the grid in every direction;
+#define LARGE 128                              // Larger size, whose messages overflow the rings;
+#define RING 262144                            // Capacity of the ring buffers, in bytes;
+
+
+/**************************************************************************************************
+ Small class to operate with complex numbers:
+ **************************************************************************************************/
+class Complex {
+    public:
+        float r;                               // Real part;
+        float i;                               // Imaginary part;
+        Complex();                             // Constructors;
+        Complex(float re, float im);
+        void set(float re, float im);
+        void set(Complex c);
+        Complex operator+(Complex c);          // Addition (overload + operator);
+        Complex operator-(Complex c);          // Subtraction (overload - operator);
+        Complex operator*(Complex c);          // Product (overload * operator);
+        Complex operator*(float a);            // Product with a scalar;
+        Complex cexp();                        // Complex exponential;
+};
+
+Complex::Complex() {                           // Constructor;
+    r = 0.0;                                   // Real part;
+    i = 0.0;                                   // Imaginary part;
+}
+
+Complex::Complex(float re, float im) {         // Constructor;
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(float re, float im) {
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(Complex c) {
+    r = c.r;                                   // Real part;
+    i = c.i;                                   // Imaginary part;
+}
+
+Complex Complex::operator+(Complex c) {
+    return Complex(r + c.r, i + c.i);
+}
+
+Complex Complex::operator-(Complex c) {
+    return Complex(r - c.r, i - c.i);
+}
+
+Complex Complex::operator*(Complex c) {
+    return Complex(r*c.r - i*c.i, r*c.i + i*c.r);
+}
+
+Complex Complex::operator*(float a) {
+    return Complex(a*r, a*i);
+}
+
+Complex Complex::cexp() {
+    return Complex(exp(r)*cos(i), exp(r)*sin(i));
+}
+
+Complex cexpn(float a) {                       // Convenience function to compute the exponential;
+    return Complex(cos(a), sin(a));
+}
+
+
+/**************************************************************************************************
+ * Function: bit_reverse
+ *   Bit-reversed version of an integer number.
+ *
+ * Parameters:
+ *   k
+ *     The number to be bit-reversed;
+ *   r
+ *     The number of bits to take into consideration when reversing.
+ *
+ * Returns:
+ *   The number k, bit-reversed according to integers with r bits.
+ **************************************************************************************************/
+int bit_reverse(int k, int r)
+{
+    int l = 0;                                 // Accumulate the results;
+    for(int i=0; i<r; i++) {                   // Loop on every bit;
+        l = (l << 1) + (k & 1);                // Test less signficant bit and add;
+        k >>= 1;                               // Test next bit;
+    }
+    return l;
+}
+
+
+/**************************************************************************************************
+ Plans hold everything that depends only on the length of the transform:
+ **************************************************************************************************/
+struct Plan {
+    int N;                                     // Length of the transform;
+    vector<int> rev;                           // Bit-reversed indices;
+    vector<Complex> W;                         // Twiddle factors, W[n] = exp(-2 pi n/N);
+};
+
+
+/**************************************************************************************************
+ * Function: make_plan
+ *   Computes the plan for a given length.
+ *
+ * Parameters:
+ *   N
+ *     The length of the transform. It must be a power of two.
+ *
+ * Returns:
+ *   The plan.
+ **************************************************************************************************/
+Plan make_plan(int N)
+{
+    Plan plan;
+    plan.N = N;
+    int r = (int) floor(log2(N));              // Number of bits;
+    plan.rev.resize(N);
+    for(int k=0; k<N; k++)                     // Bit-reversed order;
+        plan.rev[k] = bit_reverse(k, r);
+    plan.W.resize(N/2 + 1);
+    for(int n=0; n<=N/2; n++)                  // Twiddle factors computed directly;
+        plan.W[n] = cexpn(-2*M_PI*n/N);
+    return plan;
+}
+
+
+/**************************************************************************************************
+ * Function: fft
+ *   Fast Fourier Transform using an iterative in-place decimation in time algorithm, with the
+ *   twiddle factors taken from the plan.
+ *
+ * Parameters:
+ *   plan
+ *     Plan for the length of the transform;
+ *   x
+ *     The vector of which the FFT will be computed;
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call, and it can't be the same as the input.
+ **************************************************************************************************/
+void fft(Plan &plan, Complex x[], Complex X[])
+{
+    int N = plan.N;
+    for(int k=0; k<N; k++)                     // Reorder the vector according to the
+        X[plan.rev[k]] = x[k];                 //   bit-reversed order;
+
+    for(int step=1; step<N; step<<=1) {
+        int stride = N / (2*step);             // Distance between twiddle factors in the table;
+        for(int l=0; l<N; l+=2*step)
+            for(int n=0; n<step; n++) {
+                int p = l + n;
+                int q = p + step;
+                Complex w = plan.W[n*stride] * X[q];
+                X[q] = X[p] - w;               // Recombine results;
+                X[p] = X[p] + w;
+            }
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: lines
+ *   Transforms, in place, a number of contiguous lines of the same length.
+ *
+ * Parameters:
+ *   plan
+ *     Plan for the length of the lines;
+ *   x
+ *     The first line;
+ *   count
+ *     Number of lines.
+ **************************************************************************************************/
+void lines(Plan &plan, Complex x[], long count)
+{
+    int N = plan.N;
+    vector<Complex> X(N);
+    for(long j=0; j<count; j++) {
+        fft(plan, x + j*N, X.data());
+        memcpy(x + j*N, X.data(), N * sizeof(Complex));
+    }
+}
+
+
+/**************************************************************************************************
+ Transports move bytes from one process to another, in order. Every transport is created before
+ the processes, and every process attaches to it with its rank:
+ **************************************************************************************************/
+class Transport {
+    public:
+        virtual ~Transport() { }
+        virtual void attach(int rank) = 0;
+        virtual void send(int to, const void *data, size_t n) = 0;
+        virtual void recv(int from, void *data, size_t n) = 0;
+};
+
+
+/**************************************************************************************************
+ Transport over shared memory. There is a ring buffer for every pair of processes, created before
+ the processes, with only one writer and one reader, so it doesn't need locks:
+ **************************************************************************************************/
+class ShmTransport : public Transport {
+    public:
+        ShmTransport(int P);
+        ~ShmTransport();
+        void attach(int rank);
+        void send(int to, const void *data, size_t n);
+        void recv(int from, void *data, size_t n);
+    private:
+        struct Ring {
+            atomic<size_t> head;               // Bytes written;
+            atomic<size_t> tail;               // Bytes read;
+            char data[RING];                   // Buffer;
+        };
+        int P;                                 // Number of processes;
+        int rank;                              // Rank of this process;
+        Ring *rings;                           // Ring from i to j is rings[i*P + j];
+};
+
+ShmTransport::ShmTransport(int P) {
+    this->P = P;
+    rank = -1;
+    rings = (Ring *) mmap(NULL, sizeof(Ring) * P * P, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    for(int j=0; j<P*P; j++)
+        new (&rings[j]) Ring();
+}
+
+ShmTransport::~ShmTransport() {
+    munmap(rings, sizeof(Ring) * P * P);
+}
+
+void ShmTransport::attach(int rank) {
+    this->rank = rank;
+}
+
+void ShmTransport::send(int to, const void *data, size_t n) {
+    Ring &r = rings[rank*P + to];
+    const char *p = (const char *) data;
+    while(n > 0) {
+        size_t h = r.head.load(memory_order_relaxed);
+        size_t room = RING - (h - r.tail.load(memory_order_acquire));
+        if(room == 0) {                        // Full, wait for the reader;
+            this_thread::yield();
+            continue;
+        }
+        size_t m = min(min(room, n), RING - h % RING);   // Up to the end of the buffer;
+        memcpy(r.data + h % RING, p, m);
+        r.head.store(h + m, memory_order_release);
+        p += m;
+        n -= m;
+    }
+}
+
+void ShmTransport::recv(int from, void *data, size_t n) {
+    Ring &r = rings[from*P + rank];
+    char *p = (char *) data;
+    while(n > 0) {
+        size_t t = r.tail.load(memory_order_relaxed);
+        size_t ready = r.head.load(memory_order_acquire) - t;
+        if(ready == 0) {                       // Empty, wait for the writer;
+            this_thread::yield();
+            continue;
+        }
+        size_t m = min(min(ready, n), RING - t % RING);
+        memcpy(p, r.data + t % RING, m);
+        r.tail.store(t + m, memory_order_release);
+        p += m;
+        n -= m;
+    }
+}
+
+
+/**************************************************************************************************
+ Transport over TCP, in the loopback interface. Every process has a listening socket, created
+ before the processes; when attaching, every process connects to the processes of lower rank and
+ accepts the connections of the processes of higher rank:
+ **************************************************************************************************/
+class TcpTransport : public Transport {
+    public:
+        TcpTransport(int P);
+        ~TcpTransport();
+        void attach(int rank);
+        void send(int to, const void *data, size_t n);
+        void recv(int from, void *data, size_t n);
+    private:
+        int P;                                 // Number of processes;
+        vector<int> listeners;                 // Listening sockets;
+        vector<int> ports;                     // Their ports;
+        vector<int> peers;                     // Connected sockets, by rank;
+};
+
+TcpTransport::TcpTransport(int P) {
+    this->P = P;
+    for(int j=0; j<P; j++) {                   // Listen on any free port;
+        int s = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in a;
+        memset(&a, 0, sizeof(a));
+        a.sin_family = AF_INET;
+        a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        a.sin_port = 0;
+        socklen_t len = sizeof(a);
+        if(s < 0 || ::bind(s, (sockaddr *) &a, sizeof(a)) < 0 || listen(s, P) < 0
+                 || getsockname(s, (sockaddr *) &a, &len) < 0) {
+            cerr << "Couldn't create the listening sockets." << endl;
+            exit(1);
+        }
+        listeners.push_back(s);
+        ports.push_back(ntohs(a.sin_port));
+    }
+}
+
+TcpTransport::~TcpTransport() {
+    for(int s : peers)
+        if(s >= 0)
+            close(s);
+    for(int s : listeners)
+        close(s);
+}
+
+void TcpTransport::attach(int rank) {
+    peers.assign(P, -1);
+    for(int j=0; j<rank; j++) {                // Connect to lower ranks, and say who we are;
+        int s = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in a;
+        memset(&a, 0, sizeof(a));
+        a.sin_family = AF_INET;
+        a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        a.sin_port = htons(ports[j]);
+        if(connect(s, (sockaddr *) &a, sizeof(a)) < 0) {
+            cerr << "Couldn't connect to process " << j << "." << endl;
+            exit(1);
+        }
+        peers[j] = s;
+        send(j, &rank, sizeof(int));
+    }
+    for(int j=rank+1; j<P; j++) {              // Accept higher ranks;
+        int s = accept(listeners[rank], NULL, NULL);
+        int who;
+        peers[rank] = s;                       // Temporarily, to read the rank;
+        recv(rank, &who, sizeof(int));
+        peers[who] = s;
+    }
+    peers[rank] = -1;
+    for(int s : peers)
+        if(s >= 0) {
+            int one = 1;
+            setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+}
+
+void TcpTransport::send(int to, const void *data, size_t n) {
+    const char *p = (const char *) data;
+    while(n > 0) {
+        ssize_t m = ::send(peers[to], p, n, MSG_NOSIGNAL);
+        if(m <= 0) {
+            cerr << "Connection lost." << endl;
+            exit(1);
+        }
+        p += m;
+        n -= m;
+    }
+}
+
+void TcpTransport::recv(int from, void *data, size_t n) {
+    char *p = (char *) data;
+    while(n > 0) {
+        ssize_t m = ::recv(peers[from], p, n, 0);
+        if(m <= 0) {
+            cerr << "Connection lost." << endl;
+            exit(1);
+        }
+        p += m;
+        n -= m;
+    }
+}
+
+
+/**************************************************************************************************
+ Sends messages in a separate thread, so the process can compute while the data is sent. The
+ buffers must not be changed until `flush` returns:
+ **************************************************************************************************/
+class Sender {
+    public:
+        Sender(Transport *t);
+        ~Sender();
+        void post(int to, const void *data, size_t n);
+        void flush();
+    private:
+        struct Message {
+            int to;                            // Destination;
+            const void *data;                  // Data;
+            size_t n;                          // Number of bytes;
+        };
+        Transport *transport;                  // Transport used;
+        deque<Message> queue;                  // Messages waiting;
+        int pending;                           // Messages not sent yet;
+        bool stop;                             // Indicates the thread must finish;
+        mutex lock;                            // Protects the queue;
+        condition_variable changed;            // Signals changes in the queue;
+        thread worker;                         // Thread that sends the messages;
+        void run();
+};
+
+Sender::Sender(Transport *t) {
+    transport = t;
+    pending = 0;
+    stop = false;
+    worker = thread(&Sender::run, this);
+}
+
+Sender::~Sender() {
+    {
+        lock_guard<mutex> guard(lock);
+        stop = true;
+    }
+    changed.notify_all();
+    worker.join();
+}
+
+void Sender::post(int to, const void *data, size_t n) {
+    {
+        lock_guard<mutex> guard(lock);
+        queue.push_back({ to, data, n });
+        pending++;
+    }
+    changed.notify_all();
+}
+
+void Sender::flush() {
+    unique_lock<mutex> guard(lock);
+    changed.wait(guard, [this]{ return pending == 0; });
+}
+
+void Sender::run() {
+    unique_lock<mutex> guard(lock);
+    while(true) {
+        changed.wait(guard, [this]{ return stop || !queue.empty(); });
+        if(queue.empty())
+            return;
+        Message m = queue.front();
+        queue.pop_front();
+        guard.unlock();
+        transport->send(m.to, m.data, m.n);    // Sent without holding the lock;
+        guard.lock();
+        pending--;
+        changed.notify_all();
+    }
+}
+
+
+/**************************************************************************************************
+ Class that computes the distributed transform in one process:
+ **************************************************************************************************/
+class PencilFFT {
+    public:
+        PencilFFT(int N, int Pr, int Pc, int rank, Transport *t, bool overlap);
+        void transform(Complex x[], Complex y[]);
+        static long local_size(int N, int Pr, int Pc);
+    private:
+        int N;                                 // Size of the grid;
+        int Pr, Pc;                            // Rows and columns of processes;
+        int r, c;                              // Position of this process;
+        bool overlap;                          // Send every chunk as soon as it is computed;
+        Plan plan;                             // Plan for the length N;
+        Transport *transport;                  // Transport;
+        Sender sender;                         // Thread that sends the messages;
+        vector<Complex> out, in, mid;          // Buffers;
+        void stage(Complex a[], int A, int B, vector<int> &group, int me, Complex b[]);
+};
+
+
+/**************************************************************************************************
+ * Method: PencilFFT::PencilFFT
+ *   Prepares the transform in one process.
+ *
+ * Parameters:
+ *   N
+ *     Size of the grid in every direction. It must be a power of two, divisible by Pr and Pc;
+ *   Pr, Pc
+ *     Number of rows and columns of processes;
+ *   rank
+ *     Rank of this process, from 0 to Pr*Pc - 1; the process is in row rank/Pc and column
+ *     rank%Pc;
+ *   t
+ *     Transport, already attached;
+ *   overlap
+ *     If true, every chunk of lines is sent as soon as it is transformed; if false, data is sent
+ *     only after every line is transformed.
+ **************************************************************************************************/
+PencilFFT::PencilFFT(int N, int Pr, int Pc, int rank, Transport *t, bool overlap)
+    : sender(t)
+{
+    this->N = N;
+    this->Pr = Pr;
+    this->Pc = Pc;
+    this->overlap = overlap;
+    r = rank / Pc;
+    c = rank % Pc;
+    transport = t;
+    plan = make_plan(N);
+    long size = local_size(N, Pr, Pc);
+    out.resize(size);
+    in.resize(size);
+    mid.resize(size);
+}
+
+
+/**************************************************************************************************
+ * Method: PencilFFT::local_size
+ *   Number of elements of the grid in every process.
+ **************************************************************************************************/
+long PencilFFT::local_size(int N, int Pr, int Pc)
+{
+    return (long) N/Pr * N/Pc * N;
+}
+
+
+/**************************************************************************************************
+ * Method: PencilFFT::stage
+ *   Transforms the lines of the local block and transposes it among a group of processes. The
+ *   block has A by B lines of length N (the element (a, b, l) is in (a*B + b)*N + l); the axis
+ *   of length N is split in G pieces, and the piece g goes to the process g of the group. The
+ *   result has the whole axis B of the group: the element (l', a, g*B + b) is the element
+ *   (a, b, g*N/G + l') of the process g.
+ *
+ *   The exchange is done in G - 1 steps: in the step s, this process sends to the process me + s
+ *   and receives from the process me - s (modulo G), which is sending to it in the same step.
+ *   With overlap, every chunk is exchanged in the same way, chunk after chunk. Since sends and
+ *   receives follow the same order in every process, a send that is blocked (by a full ring or
+ *   socket buffer) only waits for a receive of an earlier step, and they can't wait for each
+ *   other in a cycle, whatever the size of the messages.
+ *
+ * Parameters:
+ *   a
+ *     The local block. It is transformed in place;
+ *   A, B
+ *     Number of lines in both directions;
+ *   group
+ *     Ranks of the processes in the group;
+ *   me
+ *     Position of this process in the group;
+ *   b
+ *     Receives the transposed block.
+ **************************************************************************************************/
+void PencilFFT::stage(Complex a[], int A, int B, vector<int> &group, int me, Complex b[])
+{
+    int G = group.size(), L = N / G;
+    long piece = (long) B * L;                 // Elements of a chunk sent to every process;
+    Complex *pack = out.data();                // Pieces, in the order [g][a][b][l'];
+
+    for(int i=0; i<A; i++) {                   // Chunk by chunk;
+        lines(plan, a + (long) i*B*N, B);
+        for(int g=0; g<G; g++) {
+            Complex *p = pack + ((long) g*A + i) * piece;
+            for(int j=0; j<B; j++)
+                memcpy(p + (long) j*L, a + ((long) i*B + j)*N + g*L, L * sizeof(Complex));
+        }
+        if(overlap)
+            for(int s=1; s<G; s++) {           // Step s goes to me + s;
+                int g = (me + s) % G;
+                sender.post(group[g], pack + ((long) g*A + i) * piece, piece * sizeof(Complex));
+            }
+    }
+    if(!overlap)
+        for(int s=1; s<G; s++) {
+            int g = (me + s) % G;
+            sender.post(group[g], pack + (long) g*A*piece, A * piece * sizeof(Complex));
+        }
+
+    int chunks = overlap ? A : 1;              // Messages from every process;
+    int rows = A / chunks;                     // Lines in the direction A of a message;
+    for(int i=0; i<chunks; i++)
+        for(int s=0; s<G; s++) {               // Step s comes from me - s;
+            int g = (me - s + G) % G;
+            Complex *p = in.data() + (long) g*A*piece;
+            long offset = (long) i * rows * piece;
+            size_t n = rows * piece * sizeof(Complex);
+            if(g == me)
+                memcpy(p + offset, pack + (long) g*A*piece + offset, n);
+            else
+                transport->recv(group[g], p + offset, n);
+            for(int k=i*rows; k<(i+1)*rows; k++)   // Unpack;
+                for(int j=0; j<B; j++)
+                    for(int l=0; l<L; l++)
+                        b[((long) l*A + k)*B*G + g*B + j] = p[((long) k*B + j)*L + l];
+        }
+    sender.flush();
+}
+
+
+/**************************************************************************************************
+ * Method: PencilFFT::transform
+ *   Computes the distributed transform.
+ *
+ * Parameters:
+ *   x
+ *     The local z pencil: the element (x, y, z) of the grid, with x in the block r of Pr and y
+ *     in the block c of Pc, is in ((x % (N/Pr))*(N/Pc) + y % (N/Pc))*N + z;
+ *   y
+ *     Receives the local x pencil: the element (x, y, z) of the transform, with y in the block
+ *     r of Pr and z in the block c of Pc, is in ((y % (N/Pr))*(N/Pc) + z % (N/Pc))*N + x.
+ **************************************************************************************************/
+void PencilFFT::transform(Complex x[], Complex y[])
+{
+    vector<int> row, column;
+    for(int g=0; g<Pc; g++)                    // Processes in the same row;
+        row.push_back(r*Pc + g);
+    for(int g=0; g<Pr; g++)                    // Processes in the same column;
+        column.push_back(g*Pc + c);
+
+    memcpy(mid.data(), x, mid.size() * sizeof(Complex));
+    stage(mid.data(), N/Pr, N/Pc, row, c, y);  // Along z, then [z][x][y];
+    stage(y, N/Pc, N/Pr, column, r, mid.data());   // Along y, then [y][z][x];
+    lines(plan, mid.data(), (long) N/Pr * N/Pc);   // Along x;
+    memcpy(y, mid.data(), mid.size() * sizeof(Complex));
+}
+
+
+/**************************************************************************************************
+ * Function: serial_fft
+ *   Three-dimensional transform of the whole grid in one process, along z, y and x. It is used as
+ *   a reference.
+ *
+ * Parameters:
+ *   x
+ *     The grid, with the element (x, y, z) in (x*N + y)*N + z. It is transformed in place;
+ *   N
+ *     Size of the grid.
+ **************************************************************************************************/
+void serial_fft(Complex x[], int N)
+{
+    Plan plan = make_plan(N);
+    vector<Complex> v(N), V(N);
+    lines(plan, x, (long) N*N);                // Along z;
+    for(int a=0; a<N; a++)                     // Along y;
+        for(int k=0; k<N; k++) {
+            for(int b=0; b<N; b++)
+                v[b] = x[((long) a*N + b)*N + k];
+            fft(plan, v.data(), V.data());
+            for(int b=0; b<N; b++)
+                x[((long) a*N + b)*N + k] = V[b];
+        }
+    for(int a=0; a<N; a++)                     // Along x;
+        for(int k=0; k<N; k++) {
+            for(int b=0; b<N; b++)
+                v[b] = x[((long) b*N + a)*N + k];
+            fft(plan, v.data(), V.data());
+            for(int b=0; b<N; b++)
+                x[((long) b*N + a)*N + k] = V[b];
+        }
+}
+
+
+/**************************************************************************************************
+ * Function: sample
+ *   Element (x, y, z) of the test grid.
+ **************************************************************************************************/
+Complex sample(int x, int y, int z)
+{
+    return Complex(sin(0.1*x + 0.2*y) + cos(0.3*z), 0.01 * ((x*7919 + y*31 + z) % 101));
+}
+
+
+/**************************************************************************************************
+ * Function: direct_bin
+ *   One bin of the transform of the test grid, computed from the definition in double precision.
+ *   The serial transform uses the same plan and the same order of operations as the processes,
+ *   so this checks both.
+ *
+ * Parameters:
+ *   N
+ *     Size of the grid;
+ *   kx, ky, kz
+ *     The bin.
+ *
+ * Returns:
+ *   The value of the bin.
+ **************************************************************************************************/
+Complex direct_bin(int N, int kx, int ky, int kz)
+{
+    double sr = 0, si = 0;
+    for(int x=0; x<N; x++)
+        for(int y=0; y<N; y++)
+            for(int z=0; z<N; z++) {
+                Complex v = sample(x, y, z);
+                double a = -2*M_PI * (((long) kx*x + ky*y + kz*z) % N) / N;
+                sr += v.r * cos(a) - v.i * sin(a);
+                si += v.r * sin(a) + v.i * cos(a);
+            }
+    return Complex(sr, si);
+}
+
+
+/**************************************************************************************************
+ * Function: run
+ *   Creates the processes, computes the distributed transform in all of them and collects the
+ *   results in shared memory.
+ *
+ * Parameters:
+ *   N
+ *     Size of the grid;
+ *   P
+ *     Number of processes;
+ *   tcp
+ *     If true, uses the TCP transport; if false, uses shared memory;
+ *   overlap
+ *     If true, communication is overlapped with computation;
+ *   grid
+ *     Receives the transform of the whole grid, with the element (x, y, z) in (x*N + y)*N + z.
+ *
+ * Returns:
+ *   The average time of the transform, measured between barriers.
+ **************************************************************************************************/
+float run(int N, int P, bool tcp, bool overlap, Complex grid[])
+{
+    int Pr = 1;
+    while(Pr * Pr * 4 <= P)                    // As square as possible;
+        Pr *= 2;
+    int Pc = P / Pr;
+
+    struct Shared {                            // Barrier and result of the time measurement;
+        pthread_barrier_t barrier;
+        float time;
+    };
+    Shared *shared = (Shared *) mmap(NULL, sizeof(Shared), PROT_READ | PROT_WRITE,
+                                     MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    pthread_barrierattr_t attr;
+    pthread_barrierattr_init(&attr);
+    pthread_barrierattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_barrier_init(&shared->barrier, &attr, P);
+    long bytes = (long) N*N*N * sizeof(Complex);
+    Complex *result = (Complex *) mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                                       MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    Transport *transport = tcp ? (Transport *) new TcpTransport(P) : new ShmTransport(P);
+
+    vector<pid_t> children;
+    for(int rank=0; rank<P; rank++) {
+        pid_t pid = fork();
+        if(pid != 0) {
+            children.push_back(pid);
+            continue;
+        }
+
+        transport->attach(rank);               // Child process;
+        int r = rank / Pc, c = rank % Pc, X = N/Pr, Y = N/Pc;
+        long size = PencilFFT::local_size(N, Pr, Pc);
+        vector<Complex> x(size), y(size);
+        for(int i=0; i<X; i++)                 // Local z pencil;
+            for(int j=0; j<Y; j++)
+                for(int k=0; k<N; k++)
+                    x[((long) i*Y + j)*N + k] = sample(r*X + i, c*Y + j, k);
+        {
+            PencilFFT pfft(N, Pr, Pc, rank, transport, overlap);
+            pfft.transform(x.data(), y.data());    // Warm up;
+            pthread_barrier_wait(&shared->barrier);
+            auto t0 = chrono::steady_clock::now();
+            for(int j=0; j<REPEAT; j++)
+                pfft.transform(x.data(), y.data());
+            pthread_barrier_wait(&shared->barrier);
+            auto t1 = chrono::steady_clock::now();
+            if(rank == 0)
+                shared->time = chrono::duration<float>(t1 - t0).count() / REPEAT;
+        }
+        for(int j=0; j<N/Pr; j++)              // Local x pencil, to the whole grid;
+            for(int k=0; k<Y; k++)
+                for(int i=0; i<N; i++)
+                    result[((long) i*N + r*(N/Pr) + j)*N + c*Y + k] = y[((long) j*Y + k)*N + i];
+        delete transport;
+        _exit(0);
+    }
+
+    for(pid_t pid : children)
+        waitpid(pid, NULL, 0);
+    float time = shared->time;
+    memcpy(grid, result, bytes);
+    delete transport;
+    pthread_barrier_destroy(&shared->barrier);
+    munmap(result, bytes);
+    munmap(shared, sizeof(Shared));
+    return time;
+}
+
+
+/**************************************************************************************************
+ Main Function:
+ **************************************************************************************************/
+int main(int argc, char *argv[]) {
+
+    // Start by printing the table with time comparisons:
+    cout << "+---------+---------+---------+---------+---------+---------+---------+---------+"
+         << "---------+" << endl;
+    cout << "|    N    |    P    | Serial  |   Shm   | Overlap |   TCP   | Overlap | Error   |"
+         << "   DFT   |" << endl;
+    cout << "+---------+---------+---------+---------+---------+---------+---------+---------+"
+         << "---------+" << endl;
+
+    // Try it with a small grid and with a grid whose messages don't fit in the rings:
+    for(int N=SIZE; N<=LARGE; N*=2) {
+
+        long M = (long) N*N*N;
+        vector<Complex> ref(M), grid(M);
+        for(int x=0; x<N; x++)                 // Reference transform;
+            for(int y=0; y<N; y++)
+                for(int z=0; z<N; z++)
+                    ref[((long) x*N + y)*N + z] = sample(x, y, z);
+        auto t0 = chrono::steady_clock::now();
+        serial_fft(ref.data(), N);
+        auto t1 = chrono::steady_clock::now();
+        float serial = chrono::duration<float>(t1 - t0).count();
+        int kx = 1, ky = 2, kz = 3;            // Bin checked against the definition;
+        long bin = ((long) kx*N + ky)*N + kz;
+        Complex d = direct_bin(N, kx, ky, kz);
+        float norm = sqrt(d.r*d.r + d.i*d.i);
+
+        // Try it with the number of processes ranging from 1 to 16:
+        for(int r=0; r<5; r++) {
+
+            // Compute the average execution time and the errors against the serial transform
+            // and against the definition:
+            int P = (int) exp2(r);
+            float times[4], error = 0, dft = 0;
+            for(int i=0; i<4; i++) {
+                times[i] = run(N, P, i >= 2, i % 2 == 1, grid.data());
+                for(long j=0; j<M; j++) {
+                    Complex e = grid[j] - ref[j];
+                    error = fmax(error, sqrt(e.r*e.r + e.i*e.i));
+                }
+                Complex e = grid[bin] - d;
+                dft = fmax(dft, sqrt(e.r*e.r + e.i*e.i) / norm);
+            }
+
+            // Print the results:
+            cout << "| " << setw(7) <<     N << " ";
+            cout << "| " << setw(7) <<     P << " ";
+            cout << "| " << setw(7) << setprecision(7) << serial << " ";
+            cout << "| " << setw(7) << setprecision(7) << times[0] << " ";
+            cout << "| " << setw(7) << setprecision(7) << times[1] << " ";
+            cout << "| " << setw(7) << setprecision(7) << times[2] << " ";
+            cout << "| " << setw(7) << setprecision(7) << times[3] << " ";
+            cout << "| " << setw(7) << setprecision(7) << error << " ";
+            cout << "| " << setw(7) << setprecision(7) << dft << " |" << endl;
+        }
+    }
+
+    cout << "+---------+---------+---------+---------+---------+---------+---------+---------+"
+         << "---------+" << endl;
+    return 0;
+}
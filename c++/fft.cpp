@@ -5,9 +5,11 @@
  * José Alexandre Nalon
  **************************************************************************************************
  * This program doesn't need much to be compiled and run. It can be done, as far as I know, with
- * any C++ compiler, just remember to link the math library. In my box, I used the command:
+ * any C++ compiler, just remember to link the math library. Optimizations should be turned on, so
+ * the compiler can vectorize the butterflies of the high radix kernels and keep them in registers.
+ * In my box, I used the command:
  *
- * $ g++ -o fft fft.cpp -lm
+ * $ g++ -O3 -march=native -o fft fft.cpp -lm
  *
  * It can be run with the command (remember to change permission to execute):
  *
@@ -28,6 +30,8 @@
 #include <array>                               // Deals with arrays;
 #include <cmath>                               // Math Functions;
 #include <chrono>                              // Time measurement;
+#include <map>                                 // Cache of plans;
+#include <vector>                              // Plans;
 
 using namespace std;
 
@@ -36,6 +40,9 @@ using namespace std;
  Definitions:
  **************************************************************************************************/
 #define REPEAT 500                             // Number of executions to compute average time;
+#define BLOCK 4096                             // Size of the blocks that fit in the cache;
+#define TANGENT 32768                          // Largest length computed with the tangent FFT;
+#define LANES 16                               // Butterflies of a radix stage computed together;
 
 
 /**************************************************************************************************
@@ -137,15 +144,19 @@ void complex_show(Complex x[], int n)
  **************************************************************************************************/
 float time_it(void (*f)(Complex *, Complex *, int), int size, int repeat)
 {
-    Complex x[1024], X[1024];                  // Vectors will be at most 1024 samples;
+    Complex *x = new Complex[size];            // Vectors can be larger than the cache;
+    Complex *X = new Complex[size];
 
     for(int j=0; j<size; j++)                  // Initialize the vector;
         x[j] = Complex(j, 0);
+    (*f)(x, X, size);                          // Plans and tables are computed in the first call;
     auto t0 = chrono::steady_clock::now();     // Start counting time;
     for(int j=0; j<repeat; j++)
         (*f)(x, X, size);
     auto t1 = chrono::steady_clock::now();     // End of time measuring;
-    return chrono::duration_cast<chrono::seconds>(t1 - t0).count() / (float) repeat;
+    delete[] x;
+    delete[] X;
+    return chrono::duration<float>(t1 - t0).count() / (float) repeat;
 }
 
 
@@ -298,15 +309,584 @@ void iterative_fft(Complex x[], Complex X[], int N)
 }
 
 
+/**************************************************************************************************
+ * Auxiliary function: stage
+ *   Computes one stage of butterflies of the iterative algorithm in a range of the vector, in the
+ *   same way as iterative_fft, with the same results. The twiddle factor is computed only once
+ *   for the stage, not for every group of butterflies.
+ *
+ * Parameters:
+ *   X
+ *     The vector being transformed, in place;
+ *   first, last
+ *     The range of the vector. Its length must be a multiple of 2*step;
+ *   step
+ *     Distance between the elements combined in the butterflies.
+ **************************************************************************************************/
+void stage(Complex X[], int first, int last, int step)
+{
+    Complex W = cexpn(-M_PI/step);             // Twiddle factors;
+    for(int l=first; l<last; l+=2*step) {
+        Complex Wkn = Complex(1, 0);
+        for(int n=0; n<step; n++) {
+            int p = l + n;
+            int q = p + step;
+            X[q] = X[p] - Wkn * X[q];          // Recombine results;
+            X[p] = X[p]*2 - X[q];
+            Wkn = Wkn * W;                     // Update twiddle factors;
+        }
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: blocked_fft
+ *   Fast Fourier Transform using the same iterative in-place algorithm, but with the stages
+ *   executed depth first. The first stages only combine elements inside blocks of BLOCK elements,
+ *   so all of them are computed in a block while it is in the cache, before moving to the next
+ *   block. Only the remaining stages, that combine elements of different blocks, sweep the whole
+ *   vector. The results are the same, in the same order, as those of iterative_fft.
+ *
+ * Parameters:
+ *   x
+ *     The vector of which the FFT will be computed. This should always be called with a vector of
+ *     a power of two length, or it will fail. No checks on this are made.
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call;
+ *   N
+ *     The number of elements in the vector.
+ **************************************************************************************************/
+void blocked_fft(Complex x[], Complex X[], int N)
+{
+    int r = (int) floor(log2(N));              // Number of bits;
+    for(int k=0; k<N; k++) {
+        int l = bit_reverse(k, r);             // Reorder the vector according to the
+        X[l] = x[k];                           //   bit-reversed order;
+    }
+
+    int B = (N < BLOCK) ? N : BLOCK;           // Size of the blocks;
+    for(int b=0; b<N; b+=B)                    // Stages inside every block;
+        for(int step=1; step<B; step<<=1)
+            stage(X, b, b+B, step);
+    for(int step=B; step<N; step<<=1)          // Stages across blocks;
+        stage(X, 0, N, step);
+}
+
+
+/**************************************************************************************************
+ Plans for the high radix transform. They hold the twiddle factors and the radices of the stages,
+ and are kept in a cache:
+ **************************************************************************************************/
+struct Plan {
+    int N;                                     // Length of the transform;
+    vector<int> bits;                          // Bits of the radix of every stage;
+    vector<float> wr, wi;                      // Twiddle factors of the radix stages, in order;
+    bool tangent;                              // Use the tangent FFT instead of the radix stages;
+};
+
+map<int, Plan *> plans;                        // Cache of plans, indexed by the length;
+
+
+/**************************************************************************************************
+ * Function: largest_radix
+ *   Chooses the largest radix according to the vector registers of the processor. The radix stages
+ *   compute LANES butterflies at a time, one in every lane of the registers: with AVX-512 there
+ *   are 32 registers, enough for the real and imaginary parts of the 16 elements of a radix-16
+ *   butterfly; with AVX2 there are 16, and a radix-8 butterfly fits. Other processors use radix-4.
+ *
+ * Returns:
+ *   The number of bits of the largest radix.
+ **************************************************************************************************/
+int largest_radix()
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f"))
+        return 4;
+    if(__builtin_cpu_supports("avx2"))
+        return 3;
+#endif
+    return 2;
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: twiddles
+ *   Computes the twiddle factors of a plan, used by the radix stages. Every stage has its own
+ *   table, with the factors of the radix-2 stages inside the butterfly one after the other: the
+ *   stage that combines transforms of length H inside a butterfly of a stage that combines
+ *   transforms of length L uses, for every t < H, the factors exp(-2 pi (n + t L)/(2 H L)) with
+ *   n < L, contiguous in n, so the butterflies of consecutive n can be computed together. Real
+ *   and imaginary parts are kept in separate tables.
+ *
+ * Parameters:
+ *   plan
+ *     The plan.
+ **************************************************************************************************/
+void twiddles(Plan *plan)
+{
+    plan->wr.clear();
+    plan->wi.clear();
+    int L = 1;                                 // Length of the transforms already computed;
+    for(int m: plan->bits) {
+        for(int H=1; H<(1 << m); H<<=1)
+            for(int t=0; t<H; t++)
+                for(int n=0; n<L; n++) {       // Twiddle factors computed directly;
+                    double a = -M_PI * (n + t*L) / (H*L);
+                    plan->wr.push_back(cos(a));
+                    plan->wi.push_back(sin(a));
+                }
+        L <<= m;
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: get_plan
+ *   Looks for a plan in the cache, creating it if it doesn't exist. Every stage uses the largest
+ *   radix, except the first, that takes the bits that remain. Lengths up to TANGENT, where the
+ *   time is spent in the operations more than in the memory, are computed with the tangent FFT,
+ *   that has its own tables; the twiddle factors of the radix stages are computed only for the
+ *   other lengths, or when radix_fft is called directly.
+ *
+ * Parameters:
+ *   N
+ *     The length of the transform. It must be a power of two.
+ *
+ * Returns:
+ *   A pointer to the plan. It is owned by the cache and must not be released.
+ **************************************************************************************************/
+Plan *get_plan(int N)
+{
+    auto p = plans.find(N);
+    if(p != plans.end())                       // Plan was already computed;
+        return p->second;
+
+    Plan *plan = new Plan;
+    plan->N = N;
+    plan->tangent = (N <= TANGENT);
+    int r = (int) floor(log2(N));              // Number of bits;
+    int m = largest_radix();
+    if(r % m > 0)                              // Smaller radix in the first stage;
+        plan->bits.push_back(r % m);
+    for(int k=0; k<r/m; k++)
+        plan->bits.push_back(m);
+    if(!plan->tangent)
+        twiddles(plan);
+    plans[N] = plan;
+    return plan;
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: radix_pass
+ *   Computes, in registers, the radix-2 stages of V butterflies of R elements, starting with the
+ *   stage that combines transforms of length H. Every call does one stage and calls the next one,
+ *   so the number of iterations of every loop is known when the template is instantiated: the
+ *   loops over the butterfly are unrolled completely, and the loop over the V butterflies, that
+ *   have contiguous twiddle factors, is vectorized.
+ *
+ * Parameters:
+ *   ar, ai
+ *     Real and imaginary parts of the elements of the butterflies, element j of butterfly v in
+ *     ar[j][v] and ai[j][v];
+ *   wr, wi
+ *     Twiddle factors of the first butterfly, in the table of the stage;
+ *   L
+ *     The length of the transforms that are combined by the butterflies.
+ **************************************************************************************************/
+template<int R, int H, int V>
+inline void radix_pass(float ar[][V], float ai[][V], const float wr[], const float wi[], int L)
+{
+    if constexpr (H < R) {
+        for(int g=0; g<R; g+=2*H)
+            for(int t=0; t<H; t++) {
+                const float *cr = wr + (H - 1 + t) * L;     // Factors of this radix-2 stage;
+                const float *ci = wi + (H - 1 + t) * L;
+                float *pr = ar[g+t], *pi = ai[g+t], *qr = ar[g+t+H], *qi = ai[g+t+H];
+                for(int v=0; v<V; v++) {
+                    float xr = cr[v]*qr[v] - ci[v]*qi[v];
+                    float xi = cr[v]*qi[v] + ci[v]*qr[v];
+                    qr[v] = pr[v] - xr;        // Recombine results;
+                    qi[v] = pi[v] - xi;
+                    pr[v] = pr[v] + xr;
+                    pi[v] = pi[v] + xi;
+                }
+            }
+        radix_pass<R, 2*H, V>(ar, ai, wr, wi, L);
+    }
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: radix_stage
+ *   Computes one stage of radix 2^M, that combines 2^M transforms of length L into transforms of
+ *   length 2^M L. It does the same as M stages of the radix-2 algorithm, but the 2^M elements of
+ *   every butterfly are loaded once, combined in registers and stored once. The butterflies are
+ *   computed V at a time, with consecutive n, so their elements are contiguous in the vector.
+ *
+ * Parameters:
+ *   X
+ *     The vector being transformed, in place;
+ *   N
+ *     The number of elements in the vector;
+ *   L
+ *     The length of the transforms that are combined. It must be a multiple of V;
+ *   wr, wi
+ *     Table of twiddle factors of the stage.
+ **************************************************************************************************/
+template<int M, int V>
+void radix_stage(Complex X[], int N, int L, const float wr[], const float wi[])
+{
+    const int R = 1 << M;
+    for(int l=0; l<N; l+=R*L)
+        for(int n=0; n<L; n+=V) {
+            float ar[R][V], ai[R][V];
+            for(int j=0; j<R; j++)             // Load the butterflies, splitting the parts;
+                for(int v=0; v<V; v++) {
+                    ar[j][v] = X[l + n + v + j*L].r;
+                    ai[j][v] = X[l + n + v + j*L].i;
+                }
+            radix_pass<R, 1, V>(ar, ai, wr + n, wi + n, L);
+            for(int j=0; j<R; j++)             // Store the butterflies;
+                for(int v=0; v<V; v++)
+                    X[l + n + v + j*L] = Complex(ar[j][v], ai[j][v]);
+        }
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: radix_dispatch
+ *   Calls the radix stage with M bits, computing LANES butterflies at a time when the transforms
+ *   that are combined are long enough, and one at a time otherwise.
+ **************************************************************************************************/
+template<int M>
+void radix_dispatch(Complex X[], int N, int L, const float wr[], const float wi[])
+{
+    if(L % LANES == 0)
+        radix_stage<M, LANES>(X, N, L, wr, wi);
+    else
+        radix_stage<M, 1>(X, N, L, wr, wi);
+}
+
+
+/**************************************************************************************************
+ * Function: radix_fft
+ *   Fast Fourier Transform using an iterative in-place decimation in time algorithm, with the
+ *   radix of every stage chosen by the plan. With radix 2^M, the vector is swept log_2(N)/M times
+ *   instead of log_2(N).
+ *
+ * Parameters:
+ *   x
+ *     The vector of which the FFT will be computed. This should always be called with a vector of
+ *     a power of two length, or it will fail. No checks on this are made.
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call;
+ *   N
+ *     The number of elements in the vector.
+ **************************************************************************************************/
+void radix_fft(Complex x[], Complex X[], int N)
+{
+    Plan *plan = get_plan(N);
+    if(plan->wr.empty())                       // Plan made for the tangent FFT;
+        twiddles(plan);
+    int r = (int) floor(log2(N));              // Number of bits;
+    for(int k=0; k<N; k++) {
+        int l = bit_reverse(k, r);             // Reorder the vector according to the
+        X[l] = x[k];                           //   bit-reversed order;
+    }
+
+    int L = 1;                                 // Length of the transforms already computed;
+    const float *wr = plan->wr.data(), *wi = plan->wi.data();
+    for(int m: plan->bits) {
+        switch(m) {
+            case 1: radix_dispatch<1>(X, N, L, wr, wi); break;
+            case 2: radix_dispatch<2>(X, N, L, wr, wi); break;
+            case 3: radix_dispatch<3>(X, N, L, wr, wi); break;
+            case 4: radix_dispatch<4>(X, N, L, wr, wi); break;
+        }
+        wr += ((1 << m) - 1) * L;              // Tables of the next stage;
+        wi += ((1 << m) - 1) * L;
+        L <<= m;
+    }
+}
+
+
+/**************************************************************************************************
+ Tables of the tangent FFT. The transform is computed by four mutually recursive functions: one
+ computes the DFT, and the others compute the DFT divided by the scale factors s(M, k), with M
+ equal to N, 2N or 4N. The factors are defined by s(M, k) = 1 if M <= 4, and otherwise
+
+     s(M, k) = s(M/4, k) cos(2 pi k/M), if k mod M/4 <= M/8,
+     s(M, k) = s(M/4, k) sin(2 pi k/M), if k mod M/4 > M/8,
+
+ with k taken modulo M/4 in the right side. Divided by them, the twiddle factors of the scaled
+ transforms become 1 - i tan(2 pi k/N) or cot(2 pi k/N) - i, and a product costs 2 real
+ multiplications instead of 4. There is one level for every bit of the length:
+ **************************************************************************************************/
+struct Level {
+    vector<float> wr, wi;                      // Twiddle factors, W^k s(N/4, k) (unscaled);
+    vector<float> t;                           // tan(2 pi k/N) or cot(2 pi k/N) (scaled);
+    vector<float> r2[2], r4[4];                // Ratios of scale factors of the outputs;
+};
+
+vector<Level> levels;                          // Levels computed so far, indexed by log_2(N);
+
+
+/**************************************************************************************************
+ * Auxiliary function: scale
+ *   Scale factor s(M, k) of the tangent FFT, computed in double precision.
+ *
+ * Parameters:
+ *   M
+ *     The length associated to the factor;
+ *   k
+ *     The index of the factor.
+ *
+ * Returns:
+ *   The factor s(M, k).
+ **************************************************************************************************/
+double scale(int M, int k)
+{
+    if(M <= 4)
+        return 1;
+    k = k % (M/4);
+    double a = 2*M_PI*k / M;
+    return scale(M/4, k) * (k <= M/8 ? cos(a) : sin(a));
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: get_levels
+ *   Computes the tables of the tangent FFT up to the given length, if they were not computed yet.
+ *
+ * Parameters:
+ *   N
+ *     The length of the transform. It must be a power of two.
+ **************************************************************************************************/
+void get_levels(int N)
+{
+    int r = (int) floor(log2(N));              // Number of bits;
+    for(int l=levels.size(); l<=r; l++) {
+        levels.push_back(Level());
+        Level &L = levels.back();
+        int M = 1 << l, Q = M / 4;
+        for(int k=0; k<Q; k++) {
+            double a = 2*M_PI*k / M;
+            L.wr.push_back(cos(a) * scale(Q, k));
+            L.wi.push_back(-sin(a) * scale(Q, k));
+            L.t.push_back(k <= M/8 ? tan(a) : 1/tan(a));
+            for(int j=0; j<2; j++)
+                L.r2[j].push_back(scale(M, k) / scale(2*M, k + j*Q));
+            for(int j=0; j<4; j++)
+                L.r4[j].push_back(scale(M, k) / scale(4*M, k + j*Q));
+        }
+    }
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: tangent
+ *   One call of the tangent FFT. The samples are taken from the input vector with a given offset
+ *   and stride, modulo its length; the even samples give a transform of length N/2, and the
+ *   samples 4n+1 and 4n-1 give two scaled transforms of length N/4, that are combined with
+ *   conjugate twiddle factors.
+ *
+ * Parameters:
+ *   K
+ *     Kind of the transform: 0 computes the DFT, and 1, 2 and 3 compute the DFT divided by s(N, k),
+ *     s(2N, k) and s(4N, k);
+ *   x
+ *     The input vector;
+ *   a
+ *     The index of the first sample;
+ *   s
+ *     The distance between samples;
+ *   mask
+ *     The length of the input vector, minus one;
+ *   X
+ *     The vector that will receive the results;
+ *   N
+ *     The length of this transform;
+ *   r
+ *     The number of bits of N.
+ **************************************************************************************************/
+template<int K>
+void tangent(Complex x[], int a, int s, int mask, Complex X[], int N, int r)
+{
+    if(N == 1) {
+        X[0] = x[a];
+        return;
+    }
+    if(N == 2) {
+        Complex p = x[a], q = x[(a + s) & mask];
+        X[0] = p + q;
+        X[1] = p - q;
+        if(K == 3)                             // s(8, 1) = cos(pi/4), the others are 1;
+            X[1] = X[1] * (float) M_SQRT2;
+        return;
+    }
+
+    const int U = (K == 0) ? 0 : (K == 2) ? 3 : 2; // Kind of the half length transform;
+    int Q = N / 4;
+    tangent<U>(x, a, 2*s, mask, X, N/2, r-1);
+    tangent<1>(x, (a + s) & mask, 4*s, mask, X + 2*Q, Q, r-2);
+    tangent<1>(x, (a - s) & mask, 4*s, mask, X + 3*Q, Q, r-2);
+
+    Level &L = levels[r];
+    for(int k=0; k<Q; k++) {
+        Complex z = X[k + 2*Q], y = X[k + 3*Q];
+        float pr = z.r + y.r, pi = z.i + y.i;  // Sum and difference of the scaled transforms;
+        float mr = z.r - y.r, mi = z.i - y.i;
+        float ar, ai, br, bi;                  // W^k z + W^-k y and W^k z - W^-k y;
+        if(k == 0) {                           // Twiddle factor 1 (and tan 0 = 0);
+            ar = pr;
+            ai = pi;
+            br = mr;
+            bi = mi;
+        } else if(K == 0 && k == N/8) {        // Twiddle factor (1 - i)/sqrt(2);
+            ar = (pr + mi) * (float) M_SQRT1_2;
+            ai = (pi - mr) * (float) M_SQRT1_2;
+            br = (mr + pi) * (float) M_SQRT1_2;
+            bi = (mi - pr) * (float) M_SQRT1_2;
+        } else if(K == 0) {
+            float wr = L.wr[k], wi = L.wi[k];
+            ar = wr*pr - wi*mi;
+            ai = wr*pi + wi*mr;
+            br = wr*mr - wi*pi;
+            bi = wr*mi + wi*pr;
+        } else if(k == N/8) {                  // Twiddle factor 1 - i, since tan(pi/4) = 1;
+            ar = pr + mi;
+            ai = pi - mr;
+            br = mr + pi;
+            bi = mi - pr;
+        } else if(k < N/8) {                   // Twiddle factor 1 - i tan;
+            float t = L.t[k];
+            ar = pr + t*mi;
+            ai = pi - t*mr;
+            br = mr + t*pi;
+            bi = mi - t*pr;
+        } else {                               // Twiddle factor cot - i;
+            float t = L.t[k];
+            ar = t*pr + mi;
+            ai = t*pi - mr;
+            br = t*mr + pi;
+            bi = t*mi - pr;
+        }
+        if(K == 2) {                           // Outputs divided by s(2N, k), that is 1
+            if(k > 0) {                        //   for k = 0;
+                ar *= L.r2[0][k]; ai *= L.r2[0][k];
+            }
+            br *= L.r2[1][k]; bi *= L.r2[1][k];
+        }
+        Complex u = X[k], v = X[k + Q];
+        X[k] = Complex(u.r + ar, u.i + ai);
+        X[k + Q] = Complex(v.r + bi, v.i - br);
+        X[k + 2*Q] = Complex(u.r - ar, u.i - ai);
+        X[k + 3*Q] = Complex(v.r - bi, v.i + br);
+        if(K == 3)                             // Outputs divided by s(4N, k), that is 1
+            for(int j=(k == 0); j<4; j++)      //   for k = 0;
+                X[k + j*Q] = X[k + j*Q] * L.r4[j][k];
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: tangent_fft
+ *   Fast Fourier Transform using the tangent FFT, a modified split radix algorithm (by Johnson and
+ *   Frigo, and by Van Buskirk) that computes the transform with about 34/9 N log_2(N) real
+ *   operations, instead of the 4 N log_2(N) of the split radix and 5 N log_2(N) of the radix-2.
+ *   The savings come from the scaled transforms, so it pays where the time is spent in the
+ *   operations, not in the memory (that is, for small and medium lengths).
+ *
+ * Parameters:
+ *   x
+ *     The vector of which the FFT will be computed. This should always be called with a vector of
+ *     a power of two length, or it will fail. No checks on this are made.
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call;
+ *   N
+ *     The number of elements in the vector.
+ **************************************************************************************************/
+void tangent_fft(Complex x[], Complex X[], int N)
+{
+    get_levels(N);
+    tangent<0>(x, 0, 1, N - 1, X, N, (int) floor(log2(N)));
+}
+
+
+/**************************************************************************************************
+ * Function: tangent_flops
+ *   Counts the real operations (additions and multiplications) of the tangent FFT, as it is
+ *   implemented above. The butterflies with k = 0 and k = N/8 have trivial twiddle factors and
+ *   cost less than the others; with them, the count is the same of the split radix up to N = 32,
+ *   and smaller from N = 64 on.
+ *
+ * Parameters:
+ *   N
+ *     The length of the transform;
+ *   K
+ *     Kind of the transform, as in the tangent function.
+ *
+ * Returns:
+ *   The number of real operations.
+ **************************************************************************************************/
+long tangent_flops(int N, int K=0)
+{
+    if(N == 1)
+        return 0;
+    if(N == 2)
+        return (K == 3) ? 6 : 4;
+    const int U[] = { 0, 2, 3, 2 };            // Kind of the half length transform;
+    const int ops[] = { 24, 20, 24, 28 };      // Operations for every other k;
+    const int first[] = { 12, 12, 14, 18 };    // Operations for k = 0;
+    const int middle[] = { 20, 16, 20, 24 };   // Operations for k = N/8;
+    long f = tangent_flops(N/2, U[K]) + 2*tangent_flops(N/4, 1) + first[K];
+    if(N >= 8)
+        f = f + middle[K] + (long) ops[K] * (N/4 - 2);
+    return f;
+}
+
+
+/**************************************************************************************************
+ * Function: planned_fft
+ *   Fast Fourier Transform with the algorithm chosen by the plan: the tangent FFT for lengths up
+ *   to TANGENT, and the high radix transform for longer vectors.
+ *
+ * Parameters:
+ *   x
+ *     The vector of which the FFT will be computed. This should always be called with a vector of
+ *     a power of two length, or it will fail. No checks on this are made.
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call;
+ *   N
+ *     The number of elements in the vector.
+ **************************************************************************************************/
+void planned_fft(Complex x[], Complex X[], int N)
+{
+    if(get_plan(N)->tangent)
+        tangent_fft(x, X, N);
+    else
+        radix_fft(x, X, N);
+}
+
+
 /**************************************************************************************************
  Main Function:
  **************************************************************************************************/
 int main(int argc, char *argv[]) {
 
     // Start by printing the table with time comparisons:
-    cout << "+---------+---------+---------+---------+---------+---------+" << endl;
-    cout << "|    N    |   N^2   | N logN  | Direct  | Recurs. | Itera.  |" << endl;
-    cout << "+---------+---------+---------+---------+---------+---------+" << endl;
+    cout << "+---------+---------+---------+---------+---------+"
+         << "---------+---------+---------+---------+" << endl;
+    cout << "|    N    |   N^2   | N logN  |  Split  |  Flops  "
+         << "| Direct  | Recurs. | Itera.  | Planned |" << endl;
+    cout << "+---------+---------+---------+---------+---------+"
+         << "---------+---------+---------+---------+" << endl;
 
     // Try it with vectors with size ranging from 32 to 1024 samples:
     for(int r=5; r<11; r++) {
@@ -316,14 +896,46 @@ int main(int argc, char *argv[]) {
         float dtime = time_it(direct_ft, n, REPEAT);
         float rtime = time_it(recursive_fft, n, REPEAT);
         float itime = time_it(iterative_fft, n, REPEAT);
+        float ptime = time_it(planned_fft, n, REPEAT);
 
         // Print the results:
         cout << "| " << setw(7) <<     n << " ";
         cout << "| " << setw(7) <<   n*n << " ";
         cout << "| " << setw(7) <<   r*n << " ";
+        cout << "| " << setw(7) << 4*r*n - 6*n + 8 << " ";
+        cout << "| " << setw(7) << tangent_flops(n) << " ";
         cout << "| " << setw(7) << setprecision(7) << dtime << " ";
         cout << "| " << setw(7) << setprecision(7) << rtime << " ";
-        cout << "| " << setw(7) << setprecision(7) << itime << " |" << endl;
+        cout << "| " << setw(7) << setprecision(7) << itime << " ";
+        cout << "| " << setw(7) << setprecision(7) << ptime << " |" << endl;
+    }
+
+    cout << "+---------+---------+---------+---------+---------+"
+         << "---------+---------+---------+---------+" << endl;
+
+    // Compare the iterative versions with vectors larger than the cache:
+    cout << "+---------+---------+---------+---------+---------+---------+" << endl;
+    cout << "|    N    | Itera.  | Blocked | Radix-" << setw(2) << left << (1 << largest_radix())
+         << right << "| Planned | Passes  |" << endl;
+    cout << "+---------+---------+---------+---------+---------+---------+" << endl;
+
+    // Try it with vectors with size ranging from 4096 to 1048576 samples:
+    for(int r=12; r<21; r+=2) {
+
+        // Compute the average execution time:
+        int n = (int) exp2(r);
+        float itime = time_it(iterative_fft, n, REPEAT / 50);
+        float btime = time_it(blocked_fft, n, REPEAT / 50);
+        float xtime = time_it(radix_fft, n, REPEAT / 50);
+        float ptime = time_it(planned_fft, n, REPEAT / 50);
+
+        // Print the results:
+        cout << "| " << setw(7) <<     n << " ";
+        cout << "| " << setw(7) << setprecision(7) << itime << " ";
+        cout << "| " << setw(7) << setprecision(7) << btime << " ";
+        cout << "| " << setw(7) << setprecision(7) << xtime << " ";
+        cout << "| " << setw(7) << setprecision(7) << ptime << " ";
+        cout << "| " << setw(7) << get_plan(n)->bits.size() << " |" << endl;
     }
 
     cout << "+---------+---------+---------+---------+---------+---------+" << endl;
@@ -0,0 +1,853 @@
+/**************************************************************************************************
+ * Fast Fourier Transform -- C++ Version
+ * This version implements a local FFT server over an Unix domain socket, with shared memory.
+ *
+ * José Alexandre Nalon
+ **************************************************************************************************
+ * This program needs a Linux box to be compiled and run, since it uses Unix domain sockets and
+ * anonymous shared memory files (memfd). Besides the math library, it must be linked with the
+ * threads library. In my box, I used the command:
+ *
+ * $ g++ -o fftserver fftserver.cpp -lm -lpthread
+ *
+ * It can be run with the command (remember to change permission to execute):
+ *
+ * $ ./fftserver
+ *
+ * which starts a server in a child process, runs a number of clients against it and compares the
+ * time spent with the local computation of the transforms. To run only the server, as a daemon
+ * that other processes can connect to, use:
+ *
+ * $ ./fftserver serve /tmp/fft.sock
+ *
+ * Obs.: The server owns the tables of twiddle factors (the "plans") and a pool of threads, so the
+ *   processes that use it don't have to build their own. Data is never copied through the socket:
+ *   every client creates a shared memory file, sends its descriptor to the server only once, and
+ *   afterwards the socket is used only to exchange very small messages. Requests of the same size
+ *   that arrive together are computed as a batch, with the innermost loop running across the
+ *   transforms, so the compiler can vectorize it.
+ **************************************************************************************************/
+
+/**************************************************************************************************
+ Include necessary libraries:
+ **************************************************************************************************/
+#include <iostream>                            // Input and Output;
+#include <iomanip>                             // I/O Manipulation;
+#include <cmath>                               // Math Functions;
+#include <cstring>                             // Memory and strings;
+#include <chrono>                              // Time measurement;
+#include <map>                                 // Plan cache;
+#include <vector>                              // Lists of requests;
+#include <algorithm>                           // Copies;
+#include <deque>                               // Job queue;
+#include <functional>                          // Jobs of the thread pool;
+#include <thread>                              // Threads;
+#include <mutex>                               // Mutual exclusion;
+#include <condition_variable>                  // Synchronization;
+#include <csignal>                             // Signals;
+#include <unistd.h>                            // POSIX functions;
+#include <fcntl.h>                             // Seals of the shared memory;
+#include <poll.h>                              // Waiting on many sockets;
+#include <sys/mman.h>                          // Shared memory;
+#include <sys/socket.h>                        // Sockets;
+#include <sys/un.h>                            // Unix domain sockets;
+#include <sys/stat.h>                          // Size of the shared memory;
+#include <sys/wait.h>                          // Waiting for the server process;
+
+using namespace std;
+
+
+/**************************************************************************************************
+ Definitions:
+ **************************************************************************************************/
+#define REPEAT 500                             // Number of executions to compute average time;
+#define CLIENTS 4                              // Number of concurrent clients in the demo;
+#define WORKERS 2                              // Number of threads in the pool of the server;
+#define BATCH 8                                // Number of transforms computed together;
+#define SOCKET_PATH "/tmp/fftserver.sock"      // Default address of the server;
+
+#define MSG_ATTACH 1                           // Client sends its shared memory;
+#define MSG_FFT 2                              // Client requests a transform;
+#define MSG_DONE 3                             // Server finished the transform;
+#define MSG_ERROR 4                            // Server couldn't compute the transform;
+
+
+/**************************************************************************************************
+ Small class to operate with complex numbers:
+ **************************************************************************************************/
+class Complex {
+    public:
+        float r;                               // Real part;
+        float i;                               // Imaginary part;
+        Complex();                             // Constructors;
+        Complex(float re, float im);
+        void set(float re, float im);
+        void set(Complex c);
+        Complex operator+(Complex c);          // Addition (overload + operator);
+        Complex operator-(Complex c);          // Subtraction (overload - operator);
+        Complex operator*(Complex c);          // Product (overload * operator);
+        Complex operator*(float a);            // Product with a scalar;
+        Complex cexp();                        // Complex exponential;
+};
+
+Complex::Complex() {                           // Constructor;
+    r = 0.0;                                   // Real part;
+    i = 0.0;                                   // Imaginary part;
+}
+
+Complex::Complex(float re, float im) {         // Constructor;
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(float re, float im) {
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(Complex c) {
+    r = c.r;                                   // Real part;
+    i = c.i;                                   // Imaginary part;
+}
+
+Complex Complex::operator+(Complex c) {
+    return Complex(r + c.r, i + c.i);
+}
+
+Complex Complex::operator-(Complex c) {
+    return Complex(r - c.r, i - c.i);
+}
+
+Complex Complex::operator*(Complex c) {
+    return Complex(r*c.r - i*c.i, r*c.i + i*c.r);
+}
+
+Complex Complex::operator*(float a) {
+    return Complex(a*r, a*i);
+}
+
+Complex Complex::cexp() {
+    return Complex(exp(r)*cos(i), exp(r)*sin(i));
+}
+
+Complex cexpn(float a) {                       // Convenience function to compute the exponential;
+    return Complex(cos(a), sin(a));
+}
+
+
+/**************************************************************************************************
+ Messages exchanged through the socket. The data itself is in the shared memory of the client:
+ **************************************************************************************************/
+struct Message {
+    int type;                                  // One of the MSG_* definitions;
+    int N;                                     // Length of the transforms;
+    int count;                                 // Number of transforms requested;
+    long size;                                 // Size of the shared memory, in bytes;
+};
+
+
+/**************************************************************************************************
+ * Auxiliary function: bit_reverse
+ *   Bit-reversed version of an integer number.
+ *
+ * Parameters:
+ *   k
+ *     The number to be bit-reversed;
+ *   r
+ *     The number of bits to take into consideration when reversing.
+ *
+ * Returns:
+ *   The number k, bit-reversed according to integers with r bits.
+ **************************************************************************************************/
+int bit_reverse(int k, int r)
+{
+    int l = 0;                                 // Accumulate the results;
+    for(int i=0; i<r; i++) {                   // Loop on every bit;
+        l = (l << 1) + (k & 1);                // Test less signficant bit and add;
+        k >>= 1;                               // Test next bit;
+    }
+    return l;
+}
+
+
+/**************************************************************************************************
+ Plans hold everything that depends only on the length of the transform. They are computed once
+ and kept in a cache shared by every thread of the server:
+ **************************************************************************************************/
+struct Plan {
+    int N;                                     // Length of the transform;
+    int r;                                     // Number of bits;
+    int *rev;                                  // Bit-reversed indices;
+    Complex *W;                                // Twiddle factors, W[n] = exp(-2 pi n/N);
+};
+
+map<int, Plan *> plans;                        // Cache of plans, indexed by the length;
+mutex plans_lock;                              // Protects the cache;
+
+
+/**************************************************************************************************
+ * Function: get_plan
+ *   Looks for a plan in the cache, creating it if it doesn't exist.
+ *
+ * Parameters:
+ *   N
+ *     The length of the transform. It must be a power of two.
+ *
+ * Returns:
+ *   A pointer to the plan. It is owned by the cache and must not be released.
+ **************************************************************************************************/
+Plan *get_plan(int N)
+{
+    lock_guard<mutex> guard(plans_lock);
+    auto p = plans.find(N);
+    if(p != plans.end())                       // Plan was already computed;
+        return p->second;
+
+    Plan *plan = new Plan;
+    plan->N = N;
+    plan->r = (int) floor(log2(N));            // Number of bits;
+    plan->rev = new int[N];
+    for(int k=0; k<N; k++)                     // Bit-reversed order;
+        plan->rev[k] = bit_reverse(k, plan->r);
+    plan->W = new Complex[N/2 + 1];
+    for(int n=0; n<=N/2; n++)                  // Twiddle factors computed directly, so there is
+        plan->W[n] = cexpn(-2*M_PI*n/N);       //   no accumulation of errors;
+    plans[N] = plan;
+    return plan;
+}
+
+
+/**************************************************************************************************
+ * Function: iterative_fft
+ *   Fast Fourier Transform using an iterative in-place decimation in time algorithm. This is the
+ *   same algorithm of the `fft.cpp` program, with twiddle factors taken from the plan.
+ *
+ * Parameters:
+ *   plan
+ *     Plan for the length of the transform;
+ *   x
+ *     The vector of which the FFT will be computed;
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call.
+ **************************************************************************************************/
+void iterative_fft(Plan *plan, Complex x[], Complex X[])
+{
+    int N = plan->N;
+    for(int k=0; k<N; k++)                     // Reorder the vector according to the
+        X[plan->rev[k]] = x[k];                //   bit-reversed order;
+
+    for(int step=1; step<N; step<<=1) {
+        int stride = N / (2*step);             // Distance between twiddle factors in the table;
+        for(int l=0; l<N; l+=2*step) {
+            for(int n=0; n<step; n++) {
+                int p = l + n;
+                int q = p + step;
+                Complex w = plan->W[n*stride] * X[q];
+                X[q] = X[p] - w;               // Recombine results;
+                X[p] = X[p] + w;
+            }
+        }
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: batch_fft
+ *   Computes a batch of transforms of the same length together. The vectors are transposed into
+ *   separate real and imaginary buffers, with the index of the transform running faster, so the
+ *   innermost loop of every butterfly runs across the transforms and can be vectorized.
+ *
+ * Parameters:
+ *   plan
+ *     Plan for the length of the transforms;
+ *   x
+ *     Array with pointers to the vectors to be transformed;
+ *   X
+ *     Array with pointers to the vectors that will receive the results;
+ *   B
+ *     Number of transforms in the batch. It must be at most BATCH.
+ **************************************************************************************************/
+void batch_fft(Plan *plan, Complex *x[], Complex *X[], int B)
+{
+    int N = plan->N;
+    vector<float> re(N*BATCH), im(N*BATCH);    // Transposed buffers;
+
+    for(int b=0; b<B; b++)                     // Transpose and reorder;
+        for(int k=0; k<N; k++) {
+            int l = plan->rev[k] * BATCH + b;
+            re[l] = x[b][k].r;
+            im[l] = x[b][k].i;
+        }
+
+    for(int step=1; step<N; step<<=1) {
+        int stride = N / (2*step);
+        for(int l=0; l<N; l+=2*step) {
+            for(int n=0; n<step; n++) {
+                float wr = plan->W[n*stride].r;
+                float wi = plan->W[n*stride].i;
+                float *pr = &re[(l+n)*BATCH], *pi = &im[(l+n)*BATCH];
+                float *qr = &re[(l+n+step)*BATCH], *qi = &im[(l+n+step)*BATCH];
+                for(int b=0; b<BATCH; b++) {   // This loop is vectorized;
+                    float tr = wr*qr[b] - wi*qi[b];
+                    float ti = wr*qi[b] + wi*qr[b];
+                    qr[b] = pr[b] - tr;
+                    qi[b] = pi[b] - ti;
+                    pr[b] = pr[b] + tr;
+                    pi[b] = pi[b] + ti;
+                }
+            }
+        }
+    }
+
+    for(int b=0; b<B; b++)                     // Transpose back;
+        for(int k=0; k<N; k++)
+            X[b][k] = Complex(re[k*BATCH + b], im[k*BATCH + b]);
+}
+
+
+/**************************************************************************************************
+ Small pool of threads. Jobs are functions put in a queue and picked by the first free worker:
+ **************************************************************************************************/
+class ThreadPool {
+    public:
+        ThreadPool(int n);                     // Constructor, starts the workers;
+        ~ThreadPool();                         // Destructor, waits for the workers;
+        void run(function<void()> job);        // Puts a job in the queue;
+    private:
+        vector<thread> workers;                // Threads;
+        deque<function<void()>> jobs;          // Queue of jobs;
+        mutex lock;                            // Protects the queue;
+        condition_variable ready;              // Signals new jobs;
+        bool stop;                             // Signals the end of the work;
+        void work();                           // Main loop of the workers;
+};
+
+ThreadPool::ThreadPool(int n) {
+    stop = false;
+    for(int k=0; k<n; k++)
+        workers.push_back(thread(&ThreadPool::work, this));
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> guard(lock);
+        stop = true;
+    }
+    ready.notify_all();
+    for(auto &w : workers)
+        w.join();
+}
+
+void ThreadPool::run(function<void()> job) {
+    {
+        lock_guard<mutex> guard(lock);
+        jobs.push_back(job);
+    }
+    ready.notify_one();
+}
+
+void ThreadPool::work() {
+    while(true) {
+        function<void()> job;
+        {
+            unique_lock<mutex> guard(lock);
+            ready.wait(guard, [this] { return stop || !jobs.empty(); });
+            if(stop && jobs.empty())
+                return;
+            job = jobs.front();
+            jobs.pop_front();
+        }
+        job();
+    }
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: send_message
+ *   Sends a message through the socket, optionally with a file descriptor attached to it.
+ *
+ * Parameters:
+ *   sock
+ *     The socket;
+ *   m
+ *     The message;
+ *   fd
+ *     The file descriptor to be sent, or -1 if there is none.
+ *
+ * Returns:
+ *   True if the message was sent, false otherwise.
+ **************************************************************************************************/
+bool send_message(int sock, Message &m, int fd)
+{
+    struct iovec io = { &m, sizeof(Message) };
+    struct msghdr msg;
+    char control[CMSG_SPACE(sizeof(int))];
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &io;
+    msg.msg_iovlen = 1;
+    if(fd >= 0) {                              // Attach the descriptor;
+        memset(control, 0, sizeof(control));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        struct cmsghdr *c = CMSG_FIRSTHDR(&msg);
+        c->cmsg_level = SOL_SOCKET;
+        c->cmsg_type = SCM_RIGHTS;
+        c->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(c), &fd, sizeof(int));
+    }
+    return sendmsg(sock, &msg, MSG_NOSIGNAL) == sizeof(Message);
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: receive_message
+ *   Receives a message from the socket, and the file descriptor attached to it, if any.
+ *
+ * Parameters:
+ *   sock
+ *     The socket;
+ *   m
+ *     The message;
+ *   fd
+ *     Receives the file descriptor, or -1 if there is none.
+ *
+ * Returns:
+ *   True if a message was received, false if the connection was closed or failed.
+ **************************************************************************************************/
+bool receive_message(int sock, Message &m, int &fd)
+{
+    struct iovec io = { &m, sizeof(Message) };
+    struct msghdr msg;
+    char control[CMSG_SPACE(sizeof(int))];
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &io;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    fd = -1;
+    if(recvmsg(sock, &msg, 0) != sizeof(Message))
+        return false;
+    struct cmsghdr *c = CMSG_FIRSTHDR(&msg);
+    if(c != NULL && c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_RIGHTS)
+        memcpy(&fd, CMSG_DATA(c), sizeof(int));
+    return true;
+}
+
+
+/**************************************************************************************************
+ State of every connection to the server. While a request is being computed, the pool holds a
+ pointer to the shared memory, so it can't be unmapped; if the client goes away meanwhile, the
+ connection is only marked as closed, and the thread that finishes the request releases it:
+ **************************************************************************************************/
+struct Connection {
+    int sock;                                  // Socket of the connection;
+    Complex *data;                             // Shared memory of the client;
+    long size;                                 // Size of the shared memory, in bytes;
+    bool busy;                                 // A request is being computed;
+    bool closed;                               // The client went away while busy;
+};
+
+mutex conns_lock;                              // Protects the busy and closed flags;
+
+
+/**************************************************************************************************
+ * Auxiliary function: release
+ *   Releases the shared memory, the socket and the state of a connection.
+ *
+ * Parameters:
+ *   c
+ *     The connection.
+ **************************************************************************************************/
+void release(Connection *c)
+{
+    if(c->data != NULL)
+        munmap(c->data, c->size);
+    close(c->sock);
+    delete c;
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: attach
+ *   Maps the shared memory sent by a client. The file must be sealed against shrinking, or the
+ *   client could cut it while the server writes to it (and the server would get a SIGBUS), and
+ *   it must be at least as large as the client says.
+ *
+ * Parameters:
+ *   c
+ *     The connection;
+ *   fd
+ *     Descriptor of the shared memory file. It is closed here;
+ *   size
+ *     Size announced by the client, in bytes.
+ *
+ * Returns:
+ *   True if the memory was mapped.
+ **************************************************************************************************/
+bool attach(Connection *c, int fd, long size)
+{
+    struct stat st;
+    int seals = fcntl(fd, F_GET_SEALS);        // -1 if the file can't be sealed at all;
+    bool ok = size > 0 && fstat(fd, &st) == 0 && st.st_size >= size
+              && seals >= 0 && (seals & F_SEAL_SHRINK) != 0;
+    void *p = ok ? mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if(c->data != NULL)
+        munmap(c->data, c->size);
+    c->data = (p == MAP_FAILED) ? NULL : (Complex *) p;
+    c->size = (p == MAP_FAILED) ? 0 : size;
+    return c->data != NULL;
+}
+
+struct Request {
+    Connection *conn;                          // Connection that made the request;
+    int N;                                     // Length of the transforms;
+    int count;                                 // Number of transforms;
+};
+
+
+/**************************************************************************************************
+ * Function: run_requests
+ *   Computes a group of requests of the same length, packing their transforms in batches. The
+ *   input of every transform is read from the shared memory, and the result is written right
+ *   after it. When everything is done, the clients are notified, and the connections whose
+ *   clients went away are released.
+ *
+ * Parameters:
+ *   group
+ *     Requests to be computed, all of them with the same length.
+ **************************************************************************************************/
+void run_requests(vector<Request> group)
+{
+    Plan *plan = get_plan(group[0].N);
+    int N = plan->N;
+    Complex *x[BATCH], *X[BATCH];
+    int B = 0;
+
+    for(auto &q : group) {                     // Pack transforms from every request;
+        Complex *in = q.conn->data;
+        Complex *out = in + (long) q.count * N;
+        for(int j=0; j<q.count; j++) {
+            x[B] = in + (long) j*N;
+            X[B] = out + (long) j*N;
+            if(++B == BATCH) {
+                batch_fft(plan, x, X, B);
+                B = 0;
+            }
+        }
+    }
+    if(B == 1)                                 // A single transform doesn't need transposition;
+        iterative_fft(plan, x[0], X[0]);
+    else if(B > 0)
+        batch_fft(plan, x, X, B);
+
+    lock_guard<mutex> guard(conns_lock);
+    for(auto &q : group) {                     // Notify the clients;
+        q.conn->busy = false;
+        if(q.conn->closed)
+            release(q.conn);
+        else {
+            Message m = { MSG_DONE, q.N, q.count, 0 };
+            send_message(q.conn->sock, m, -1);
+        }
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: serve
+ *   Main loop of the server. It waits for messages in every connection; the requests received
+ *   in the same round are grouped by length and sent to the pool of threads. A connection has at
+ *   most one request pending: other requests, or new shared memory, are refused until it is done.
+ *   Shared memory is not acknowledged; if it is refused, the next request of the client fails.
+ *
+ * Parameters:
+ *   path
+ *     Address of the server in the file system.
+ **************************************************************************************************/
+void serve(const char *path)
+{
+    int listener = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    unlink(path);
+    if(::bind(listener, (struct sockaddr *) &addr, sizeof(addr)) < 0 || listen(listener, 64) < 0) {
+        cerr << "fftserver: could not listen on " << path << endl;
+        return;
+    }
+
+    ThreadPool pool(WORKERS);
+    vector<Connection *> conns;
+    while(true) {
+        vector<struct pollfd> fds(conns.size() + 1);
+        fds[0] = { listener, POLLIN, 0 };
+        for(size_t k=0; k<conns.size(); k++)
+            fds[k+1] = { conns[k]->sock, POLLIN, 0 };
+        if(poll(fds.data(), fds.size(), -1) < 0)
+            break;
+
+        map<int, vector<Request>> groups;      // Requests grouped by length;
+        vector<Connection *> alive;
+        for(size_t k=0; k<conns.size(); k++) {
+            Connection *c = conns[k];
+            if(fds[k+1].revents == 0) {
+                alive.push_back(c);
+                continue;
+            }
+            Message m;
+            int fd;
+            lock_guard<mutex> guard(conns_lock);
+            if(!receive_message(c->sock, m, fd)) {
+                if(c->busy)                    // Connection closed, release everything now
+                    c->closed = true;          //   or when the request is done;
+                else
+                    release(c);
+                continue;
+            }
+            alive.push_back(c);
+            bool ok = !c->busy;
+            if(ok && m.type == MSG_ATTACH && fd >= 0) {
+                ok = attach(c, fd, m.size);
+                fd = -1;
+            } else if(ok && m.type == MSG_FFT && c->data != NULL && m.N > 0
+                      && (m.N & (m.N-1)) == 0 && m.count > 0
+                      && m.count <= c->size / (2L * m.N * (long) sizeof(Complex))) {
+                c->busy = true;
+                groups[m.N].push_back(Request { c, m.N, m.count });
+            } else
+                ok = false;
+            if(fd >= 0)
+                close(fd);
+            if(!ok && m.type != MSG_ATTACH) {  // Invalid request;
+                Message e = { MSG_ERROR, m.N, m.count, 0 };
+                send_message(c->sock, e, -1);
+            }
+        }
+        if(fds[0].revents & POLLIN) {          // New connection, polled in the next round;
+            int sock = accept(listener, NULL, NULL);
+            if(sock >= 0)
+                alive.push_back(new Connection { sock, NULL, 0, false, false });
+        }
+        conns = alive;
+
+        for(auto &g : groups)                  // Send the groups to the pool;
+            pool.run([g] { run_requests(g.second); });
+    }
+    close(listener);
+}
+
+
+/**************************************************************************************************
+ Client side. Every client has its own shared memory, where the input vectors are written and the
+ results are read from:
+ **************************************************************************************************/
+class FFTClient {
+    public:
+        FFTClient(const char *path, long capacity);
+        ~FFTClient();
+        bool connected();                      // Tests if the connection was made;
+        Complex *input();                      // Where the input vectors must be written;
+        Complex *fft(int N, int count);        // Requests the transforms, returns the results;
+    private:
+        int sock;                              // Socket of the connection;
+        Complex *data;                         // Shared memory;
+        long size;                             // Size of the shared memory, in bytes;
+};
+
+FFTClient::FFTClient(const char *path, long capacity) {
+    data = NULL;
+    size = 2 * capacity * sizeof(Complex);     // Room for input and output;
+    sock = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    if(connect(sock, (struct sockaddr *) &addr, sizeof(addr)) < 0) {
+        close(sock);
+        sock = -1;
+        return;
+    }
+
+    int fd = memfd_create("fftclient", MFD_ALLOW_SEALING);
+    if(fd < 0 || ftruncate(fd, size) < 0 || fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK) < 0) {
+        if(fd >= 0)
+            close(fd);
+        close(sock);
+        sock = -1;
+        return;
+    }
+    void *p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if(p == MAP_FAILED) {
+        close(fd);
+        close(sock);
+        sock = -1;
+        return;
+    }
+    data = (Complex *) p;
+    Message m = { MSG_ATTACH, 0, 0, size };
+    send_message(sock, m, fd);                 // Server keeps its own mapping;
+    close(fd);
+}
+
+FFTClient::~FFTClient() {
+    if(data != NULL)
+        munmap(data, size);
+    if(sock >= 0)
+        close(sock);
+}
+
+bool FFTClient::connected() {
+    return sock >= 0 && data != NULL;
+}
+
+Complex *FFTClient::input() {
+    return data;
+}
+
+Complex *FFTClient::fft(int N, int count) {
+    Message m = { MSG_FFT, N, count, 0 };
+    int fd;
+    if(!send_message(sock, m, -1) || !receive_message(sock, m, fd) || m.type != MSG_DONE)
+        return NULL;
+    return data + (long) count * N;            // Results are right after the input;
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: time_local
+ *   Measure execution time through repeated local calls to the transform.
+ *
+ * Parameters:
+ *  size
+ *    Number of elements in the vector on which the transform will be applied;
+ *  repeat
+ *    Number of times the function will be called.
+ *
+ * Returns:
+ *   The average execution time for a vector of the given size.
+ **************************************************************************************************/
+float time_local(int size, int repeat)
+{
+    vector<Complex> x(size), X(size);
+    for(int j=0; j<size; j++)                  // Initialize the vector;
+        x[j] = Complex(j, 0);
+    Plan *plan = get_plan(size);
+    auto t0 = chrono::steady_clock::now();     // Start counting time;
+    for(int j=0; j<repeat; j++)
+        iterative_fft(plan, x.data(), X.data());
+    auto t1 = chrono::steady_clock::now();     // End of time measuring;
+    return chrono::duration<float>(t1 - t0).count() / repeat;
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: time_remote
+ *   Measure execution time through repeated requests to the server, made by a number of clients
+ *   running concurrently.
+ *
+ * Parameters:
+ *  size
+ *    Number of elements in the vector on which the transform will be applied;
+ *  repeat
+ *    Number of times every client will request the transform;
+ *  error
+ *    Receives the largest difference between the results of the server and the transforms
+ *    computed locally, relative to the largest result.
+ *
+ * Returns:
+ *   The average execution time of a transform, or a negative value if the server can't be used.
+ **************************************************************************************************/
+float time_remote(int size, int repeat, float &error)
+{
+    bool ok = true;
+    mutex ok_lock;
+    vector<vector<Complex>> x(CLIENTS, vector<Complex>(size)), X(CLIENTS, vector<Complex>(size));
+    for(int c=0; c<CLIENTS; c++) {             // A different vector for every client, and its
+        for(int j=0; j<size; j++)              //   transform computed locally;
+            x[c][j] = Complex(j, c);
+        iterative_fft(get_plan(size), x[c].data(), X[c].data());
+    }
+
+    error = 0;
+    vector<thread> clients;
+    auto t0 = chrono::steady_clock::now();     // Start counting time;
+    for(int c=0; c<CLIENTS; c++)
+        clients.push_back(thread([&, c] {
+            FFTClient client(SOCKET_PATH, size);
+            bool good = client.connected();
+            Complex *y = NULL;
+            if(good) {
+                copy(x[c].begin(), x[c].end(), client.input());
+                for(int j=0; j<repeat && good; j++)
+                    good = (y = client.fft(size, 1)) != NULL;
+            }
+            float e = 0, peak = 0;
+            for(int k=0; good && k<size; k++) {    // Compare the last result;
+                Complex d = y[k] - X[c][k];
+                e = fmax(e, sqrt(d.r*d.r + d.i*d.i));
+                peak = fmax(peak, sqrt(X[c][k].r*X[c][k].r + X[c][k].i*X[c][k].i));
+            }
+            lock_guard<mutex> guard(ok_lock);
+            ok = ok && good;
+            error = fmax(error, e / fmax(peak, 1e-30f));
+        }));
+    for(auto &c : clients)
+        c.join();
+    auto t1 = chrono::steady_clock::now();     // End of time measuring;
+    if(!ok)
+        return -1;
+    return chrono::duration<float>(t1 - t0).count() / (repeat * CLIENTS);
+}
+
+
+/**************************************************************************************************
+ Main Function:
+ **************************************************************************************************/
+int main(int argc, char *argv[]) {
+
+    // Run only the server, if asked to:
+    if(argc > 1 && strcmp(argv[1], "serve") == 0) {
+        serve(argc > 2 ? argv[2] : SOCKET_PATH);
+        return 0;
+    }
+
+    // Start the server in a child process, and wait until it is ready:
+    pid_t server = fork();
+    if(server == 0) {
+        serve(SOCKET_PATH);
+        return 0;
+    }
+    for(int k=0; k<100 && access(SOCKET_PATH, F_OK) != 0; k++)
+        usleep(10000);
+
+    // Start by printing the table with time comparisons:
+    cout << "+---------+---------+---------+---------+" << endl;
+    cout << "|    N    |  Local  | Server  |  Error  |" << endl;
+    cout << "+---------+---------+---------+---------+" << endl;
+
+    // Try it with vectors with size ranging from 32 to 1024 samples:
+    for(int r=5; r<11; r++) {
+
+        // Compute the average execution time:
+        int n = (int) exp2(r);
+        float ltime = time_local(n, REPEAT);
+        float error;
+        float stime = time_remote(n, REPEAT, error);
+
+        // Print the results:
+        cout << "| " << setw(7) <<     n << " ";
+        cout << "| " << setw(7) << setprecision(7) << ltime << " ";
+        cout << "| " << setw(7) << setprecision(7) << stime << " ";
+        cout << "| " << setw(7) << setprecision(2) << error << " |" << endl;
+    }
+
+    cout << "+---------+---------+---------+---------+" << endl;
+
+    kill(server, SIGTERM);                     // Stop the server;
+    waitpid(server, NULL, 0);
+    unlink(SOCKET_PATH);
+    return 0;
+}
@@ -0,0 +1,703 @@
+/**************************************************************************************************
+ * Fast Fourier Transform -- C++ Version
+ * This version implements the fractional Fourier transform, by chirp decomposition.
+ *
+ * José Alexandre Nalon
+ **************************************************************************************************
+ * This program doesn't need much to be compiled and run. It can be done, as far as I know, with
+ * any C++ compiler, just remember to link the math library. In my box, I used the command:
+ *
+ * $ g++ -o frft frft.cpp -lm
+ *
+ * It can be run with the command (remember to change permission to execute):
+ *
+ * $ ./frft
+ *
+ * Obs.: The fractional Fourier transform of order a rotates the signal in the time-frequency
+ *   plane by an angle phi = a pi/2: the order 1 is the ordinary Fourier transform, the order 2
+ *   reverses the signal, and orders in between are useful to analyze chirps. Its kernel,
+ *   exp(i pi (x^2 cot(phi) - 2 x y csc(phi) + y^2 cot(phi))), can be decomposed in a
+ *   multiplication by a chirp, a convolution with a chirp and another multiplication by a chirp
+ *   (the algorithm by Ozaktas et al.). The convolution is computed with power of two FFTs, so
+ *   the transform has O(N log N) complexity. The signal is interpolated by two before the
+ *   multiplication, so the chirp doesn't alias, and the algorithm is used only for orders between
+ *   0.5 and 1.5; other orders are reduced to those by an ordinary Fourier transform. When the
+ *   transform is computed for many orders, the interpolated signal (and its Fourier transform)
+ *   is computed only once, and the chirps and the spectra of the convolution kernels are kept in
+ *   a cache for every order. The table shows three checks: the gaussian, which is unchanged by
+ *   every order; the order 1 of a non-symmetric signal against its Fourier transform; and the
+ *   orders a and b applied one after the other against the order a + b.
+ **************************************************************************************************/
+
+/**************************************************************************************************
+ Include necessary libraries:
+ **************************************************************************************************/
+#include <iostream>                            // Input and Output;
+#include <iomanip>                             // I/O Manipulation;
+#include <cmath>                               // Math Functions;
+#include <chrono>                              // Time measurement;
+#include <map>                                 // Cache of chirps;
+#include <vector>                              // Buffers;
+
+using namespace std;
+
+
+/**************************************************************************************************
+ Definitions:
+ **************************************************************************************************/
+#define REPEAT 20                              // Number of executions to compute average time;
+#define ANGLES 16                              // Number of orders computed at once;
+
+
+/**************************************************************************************************
+ Small class to operate with complex numbers:
+ **************************************************************************************************/
+class Complex {
+    public:
+        float r;                               // Real part;
+        float i;                               // Imaginary part;
+        Complex();                             // Constructors;
+        Complex(float re, float im);
+        void set(float re, float im);
+        void set(Complex c);
+        Complex operator+(Complex c);          // Addition (overload + operator);
+        Complex operator-(Complex c);          // Subtraction (overload - operator);
+        Complex operator*(Complex c);          // Product (overload * operator);
+        Complex operator*(float a);            // Product with a scalar;
+        Complex cexp();                        // Complex exponential;
+};
+
+Complex::Complex() {                           // Constructor;
+    r = 0.0;                                   // Real part;
+    i = 0.0;                                   // Imaginary part;
+}
+
+Complex::Complex(float re, float im) {         // Constructor;
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(float re, float im) {
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(Complex c) {
+    r = c.r;                                   // Real part;
+    i = c.i;                                   // Imaginary part;
+}
+
+Complex Complex::operator+(Complex c) {
+    return Complex(r + c.r, i + c.i);
+}
+
+Complex Complex::operator-(Complex c) {
+    return Complex(r - c.r, i - c.i);
+}
+
+Complex Complex::operator*(Complex c) {
+    return Complex(r*c.r - i*c.i, r*c.i + i*c.r);
+}
+
+Complex Complex::operator*(float a) {
+    return Complex(a*r, a*i);
+}
+
+Complex Complex::cexp() {
+    return Complex(exp(r)*cos(i), exp(r)*sin(i));
+}
+
+Complex cexpn(float a) {                       // Convenience function to compute the exponential;
+    return Complex(cos(a), sin(a));
+}
+
+Complex cexpd(double a) {                      // Exponential with the argument in double precision;
+    return Complex(cos(a), sin(a));            //   (chirps have very large phases);
+}
+
+
+/**************************************************************************************************
+ * Function: bit_reverse
+ *   Bit-reversed version of an integer number.
+ *
+ * Parameters:
+ *   k
+ *     The number to be bit-reversed;
+ *   r
+ *     The number of bits to take into consideration when reversing.
+ *
+ * Returns:
+ *   The number k, bit-reversed according to integers with r bits.
+ **************************************************************************************************/
+int bit_reverse(int k, int r)
+{
+    int l = 0;                                 // Accumulate the results;
+    for(int i=0; i<r; i++) {                   // Loop on every bit;
+        l = (l << 1) + (k & 1);                // Test less signficant bit and add;
+        k >>= 1;                               // Test next bit;
+    }
+    return l;
+}
+
+
+/**************************************************************************************************
+ Plans hold everything that depends only on the length of the transform, and are kept in a cache:
+ **************************************************************************************************/
+struct Plan {
+    int N;                                     // Length of the transform;
+    vector<int> rev;                           // Bit-reversed indices;
+    vector<Complex> W;                         // Twiddle factors, W[n] = exp(-2 pi n/N);
+};
+
+map<int, Plan *> plans;                        // Cache of plans, indexed by the length;
+
+
+/**************************************************************************************************
+ * Function: get_plan
+ *   Looks for a plan in the cache, creating it if it doesn't exist.
+ *
+ * Parameters:
+ *   N
+ *     The length of the transform. It must be a power of two.
+ *
+ * Returns:
+ *   A pointer to the plan. It is owned by the cache and must not be released.
+ **************************************************************************************************/
+Plan *get_plan(int N)
+{
+    auto p = plans.find(N);
+    if(p != plans.end())                       // Plan was already computed;
+        return p->second;
+
+    Plan *plan = new Plan;
+    plan->N = N;
+    int r = (int) floor(log2(N));              // Number of bits;
+    plan->rev.resize(N);
+    for(int k=0; k<N; k++)                     // Bit-reversed order;
+        plan->rev[k] = bit_reverse(k, r);
+    plan->W.resize(N/2 + 1);
+    for(int n=0; n<=N/2; n++)                  // Twiddle factors computed directly;
+        plan->W[n] = cexpd(-2*M_PI*n/N);
+    plans[N] = plan;
+    return plan;
+}
+
+
+/**************************************************************************************************
+ * Function: fft
+ *   Fast Fourier Transform using an iterative in-place decimation in time algorithm, with the
+ *   twiddle factors taken from a cached plan. The inverse transform is computed by conjugation,
+ *   and it is not divided by N.
+ *
+ * Parameters:
+ *   x
+ *     The vector of which the FFT will be computed. It must have a power of two length;
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call, and it can't be the same as the input;
+ *   N
+ *     The number of elements in the vector;
+ *   inverse
+ *     If true, computes the inverse transform.
+ **************************************************************************************************/
+void fft(Complex x[], Complex X[], int N, bool inverse)
+{
+    Plan *plan = get_plan(N);
+    for(int k=0; k<N; k++) {                   // Reorder the vector according to the
+        int l = plan->rev[k];                  //   bit-reversed order;
+        X[l] = inverse ? Complex(x[k].r, -x[k].i) : x[k];
+    }
+
+    for(int step=1; step<N; step<<=1) {
+        int stride = N / (2*step);             // Distance between twiddle factors in the table;
+        for(int l=0; l<N; l+=2*step)
+            for(int n=0; n<step; n++) {
+                int p = l + n;
+                int q = p + step;
+                Complex w = plan->W[n*stride] * X[q];
+                X[q] = X[p] - w;               // Recombine results;
+                X[p] = X[p] + w;
+            }
+    }
+
+    if(inverse)                                // Conjugate back;
+        for(int k=0; k<N; k++)
+            X[k].i = -X[k].i;
+}
+
+
+/**************************************************************************************************
+ * Function: centered_dft
+ *   Unitary Fourier transform of a vector whose indices are centered, that is, element j of the
+ *   vector is the sample n = j - N/2. This is the transform of order 1.
+ *
+ * Parameters:
+ *   x
+ *     The vector to be transformed;
+ *   X
+ *     The vector that will receive the results;
+ *   N
+ *     The number of elements in the vector. It must be a power of two;
+ *   inverse
+ *     If true, computes the inverse transform (the transform of order -1).
+ **************************************************************************************************/
+void centered_dft(Complex x[], Complex X[], int N, bool inverse)
+{
+    vector<Complex> a(N), A(N);
+    for(int j=0; j<N; j++)                     // Move the origin to the first element;
+        a[(j + N/2) % N] = x[j];
+    fft(a.data(), A.data(), N, inverse);
+    float s = 1 / sqrt(N);
+    for(int j=0; j<N; j++)                     // Move the origin back to the center;
+        X[j] = A[(j + N/2) % N] * s;
+}
+
+
+/**************************************************************************************************
+ * Function: interpolate
+ *   Interpolates a centered vector by two, by padding its spectrum with zeros. The element j of
+ *   the result is the sample n = j - N, and even samples are the original ones.
+ *
+ * Parameters:
+ *   x
+ *     The vector to be interpolated;
+ *   y
+ *     The vector that will receive the 2N samples;
+ *   N
+ *     The number of elements in the vector. It must be a power of two.
+ **************************************************************************************************/
+void interpolate(Complex x[], Complex y[], int N)
+{
+    vector<Complex> a(N), A(N), B(2*N), b(2*N);
+    for(int j=0; j<N; j++)                     // Move the origin to the first element;
+        a[(j + N/2) % N] = x[j];
+    fft(a.data(), A.data(), N, false);
+    for(int k=0; k<N/2; k++) {                 // Positive and negative frequencies;
+        B[k] = A[k];
+        B[2*N - N/2 + k] = A[N/2 + k];
+    }
+    B[2*N - N/2] = A[N/2] * 0.5;               // Split the bin at half the sampling rate;
+    B[N/2] = A[N/2] * 0.5;
+    fft(B.data(), b.data(), 2*N, true);
+    for(int j=0; j<2*N; j++)                   // Move the origin back to the center;
+        y[j] = b[(j + N) % (2*N)] * (1.0 / N);
+}
+
+
+/**************************************************************************************************
+ Tables that depend only on the order of the transform and the length of the vector, kept in a
+ cache so that repeated orders are computed faster:
+ **************************************************************************************************/
+struct Order {
+    vector<Complex> pre;                       // Chirp multiplied before the convolution;
+    vector<Complex> post;                      // Chirp multiplied after the convolution;
+    vector<Complex> kernel;                    // Spectrum of the convolution kernel;
+};
+
+
+/**************************************************************************************************
+ Class that implements the fractional Fourier transform for vectors of a given length:
+ **************************************************************************************************/
+class FrFT {
+    public:
+        FrFT(int N);
+        void transform(Complex x[], float a[], int count, Complex *X[]);
+        void direct(Complex x[], float a, Complex X[]);
+    private:
+        int N;                                 // Length of the vectors;
+        map<float, Order> orders;              // Cache of chirps, by order;
+        Order &get_order(float a);
+        void core(Complex y[], float a, Complex X[]);
+};
+
+FrFT::FrFT(int N) {
+    this->N = N;
+}
+
+
+/**************************************************************************************************
+ * Method: FrFT::get_order
+ *   Looks for the tables of an order in the cache, creating them if they don't exist. The samples
+ *   are taken in the positions t = n/sqrt(N), so the interpolated vector has samples in
+ *   t = n/(2 sqrt(N)); the transform is
+ *
+ *     X(t) = A exp(-i pi tan(phi/2) t^2) sum_n exp(i pi csc(phi) (t - t_n)^2) y'[n] dt
+ *
+ *   with y'[n] = exp(-i pi tan(phi/2) t_n^2) y[n] and A = exp(-i pi sgn(phi)/4 + i phi/2) /
+ *   sqrt(|sin(phi)|).
+ *
+ * Parameters:
+ *   a
+ *     The order. It must be between 0.5 and 1.5 in absolute value.
+ *
+ * Returns:
+ *   The tables of the order.
+ **************************************************************************************************/
+Order &FrFT::get_order(float a)
+{
+    auto p = orders.find(a);
+    if(p != orders.end())                      // Order was already computed;
+        return p->second;
+
+    Order &o = orders[a];
+    double phi = a * M_PI / 2;
+    double tan2 = tan(phi / 2), csc = 1 / sin(phi);
+    double dt = 1 / (2 * sqrt(N));             // Spacing of the interpolated samples;
+    Complex A = cexpd(-M_PI/4 * (phi > 0 ? 1 : -1) + phi/2) * (float) (dt / sqrt(fabs(sin(phi))));
+
+    o.pre.resize(2*N);
+    for(int j=0; j<2*N; j++) {
+        double t = (j - N) * dt;
+        o.pre[j] = cexpd(-M_PI * tan2 * t * t);
+    }
+    o.post.resize(N);
+    for(int j=0; j<N; j++) {
+        double t = (j - N/2) * 2 * dt;
+        o.post[j] = cexpd(-M_PI * tan2 * t * t) * A;
+    }
+
+    int M = 4*N;                               // Circular convolution long enough;
+    vector<Complex> c(M);
+    for(int k=-2*N+1; k<2*N; k++) {
+        double t = k * dt;
+        c[(k + M) % M] = cexpd(M_PI * csc * t * t);
+    }
+    o.kernel.resize(M);
+    fft(c.data(), o.kernel.data(), M, false);
+    return o;
+}
+
+
+/**************************************************************************************************
+ * Method: FrFT::core
+ *   Computes the transform of an interpolated vector, for an order between 0.5 and 1.5 in
+ *   absolute value: multiplication by a chirp, convolution with a chirp (through FFTs of length
+ *   4N), and multiplication by a chirp in the original samples.
+ *
+ * Parameters:
+ *   y
+ *     The interpolated vector, with 2N samples;
+ *   a
+ *     The order;
+ *   X
+ *     Receives the N samples of the transform.
+ **************************************************************************************************/
+void FrFT::core(Complex y[], float a, Complex X[])
+{
+    Order &o = get_order(a);
+    int M = 4*N;
+    vector<Complex> g(M), G(M);
+    for(int j=0; j<2*N; j++)                   // First chirp;
+        g[j] = y[j] * o.pre[j];
+    fft(g.data(), G.data(), M, false);
+    for(int k=0; k<M; k++)                     // Convolution;
+        G[k] = G[k] * o.kernel[k];
+    fft(G.data(), g.data(), M, true);
+    for(int j=0; j<N; j++)                     // Second chirp, in the even samples;
+        X[j] = g[2*j] * o.post[j] * (1.0 / M);
+}
+
+
+/**************************************************************************************************
+ * Method: FrFT::transform
+ *   Computes the transform of a vector for a number of orders. Orders are reduced to the interval
+ *   (-2, 2]; orders 0 and 2 are trivial, orders between 0.5 and 1.5 in absolute value are
+ *   computed directly, and the others use the Fourier transform (or its inverse) of the vector,
+ *   since F^a x = F^(a-1) (F x). Everything that depends only on the vector is computed once.
+ *
+ * Parameters:
+ *   x
+ *     The vector to be transformed, with centered indices (element j is the sample j - N/2);
+ *   a
+ *     The orders of the transforms;
+ *   count
+ *     The number of orders;
+ *   X
+ *     Array of pointers to the vectors that will receive the transforms.
+ **************************************************************************************************/
+void FrFT::transform(Complex x[], float a[], int count, Complex *X[])
+{
+    vector<Complex> y, yf, yi;                 // Interpolated vector and its transforms;
+    vector<Complex> f(N);
+
+    for(int i=0; i<count; i++) {
+        float b = fmod(a[i], 4);               // Reduce the order to (-2, 2];
+        if(b > 2)
+            b = b - 4;
+        else if(b <= -2)
+            b = b + 4;
+
+        if(b == 0)                             // Identity;
+            for(int j=0; j<N; j++)
+                X[i][j] = x[j];
+        else if(b == 2)                        // Reversal, sample n goes to -n;
+            for(int j=0; j<N; j++)
+                X[i][j] = x[(N - j) % N];
+        else if(fabs(b) >= 0.5 && fabs(b) <= 1.5) {
+            if(y.empty()) {
+                y.resize(2*N);
+                interpolate(x, y.data(), N);
+            }
+            core(y.data(), b, X[i]);
+        } else if(b > 1.5 || (b > 0 && b < 0.5)) {
+            if(yf.empty()) {                   // Use F^(b-1) F x;
+                centered_dft(x, f.data(), N, false);
+                yf.resize(2*N);
+                interpolate(f.data(), yf.data(), N);
+            }
+            core(yf.data(), b - 1, X[i]);
+        } else {
+            if(yi.empty()) {                   // Use F^(b+1) F^-1 x;
+                centered_dft(x, f.data(), N, true);
+                yi.resize(2*N);
+                interpolate(f.data(), yi.data(), N);
+            }
+            core(yi.data(), b + 1, X[i]);
+        }
+    }
+}
+
+
+/**************************************************************************************************
+ * Method: FrFT::direct
+ *   Computes the same discretization of the transform, but the convolution is computed directly
+ *   from the definition, with O(N^2) complexity. Only orders between 0.5 and 1.5 are accepted.
+ *
+ * Parameters:
+ *   x
+ *     The vector to be transformed, with centered indices;
+ *   a
+ *     The order;
+ *   X
+ *     Receives the transform.
+ **************************************************************************************************/
+void FrFT::direct(Complex x[], float a, Complex X[])
+{
+    vector<Complex> y(2*N);
+    interpolate(x, y.data(), N);
+    double phi = a * M_PI / 2;
+    double csc = 1 / sin(phi);
+    double dt = 1 / (2 * sqrt(N));
+    Order &o = get_order(a);
+    for(int j=0; j<N; j++) {
+        Complex s = Complex(0, 0);
+        for(int n=0; n<2*N; n++) {
+            double t = (2*j - n) * dt;
+            s = s + y[n] * o.pre[n] * cexpd(M_PI * csc * t * t);
+        }
+        X[j] = s * o.post[j];
+    }
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: max_difference
+ *   Largest absolute difference between two vectors.
+ *
+ * Parameters:
+ *  a, b
+ *    The vectors to be compared;
+ *  N
+ *    Number of elements in the vectors.
+ *
+ * Returns:
+ *   The largest absolute difference.
+ **************************************************************************************************/
+float max_difference(Complex a[], Complex b[], int N)
+{
+    float e = 0;
+    for(int j=0; j<N; j++) {
+        Complex d = a[j] - b[j];
+        e = fmax(e, sqrt(d.r*d.r + d.i*d.i));
+    }
+    return e;
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: test_signal
+ *   A signal that is not symmetric in time nor in frequency, and so is changed by the transforms
+ *   of every order: a shifted gaussian modulated by a complex exponential.
+ *
+ * Parameters:
+ *  x
+ *    The vector that will receive the samples, with centered indices;
+ *  N
+ *    Number of samples.
+ **************************************************************************************************/
+void test_signal(Complex x[], int N)
+{
+    for(int j=0; j<N; j++) {
+        double t = (j - N/2) / sqrt(N);
+        x[j] = cexpd(2 * M_PI * 0.3 * t) * exp(-M_PI * (t - 0.5) * (t - 0.5));
+    }
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: gaussian_error
+ *   The gaussian exp(-pi t^2) is its own fractional transform, for every order. This computes
+ *   the transform of a sampled gaussian for a number of orders and returns the largest error.
+ *
+ * Parameters:
+ *  N
+ *    Number of samples.
+ *
+ * Returns:
+ *   The largest absolute error.
+ **************************************************************************************************/
+float gaussian_error(int N)
+{
+    FrFT frft(N);
+    vector<Complex> x(N);
+    for(int j=0; j<N; j++) {
+        double t = (j - N/2) / sqrt(N);
+        x[j] = Complex(exp(-M_PI * t * t), 0);
+    }
+    float a[ANGLES];
+    vector<vector<Complex>> X(ANGLES, vector<Complex>(N));
+    Complex *p[ANGLES];
+    for(int i=0; i<ANGLES; i++) {              // Orders covering every case;
+        a[i] = -2 + 4.0 * (i + 1) / ANGLES - 0.1;
+        p[i] = X[i].data();
+    }
+    frft.transform(x.data(), a, ANGLES, p);
+    float e = 0;
+    for(int i=0; i<ANGLES; i++)
+        e = fmax(e, max_difference(X[i].data(), x.data(), N));
+    return e;
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: order1_error
+ *   The transform of order 1, computed by the chirps, must be the centered Fourier transform.
+ *   This compares both for a signal that the transform changes.
+ *
+ * Parameters:
+ *  N
+ *    Number of samples.
+ *
+ * Returns:
+ *   The largest absolute error.
+ **************************************************************************************************/
+float order1_error(int N)
+{
+    FrFT frft(N);
+    vector<Complex> x(N), X(N), F(N);
+    test_signal(x.data(), N);
+    float a = 1;
+    Complex *p = X.data();
+    frft.transform(x.data(), &a, 1, &p);
+    centered_dft(x.data(), F.data(), N, false);
+    return max_difference(F.data(), X.data(), N);
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: additivity_error
+ *   Transforms of orders a and b, one after the other, must give the transform of order a + b.
+ *   The orders are chosen so that every path of the transform is used (0.3 is computed from the
+ *   Fourier transform of the vector, 0.9 and 1.2 by the chirps only).
+ *
+ * Parameters:
+ *  N
+ *    Number of samples.
+ *
+ * Returns:
+ *   The largest absolute error.
+ **************************************************************************************************/
+float additivity_error(int N)
+{
+    FrFT frft(N);
+    vector<Complex> x(N), Y(N), X(N), Z(N);
+    test_signal(x.data(), N);
+    float a = 0.3, b = 0.9, c = a + b;
+    Complex *p = Y.data(), *q = X.data(), *r = Z.data();
+    frft.transform(x.data(), &a, 1, &p);       // F^b F^a x;
+    frft.transform(Y.data(), &b, 1, &q);
+    frft.transform(x.data(), &c, 1, &r);       // F^(a+b) x;
+    return max_difference(Z.data(), X.data(), N);
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: time_it
+ *   Measure execution time of the fractional transform for a number of orders.
+ *
+ * Parameters:
+ *  method
+ *    0 for the direct convolution, 1 for the transform of every order by a separate call, 2 for
+ *    a single call with every order;
+ *  size
+ *    Number of elements in the vector;
+ *  repeat
+ *    Number of times the function will be called.
+ *
+ * Returns:
+ *   The average execution time for one order.
+ **************************************************************************************************/
+float time_it(int method, int size, int repeat)
+{
+    FrFT frft(size);
+    vector<Complex> x(size);
+    for(int j=0; j<size; j++)                  // Initialize the vector;
+        x[j] = Complex(j, 0);
+    float a[ANGLES];
+    vector<vector<Complex>> X(ANGLES, vector<Complex>(size));
+    Complex *p[ANGLES];
+    for(int i=0; i<ANGLES; i++) {
+        a[i] = 0.5 + (float) i / ANGLES;
+        p[i] = X[i].data();
+    }
+    frft.transform(x.data(), a, ANGLES, p);    // Fill the cache;
+
+    auto t0 = chrono::steady_clock::now();     // Start counting time;
+    for(int j=0; j<repeat; j++)
+        if(method == 0)
+            frft.direct(x.data(), a[j % ANGLES], p[0]);
+        else if(method == 1)
+            for(int i=0; i<ANGLES; i++)
+                frft.transform(x.data(), &a[i], 1, &p[i]);
+        else
+            frft.transform(x.data(), a, ANGLES, p);
+    auto t1 = chrono::steady_clock::now();     // End of time measuring;
+    return chrono::duration<float>(t1 - t0).count() / (method == 0 ? repeat : repeat * ANGLES);
+}
+
+
+/**************************************************************************************************
+ Main Function:
+ **************************************************************************************************/
+int main(int argc, char *argv[]) {
+
+    // Start by printing the table with time comparisons:
+    cout << "+---------+---------+---------+---------+---------+---------+---------+" << endl;
+    cout << "|    N    | Direct  |  FrFT   |  Batch  | Gauss.  | Order 1 | a + b   |" << endl;
+    cout << "+---------+---------+---------+---------+---------+---------+---------+" << endl;
+
+    // Try it with vectors with size ranging from 32 to 1024 samples:
+    for(int r=5; r<11; r++) {
+
+        // Compute the average execution time and the errors of the three checks:
+        int n = (int) exp2(r);
+        float dtime = time_it(0, n, REPEAT);
+        float ftime = time_it(1, n, REPEAT);
+        float btime = time_it(2, n, REPEAT);
+        float error = gaussian_error(n);
+        float error1 = order1_error(n);
+        float errora = additivity_error(n);
+
+        // Print the results:
+        cout << "| " << setw(7) <<     n << " ";
+        cout << "| " << setw(7) << setprecision(7) << dtime << " ";
+        cout << "| " << setw(7) << setprecision(7) << ftime << " ";
+        cout << "| " << setw(7) << setprecision(7) << btime << " ";
+        cout << "| " << setw(7) << setprecision(7) << error << " ";
+        cout << "| " << setw(7) << setprecision(7) << error1 << " ";
+        cout << "| " << setw(7) << setprecision(7) << errora << " |" << endl;
+    }
+
+    cout << "+---------+---------+---------+---------+---------+---------+---------+" << endl;
+    return 0;
+}
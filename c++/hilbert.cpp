@@ -0,0 +1,400 @@
+/**************************************************************************************************
+ * Fast Fourier Transform -- C++ Version
+ * This version implements the Hilbert transform, computing the analytic signal of a real vector.
+ *
+ * José Alexandre Nalon
+ **************************************************************************************************
+ * This program doesn't need much to be compiled and run. It can be done, as far as I know, with
+ * any C++ compiler, just remember to link the math library. In my box, I used the command:
+ *
+ * $ g++ -o hilbert hilbert.cpp -lm
+ *
+ * It can be run with the command (remember to change permission to execute):
+ *
+ * $ ./hilbert
+ *
+ * Obs.: The analytic signal of a real signal x[n] is x[n] + i h[n], where h[n] is the Hilbert
+ *   transform of x[n]. Its spectrum is the spectrum of x[n] with the negative frequencies zeroed
+ *   and the positive frequencies doubled, so its magnitude is the envelope of the signal. The
+ *   simplest way to compute it takes two complex transforms of length N, but half of the work is
+ *   wasted: the input is real, and half of the spectrum is zero. Here, the forward transform is a
+ *   real transform, computed with a complex transform of length N/2; the inverse transform
+ *   starts with the first decimation in frequency step, which is almost free because half of the
+ *   spectrum is zero, and ends with two complex transforms of length N/2. Every transform uses
+ *   the same plan, which is computed only once and kept in a cache.
+ **************************************************************************************************/
+
+/**************************************************************************************************
+ Include necessary libraries:
+ **************************************************************************************************/
+#include <iostream>                            // Input and Output;
+#include <iomanip>                             // I/O Manipulation;
+#include <cmath>                               // Math Functions;
+#include <chrono>                              // Time measurement;
+#include <map>                                 // Plan cache;
+#include <vector>                              // Buffers;
+
+using namespace std;
+
+
+/**************************************************************************************************
+ Definitions:
+ **************************************************************************************************/
+#define REPEAT 20                              // Number of executions to compute average time;
+
+
+/**************************************************************************************************
+ Small class to operate with complex numbers:
+ **************************************************************************************************/
+class Complex {
+    public:
+        float r;                               // Real part;
+        float i;                               // Imaginary part;
+        Complex();                             // Constructors;
+        Complex(float re, float im);
+        void set(float re, float im);
+        void set(Complex c);
+        Complex operator+(Complex c);          // Addition (overload + operator);
+        Complex operator-(Complex c);          // Subtraction (overload - operator);
+        Complex operator*(Complex c);          // Product (overload * operator);
+        Complex operator*(float a);            // Product with a scalar;
+        Complex cexp();                        // Complex exponential;
+};
+
+Complex::Complex() {                           // Constructor;
+    r = 0.0;                                   // Real part;
+    i = 0.0;                                   // Imaginary part;
+}
+
+Complex::Complex(float re, float im) {         // Constructor;
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(float re, float im) {
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(Complex c) {
+    r = c.r;                                   // Real part;
+    i = c.i;                                   // Imaginary part;
+}
+
+Complex Complex::operator+(Complex c) {
+    return Complex(r + c.r, i + c.i);
+}
+
+Complex Complex::operator-(Complex c) {
+    return Complex(r - c.r, i - c.i);
+}
+
+Complex Complex::operator*(Complex c) {
+    return Complex(r*c.r - i*c.i, r*c.i + i*c.r);
+}
+
+Complex Complex::operator*(float a) {
+    return Complex(a*r, a*i);
+}
+
+Complex Complex::cexp() {
+    return Complex(exp(r)*cos(i), exp(r)*sin(i));
+}
+
+Complex cexpn(float a) {                       // Convenience function to compute the exponential;
+    return Complex(cos(a), sin(a));
+}
+
+
+/**************************************************************************************************
+ * Function: bit_reverse
+ *   Bit-reversed version of an integer number.
+ *
+ * Parameters:
+ *   k
+ *     The number to be bit-reversed;
+ *   r
+ *     The number of bits to take into consideration when reversing.
+ *
+ * Returns:
+ *   The number k, bit-reversed according to integers with r bits.
+ **************************************************************************************************/
+int bit_reverse(int k, int r)
+{
+    int l = 0;                                 // Accumulate the results;
+    for(int i=0; i<r; i++) {                   // Loop on every bit;
+        l = (l << 1) + (k & 1);                // Test less signficant bit and add;
+        k >>= 1;                               // Test next bit;
+    }
+    return l;
+}
+
+
+/**************************************************************************************************
+ Plans hold everything that depends only on the length of the transform, and are kept in a cache:
+ **************************************************************************************************/
+struct Plan {
+    int N;                                     // Length of the transform;
+    vector<int> rev;                           // Bit-reversed indices;
+    vector<Complex> W;                         // Twiddle factors, W[n] = exp(-pi n/N);
+};
+
+map<int, Plan *> plans;                        // Cache of plans, indexed by the length;
+
+
+/**************************************************************************************************
+ * Function: get_plan
+ *   Looks for a plan in the cache, creating it if it doesn't exist.
+ *
+ * Parameters:
+ *   N
+ *     The length of the transform. It must be a power of two.
+ *
+ * Returns:
+ *   A pointer to the plan. It is owned by the cache and must not be released.
+ **************************************************************************************************/
+Plan *get_plan(int N)
+{
+    auto p = plans.find(N);
+    if(p != plans.end())                       // Plan was already computed;
+        return p->second;
+
+    Plan *plan = new Plan;
+    plan->N = N;
+    int r = (int) floor(log2(N));              // Number of bits;
+    plan->rev.resize(N);
+    for(int k=0; k<N; k++)                     // Bit-reversed order;
+        plan->rev[k] = bit_reverse(k, r);
+    plan->W.resize(N + 1);
+    for(int n=0; n<=N; n++)                    // Twiddle factors for twice the length, since the
+        plan->W[n] = cexpn(-M_PI*n/N);         //   real transforms use the finer ones;
+    plans[N] = plan;
+    return plan;
+}
+
+
+/**************************************************************************************************
+ * Function: fft
+ *   Fast Fourier Transform using an iterative in-place decimation in time algorithm, with the
+ *   twiddle factors taken from the plan. The inverse transform is computed by conjugation, and
+ *   it is not divided by N.
+ *
+ * Parameters:
+ *   plan
+ *     Plan for the length of the transform;
+ *   x
+ *     The vector of which the FFT will be computed;
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call, and it can't be the same as the input;
+ *   inverse
+ *     If true, computes the inverse transform.
+ **************************************************************************************************/
+void fft(Plan *plan, Complex x[], Complex X[], bool inverse)
+{
+    int N = plan->N;
+    for(int k=0; k<N; k++) {                   // Reorder the vector according to the
+        int l = plan->rev[k];                  //   bit-reversed order;
+        X[l] = inverse ? Complex(x[k].r, -x[k].i) : x[k];
+    }
+
+    for(int step=1; step<N; step<<=1) {
+        int stride = N / step;                 // Distance between twiddle factors in the table;
+        for(int l=0; l<N; l+=2*step)
+            for(int n=0; n<step; n++) {
+                int p = l + n;
+                int q = p + step;
+                Complex w = plan->W[n*stride] * X[q];
+                X[q] = X[p] - w;               // Recombine results;
+                X[p] = X[p] + w;
+            }
+    }
+
+    if(inverse)                                // Conjugate back;
+        for(int k=0; k<N; k++)
+            X[k].i = -X[k].i;
+}
+
+
+/**************************************************************************************************
+ * Function: analytic_signal
+ *   Computes the analytic signal of a real vector. The steps are:
+ *
+ *   1. the even samples are put in the real part and the odd samples in the imaginary part of a
+ *      complex vector of length N/2, which is transformed; the first N/2 + 1 bins of the spectrum
+ *      of the real vector are separated from the result, and the positive frequencies are doubled
+ *      (the negative frequencies are simply never computed);
+ *   2. the first step of a decimation in frequency inverse transform splits the spectrum in the
+ *      transforms of the even and odd samples of the result. Since the upper half of the spectrum
+ *      is zero (except for the bin at N/2), there are no sums to be made;
+ *   3. two inverse transforms of length N/2 compute the even and odd samples.
+ *
+ * Parameters:
+ *   x
+ *     The real vector of which the analytic signal will be computed;
+ *   z
+ *     The vector that will receive the analytic signal. It needs to be allocated prior to the
+ *     function call;
+ *   N
+ *     The number of elements in the vector. It must be a power of two, at least 4.
+ **************************************************************************************************/
+void analytic_signal(float x[], Complex z[], int N)
+{
+    int H = N / 2;
+    Plan *plan = get_plan(H);                  // Every transform has length N/2;
+    vector<Complex> a(H), A(H + 1), E(H), O(H);
+
+    for(int n=0; n<H; n++)                     // Pack the real vector;
+        a[n] = Complex(x[2*n], x[2*n+1]);
+    fft(plan, a.data(), A.data(), false);
+    A[H] = A[0];
+
+    Complex Z0, ZH;                            // Bins 0 and N/2 are not doubled;
+    for(int k=0; k<=H; k++) {                  // Separate the spectrum of the real vector;
+        Complex p = A[k];
+        Complex q = Complex(A[H-k].r, -A[H-k].i);
+        Complex Xe = p + q;                    // Transforms of even and odd samples, doubled;
+        Complex Xo = p - q;
+        Xo = Complex(Xo.i, -Xo.r);
+        Complex Z = Xe + plan->W[k] * Xo;      // Twice the spectrum, W[k] = exp(-2 pi k/N);
+        if(k == 0)
+            Z0 = Z * 0.5;
+        else if(k == H)
+            ZH = Z * 0.5;
+        else if(k < H) {                       // First step of the inverse transform, the
+            E[k] = Z;                          //   upper half of the spectrum is zero;
+            Complex w = plan->W[k];
+            O[k] = Z * Complex(w.r, -w.i);
+        }
+    }
+    E[0] = Z0 + ZH;
+    O[0] = Z0 - ZH;
+
+    fft(plan, E.data(), a.data(), true);       // Even samples;
+    fft(plan, O.data(), A.data(), true);       // Odd samples;
+    for(int n=0; n<H; n++) {
+        z[2*n] = a[n] * (1.0 / N);
+        z[2*n+1] = A[n] * (1.0 / N);
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: simple_analytic_signal
+ *   Computes the analytic signal with two complex transforms of length N, with no savings at all.
+ *   It is used as a reference.
+ *
+ * Parameters:
+ *   x
+ *     The real vector of which the analytic signal will be computed;
+ *   z
+ *     The vector that will receive the analytic signal. It needs to be allocated prior to the
+ *     function call;
+ *   N
+ *     The number of elements in the vector. It must be a power of two.
+ **************************************************************************************************/
+void simple_analytic_signal(float x[], Complex z[], int N)
+{
+    Plan *plan = get_plan(N);
+    vector<Complex> a(N), X(N);
+    for(int n=0; n<N; n++)
+        a[n] = Complex(x[n], 0);
+    fft(plan, a.data(), X.data(), false);
+    for(int k=1; k<N/2; k++)                   // Double positive frequencies;
+        X[k] = X[k] * 2;
+    for(int k=N/2+1; k<N; k++)                 // Zero negative frequencies;
+        X[k] = Complex(0, 0);
+    fft(plan, X.data(), z, true);
+    for(int n=0; n<N; n++)
+        z[n] = z[n] * (1.0 / N);
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: time_it
+ *   Measure execution time through repeated calls to a function that computes the analytic
+ *   signal.
+ *
+ * Parameters:
+ *  f
+ *    Function to be called, with the given prototype. The first vector is the real input vector,
+ *    the second vector is the analytic signal, and the integer is the number of elements;
+ *  size
+ *    Number of elements in the vector;
+ *  repeat
+ *    Number of times the function will be called.
+ *
+ * Returns:
+ *   The average execution time for that function with a vector of the given size.
+ **************************************************************************************************/
+float time_it(void (*f)(float *, Complex *, int), int size, int repeat)
+{
+    vector<float> x(size);
+    vector<Complex> z(size);
+    for(int j=0; j<size; j++)                  // Initialize the vector;
+        x[j] = j;
+    (*f)(x.data(), z.data(), size);            // Plans are computed in the first call;
+    auto t0 = chrono::steady_clock::now();     // Start counting time;
+    for(int j=0; j<repeat; j++)
+        (*f)(x.data(), z.data(), size);
+    auto t1 = chrono::steady_clock::now();     // End of time measuring;
+    return chrono::duration<float>(t1 - t0).count() / repeat;
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: envelope_error
+ *   Computes the envelope of an amplitude modulated tone and compares it with the exact envelope.
+ *
+ * Parameters:
+ *  size
+ *    Number of elements in the vector.
+ *
+ * Returns:
+ *   The largest absolute error of the envelope.
+ **************************************************************************************************/
+float envelope_error(int size)
+{
+    vector<float> x(size), e(size);
+    vector<Complex> z(size);
+    for(int n=0; n<size; n++) {                // Both frequencies fit exactly in the vector;
+        e[n] = 1 + 0.5*cos(2*M_PI*4*n/size);
+        x[n] = e[n] * cos(2*M_PI*(size/8)*n/size);
+    }
+    analytic_signal(x.data(), z.data(), size);
+    float error = 0;
+    for(int n=0; n<size; n++)
+        error = fmax(error, fabs(sqrt(z[n].r*z[n].r + z[n].i*z[n].i) - e[n]));
+    return error;
+}
+
+
+/**************************************************************************************************
+ Main Function:
+ **************************************************************************************************/
+int main(int argc, char *argv[]) {
+
+    // Start by printing the table with time comparisons:
+    cout << "+---------+---------+---------+---------+" << endl;
+    cout << "|    N    | Simple  | Analyt. | Error   |" << endl;
+    cout << "+---------+---------+---------+---------+" << endl;
+
+    // Try it with vectors with size ranging from 1024 to 1048576 samples:
+    for(int r=10; r<21; r+=2) {
+
+        // Compute the average execution time:
+        int n = (int) exp2(r);
+        float stime = time_it(simple_analytic_signal, n, REPEAT);
+        float atime = time_it(analytic_signal, n, REPEAT);
+        float error = envelope_error(n);
+
+        // Print the results:
+        cout << "| " << setw(7) <<     n << " ";
+        cout << "| " << setw(7) << setprecision(7) << stime << " ";
+        cout << "| " << setw(7) << setprecision(7) << atime << " ";
+        cout << "| " << setw(7) << setprecision(7) << error << " |" << endl;
+    }
+
+    cout << "+---------+---------+---------+---------+" << endl;
+    return 0;
+}
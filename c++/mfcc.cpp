@@ -0,0 +1,565 @@
+/**************************************************************************************************
+ * Fast Fourier Transform -- C++ Version
+ * This version implements the extraction of mel-frequency cepstral coefficients (MFCC).
+ *
+ * José Alexandre Nalon
+ **************************************************************************************************
+ * This program doesn't need much to be compiled and run. It can be done, as far as I know, with
+ * any C++ compiler, just remember to link the math library. Optimizations should be turned on, so
+ * the compiler can vectorize the inner loops. In my box, I used the command:
+ *
+ * $ g++ -O3 -march=native -o mfcc mfcc.cpp -lm
+ *
+ * It can be run with the command (remember to change permission to execute):
+ *
+ * $ ./mfcc
+ *
+ * Obs.: The coefficients are computed for every frame of the signal: the frame is weighted by a
+ *   window, its power spectrum is computed, the power is summed in triangular bands equally
+ *   spaced in the mel scale, the logarithm of the energy of the bands is taken, and the discrete
+ *   cosine transform (DCT) of the logarithms gives the coefficients. Here, every step works on a
+ *   batch of frames at once (frames of many streams are mixed in the same batch), with the index
+ *   of the frame running faster, so the innermost loops can be vectorized. The frames are real,
+ *   so the spectrum is computed with a complex FFT of half the length; the bands are kept as a
+ *   sparse matrix (only the bins inside the triangle), applied directly to the power spectrum;
+ *   and the DCT is computed with an FFT of the same length, after reordering the samples
+ *   (Makhoul's algorithm), so the number of bands is a power of two. Every buffer is allocated
+ *   when the object is created, so nothing is allocated while frames are processed.
+ **************************************************************************************************/
+
+/**************************************************************************************************
+ Include necessary libraries:
+ **************************************************************************************************/
+#include <iostream>                            // Input and Output;
+#include <iomanip>                             // I/O Manipulation;
+#include <cmath>                               // Math Functions;
+#include <chrono>                              // Time measurement;
+#include <vector>                              // Buffers;
+
+using namespace std;
+
+
+/**************************************************************************************************
+ Definitions:
+ **************************************************************************************************/
+#define REPEAT 10                              // Number of executions to compute average time;
+#define RATE 16000                             // Sampling rate, in Hz;
+#define FRAME 400                              // Length of the frames (25 ms);
+#define HOP 160                                // Distance between frames (10 ms);
+#define NFFT 512                               // Length of the transform;
+#define MELS 32                                // Number of bands (a power of two);
+#define CEPS 13                                // Number of coefficients kept;
+#define BATCH 16                               // Number of frames processed at once;
+#define FLOOR 1e-10                            // Smallest energy, to compute the logarithm;
+
+
+/**************************************************************************************************
+ Small class to operate with complex numbers:
+ **************************************************************************************************/
+class Complex {
+    public:
+        float r;                               // Real part;
+        float i;                               // Imaginary part;
+        Complex();                             // Constructors;
+        Complex(float re, float im);
+        void set(float re, float im);
+        void set(Complex c);
+        Complex operator+(Complex c);          // Addition (overload + operator);
+        Complex operator-(Complex c);          // Subtraction (overload - operator);
+        Complex operator*(Complex c);          // Product (overload * operator);
+        Complex operator*(float a);            // Product with a scalar;
+        Complex cexp();                        // Complex exponential;
+};
+
+Complex::Complex() {                           // Constructor;
+    r = 0.0;                                   // Real part;
+    i = 0.0;                                   // Imaginary part;
+}
+
+Complex::Complex(float re, float im) {         // Constructor;
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(float re, float im) {
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(Complex c) {
+    r = c.r;                                   // Real part;
+    i = c.i;                                   // Imaginary part;
+}
+
+Complex Complex::operator+(Complex c) {
+    return Complex(r + c.r, i + c.i);
+}
+
+Complex Complex::operator-(Complex c) {
+    return Complex(r - c.r, i - c.i);
+}
+
+Complex Complex::operator*(Complex c) {
+    return Complex(r*c.r - i*c.i, r*c.i + i*c.r);
+}
+
+Complex Complex::operator*(float a) {
+    return Complex(a*r, a*i);
+}
+
+Complex Complex::cexp() {
+    return Complex(exp(r)*cos(i), exp(r)*sin(i));
+}
+
+Complex cexpn(float a) {                       // Convenience function to compute the exponential;
+    return Complex(cos(a), sin(a));
+}
+
+
+/**************************************************************************************************
+ * Function: bit_reverse
+ *   Bit-reversed version of an integer number.
+ *
+ * Parameters:
+ *   k
+ *     The number to be bit-reversed;
+ *   r
+ *     The number of bits to take into consideration when reversing.
+ *
+ * Returns:
+ *   The number k, bit-reversed according to integers with r bits.
+ **************************************************************************************************/
+int bit_reverse(int k, int r)
+{
+    int l = 0;                                 // Accumulate the results;
+    for(int i=0; i<r; i++) {                   // Loop on every bit;
+        l = (l << 1) + (k & 1);                // Test less signficant bit and add;
+        k >>= 1;                               // Test next bit;
+    }
+    return l;
+}
+
+
+/**************************************************************************************************
+ Plans hold everything that depends only on the length of the transform:
+ **************************************************************************************************/
+struct Plan {
+    int N;                                     // Length of the transform;
+    vector<int> rev;                           // Bit-reversed indices;
+    vector<Complex> W;                         // Twiddle factors, W[n] = exp(-2 pi n/N);
+};
+
+
+/**************************************************************************************************
+ * Function: make_plan
+ *   Computes the plan for a given length.
+ *
+ * Parameters:
+ *   N
+ *     The length of the transform. It must be a power of two.
+ *
+ * Returns:
+ *   The plan.
+ **************************************************************************************************/
+Plan make_plan(int N)
+{
+    Plan plan;
+    plan.N = N;
+    int r = (int) floor(log2(N));              // Number of bits;
+    plan.rev.resize(N);
+    for(int k=0; k<N; k++)                     // Bit-reversed order;
+        plan.rev[k] = bit_reverse(k, r);
+    plan.W.resize(N/2 + 1);
+    for(int n=0; n<=N/2; n++)                  // Twiddle factors computed directly;
+        plan.W[n] = cexpn(-2*M_PI*n/N);
+    return plan;
+}
+
+
+/**************************************************************************************************
+ * Function: fft
+ *   Fast Fourier Transform using an iterative in-place decimation in time algorithm, with the
+ *   twiddle factors taken from the plan.
+ *
+ * Parameters:
+ *   plan
+ *     Plan for the length of the transform;
+ *   x
+ *     The vector of which the FFT will be computed;
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call, and it can't be the same as the input.
+ **************************************************************************************************/
+void fft(Plan &plan, Complex x[], Complex X[])
+{
+    int N = plan.N;
+    for(int k=0; k<N; k++)                     // Reorder the vector according to the
+        X[plan.rev[k]] = x[k];                 //   bit-reversed order;
+
+    for(int step=1; step<N; step<<=1) {
+        int stride = N / (2*step);             // Distance between twiddle factors in the table;
+        for(int l=0; l<N; l+=2*step)
+            for(int n=0; n<step; n++) {
+                int p = l + n;
+                int q = p + step;
+                Complex w = plan.W[n*stride] * X[q];
+                X[q] = X[p] - w;               // Recombine results;
+                X[p] = X[p] + w;
+            }
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: batch_fft
+ *   Computes a batch of transforms, in place, over transposed buffers: the element k of the
+ *   transform b is in re[k*B + b] and im[k*B + b], and the elements must already be in
+ *   bit-reversed order. The twiddle factors are read only once for the whole batch, and the
+ *   innermost loop can be vectorized.
+ *
+ * Parameters:
+ *   plan
+ *     Plan for the length of the transforms;
+ *   re, im
+ *     Real and imaginary parts of the transposed buffers;
+ *   B
+ *     Number of transforms in the batch.
+ **************************************************************************************************/
+void batch_fft(Plan &plan, float re[], float im[], int B)
+{
+    int N = plan.N;
+    for(int step=1; step<N; step<<=1) {
+        int stride = N / (2*step);
+        for(int l=0; l<N; l+=2*step)
+            for(int n=0; n<step; n++) {
+                Complex W = plan.W[n*stride];
+                float *pr = &re[(l+n)*B], *pi = &im[(l+n)*B];
+                float *qr = &re[(l+n+step)*B], *qi = &im[(l+n+step)*B];
+                for(int b=0; b<B; b++) {       // This loop is vectorized;
+                    float tr = W.r*qr[b] - W.i*qi[b];
+                    float ti = W.r*qi[b] + W.i*qr[b];
+                    qr[b] = pr[b] - tr;        // Recombine results;
+                    qi[b] = pi[b] - ti;
+                    pr[b] = pr[b] + tr;
+                    pi[b] = pi[b] + ti;
+                }
+            }
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: mel
+ *   Converts a frequency to the mel scale.
+ *
+ * Parameters:
+ *   f
+ *     The frequency, in Hz.
+ *
+ * Returns:
+ *   The frequency in mels.
+ **************************************************************************************************/
+float mel(float f)
+{
+    return 2595 * log10(1 + f/700);
+}
+
+
+/**************************************************************************************************
+ * Function: mel_bank
+ *   Computes the triangular bands, equally spaced in the mel scale from 0 Hz to half the sampling
+ *   rate. The band j starts at the center of the band j-1 and ends at the center of the band j+1.
+ *
+ * Returns:
+ *   The dense matrix of weights; the weight of the bin k in the band j is in the element
+ *   j*(NFFT/2 + 1) + k.
+ **************************************************************************************************/
+vector<float> mel_bank()
+{
+    int K = NFFT/2 + 1;
+    vector<float> w(MELS * K), b(MELS + 2);
+    float top = mel(RATE / 2);
+    for(int j=0; j<MELS+2; j++) {              // Edges of the bands, in bins;
+        float m = top * j / (MELS + 1);
+        b[j] = 700 * (pow(10, m / 2595) - 1) * NFFT / RATE;
+    }
+    for(int j=0; j<MELS; j++)
+        for(int k=0; k<K; k++)
+            if(k > b[j] && k <= b[j+1])
+                w[j*K + k] = (k - b[j]) / (b[j+1] - b[j]);
+            else if(k > b[j+1] && k < b[j+2])
+                w[j*K + k] = (b[j+2] - k) / (b[j+2] - b[j+1]);
+    return w;
+}
+
+
+/**************************************************************************************************
+ Class that implements the extraction of the coefficients:
+ **************************************************************************************************/
+class MFCC {
+    public:
+        MFCC();
+        void process(float *x[], int S, int F, float y[]);
+    private:
+        Plan half;                             // Plan for the spectrum (length NFFT/2);
+        Plan dct;                              // Plan for the DCT (length MELS);
+        vector<float> window;                  // Hamming window;
+        vector<Complex> split;                 // Twiddle factors to split the spectrum;
+        vector<Complex> shift;                 // Phase shifts of the DCT;
+        vector<int> first;                     // First bin of every band;
+        vector<int> start;                     // Where the weights of every band start;
+        vector<float> weights;                 // Weights of the bands, one after another;
+        vector<float> re, im;                  // Transposed buffers for the spectrum;
+        vector<float> power;                   // Transposed power spectrum;
+        vector<float> dre, dim;                // Transposed buffers for the DCT;
+        void batch(float *frames[], int B, float y[]);
+};
+
+
+/**************************************************************************************************
+ * Method: MFCC::MFCC
+ *   Computes the tables and allocates every buffer.
+ **************************************************************************************************/
+MFCC::MFCC()
+{
+    half = make_plan(NFFT/2);
+    dct = make_plan(MELS);
+    window.resize(FRAME);
+    for(int n=0; n<FRAME; n++)
+        window[n] = 0.54 - 0.46 * cos(2*M_PI*n/(FRAME-1));
+    split.resize(NFFT/2 + 1);
+    for(int k=0; k<=NFFT/2; k++)
+        split[k] = cexpn(-2*M_PI*k/NFFT);
+    shift.resize(CEPS);
+    for(int k=0; k<CEPS; k++)
+        shift[k] = cexpn(-M_PI*k/(2*MELS));
+
+    int K = NFFT/2 + 1;                        // Keep only the non-zero weights;
+    vector<float> w = mel_bank();
+    for(int j=0; j<MELS; j++) {
+        int k0 = 0, k1 = K;
+        while(k0 < K && w[j*K + k0] == 0)
+            k0++;
+        while(k1 > k0 && w[j*K + k1 - 1] == 0)
+            k1--;
+        first.push_back(k0);
+        start.push_back(weights.size());
+        for(int k=k0; k<k1; k++)
+            weights.push_back(w[j*K + k]);
+    }
+    start.push_back(weights.size());
+
+    re.resize(NFFT/2 * BATCH);
+    im.resize(NFFT/2 * BATCH);
+    power.resize(K * BATCH);
+    dre.resize(MELS * BATCH);
+    dim.resize(MELS * BATCH);
+}
+
+
+/**************************************************************************************************
+ * Method: MFCC::batch
+ *   Computes the coefficients of a batch of frames.
+ *
+ * Parameters:
+ *   frames
+ *     Pointers to the first sample of every frame;
+ *   B
+ *     Number of frames. It can't be greater than BATCH;
+ *   y
+ *     Receives CEPS coefficients of every frame, one frame after the other.
+ **************************************************************************************************/
+void MFCC::batch(float *frames[], int B, float y[])
+{
+    int H = NFFT / 2;
+    for(int n=0; n<H; n++) {                   // Window and pack the real frames, in bit-reversed
+        int l = half.rev[n] * B;               //   order;
+        for(int b=0; b<B; b++) {
+            re[l+b] = (2*n < FRAME) ? frames[b][2*n] * window[2*n] : 0;
+            im[l+b] = (2*n+1 < FRAME) ? frames[b][2*n+1] * window[2*n+1] : 0;
+        }
+    }
+    batch_fft(half, re.data(), im.data(), B);
+
+    for(int k=0; k<=H; k++) {                  // Split the spectrum and compute the power;
+        float *ar = &re[(k % H)*B], *ai = &im[(k % H)*B];
+        float *cr = &re[((H - k) % H)*B], *ci = &im[((H - k) % H)*B];
+        float *p = &power[k*B];
+        Complex w = split[k];
+        for(int b=0; b<B; b++) {               // This loop is vectorized;
+            float er = 0.5 * (ar[b] + cr[b]), ei = 0.5 * (ai[b] - ci[b]);
+            float or_ = 0.5 * (ai[b] + ci[b]), oi = -0.5 * (ar[b] - cr[b]);
+            float xr = er + w.r*or_ - w.i*oi;
+            float xi = ei + w.r*oi + w.i*or_;
+            p[b] = xr*xr + xi*xi;
+        }
+    }
+
+    for(int j=0; j<MELS; j++) {                // Bands and logarithm, written in the order of the
+        int l = dct.rev[(j % 2 == 0) ? j/2 : MELS - 1 - j/2] * B;
+        float *d = &dre[l];                    //   DCT reordering;
+        for(int b=0; b<B; b++)
+            d[b] = 0;
+        for(int i=start[j]; i<start[j+1]; i++) {
+            float w = weights[i], *p = &power[(first[j] + i - start[j])*B];
+            for(int b=0; b<B; b++)             // This loop is vectorized;
+                d[b] += w * p[b];
+        }
+        for(int b=0; b<B; b++)
+            d[b] = log(fmax(d[b], FLOOR));
+        for(int b=0; b<B; b++)
+            dim[l+b] = 0;
+    }
+    batch_fft(dct, dre.data(), dim.data(), B);
+
+    for(int k=0; k<CEPS; k++)                  // Phase shift of the DCT;
+        for(int b=0; b<B; b++)
+            y[b*CEPS + k] = dre[k*B + b] * shift[k].r - dim[k*B + b] * shift[k].i;
+}
+
+
+/**************************************************************************************************
+ * Method: MFCC::process
+ *   Computes the coefficients of a number of frames in a number of streams. The frames of every
+ *   stream are processed in batches, and a batch can take frames from different streams.
+ *
+ * Parameters:
+ *   x
+ *     Pointers to the streams. Every stream must have (F-1)*HOP + FRAME samples;
+ *   S
+ *     Number of streams;
+ *   F
+ *     Number of frames in every stream;
+ *   y
+ *     Receives CEPS coefficients of every frame; the frame f of the stream s starts at the
+ *     element (s*F + f)*CEPS.
+ **************************************************************************************************/
+void MFCC::process(float *x[], int S, int F, float y[])
+{
+    float *frames[BATCH];
+    long total = (long) S * F;
+    for(long i0=0; i0<total; i0+=BATCH) {
+        int B = min((long) BATCH, total - i0);
+        for(int b=0; b<B; b++)                 // Frames of the batch;
+            frames[b] = x[(i0 + b) / F] + ((i0 + b) % F) * HOP;
+        batch(frames, B, y + i0*CEPS);
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: simple_mfcc
+ *   Computes the coefficients frame by frame, with a complex FFT of the whole length, the dense
+ *   matrix of weights and the DCT computed directly from its definition. It is used as a
+ *   reference.
+ *
+ * Parameters:
+ *   x
+ *     Pointers to the streams;
+ *   S, F
+ *     Number of streams and of frames in every stream;
+ *   y
+ *     Receives the coefficients, with the same layout used in the MFCC class.
+ **************************************************************************************************/
+void simple_mfcc(float *x[], int S, int F, float y[])
+{
+    Plan plan = make_plan(NFFT);
+    vector<float> w = mel_bank();
+    int K = NFFT/2 + 1;
+    for(int s=0; s<S; s++)
+        for(int f=0; f<F; f++) {
+            vector<Complex> z(NFFT), Z(NFFT);
+            float *frame = x[s] + f*HOP;
+            for(int n=0; n<FRAME; n++)
+                z[n] = Complex(frame[n] * (0.54 - 0.46 * cos(2*M_PI*n/(FRAME-1))), 0);
+            fft(plan, z.data(), Z.data());
+            vector<float> e(MELS);
+            for(int j=0; j<MELS; j++) {
+                float acc = 0;
+                for(int k=0; k<K; k++)
+                    acc += w[j*K + k] * (Z[k].r*Z[k].r + Z[k].i*Z[k].i);
+                e[j] = log(fmax(acc, FLOOR));
+            }
+            for(int k=0; k<CEPS; k++) {
+                float acc = 0;
+                for(int j=0; j<MELS; j++)
+                    acc += e[j] * cos(M_PI*k*(2*j + 1)/(2*MELS));
+                y[((long) s*F + f)*CEPS + k] = acc;
+            }
+        }
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: measure
+ *   Measures the time per frame to compute the coefficients of one second of a number of streams,
+ *   with the simple function and with the MFCC class.
+ *
+ * Parameters:
+ *  S
+ *    Number of streams;
+ *  times
+ *    Receives the two times.
+ *
+ * Returns:
+ *   The largest difference between the coefficients computed by both methods.
+ **************************************************************************************************/
+float measure(int S, float times[])
+{
+    int F = (RATE - FRAME) / HOP + 1;          // Frames in one second;
+    vector<vector<float>> data(S, vector<float>(RATE));
+    vector<float *> x(S);
+    for(int s=0; s<S; s++) {                   // Tones and some noise;
+        for(int n=0; n<RATE; n++)
+            data[s][n] = sin(2*M_PI*(300 + 50*s)*n/RATE) + 0.001 * ((n*7919 + s) % 101 - 50);
+        x[s] = data[s].data();
+    }
+    vector<float> y1((long) S*F*CEPS), y2((long) S*F*CEPS);
+    MFCC mfcc;
+
+    for(int i=0; i<2; i++) {
+        auto t0 = chrono::steady_clock::now(); // Start counting time;
+        for(int r=0; r<REPEAT; r++)
+            if(i == 0)
+                simple_mfcc(x.data(), S, F, y1.data());
+            else
+                mfcc.process(x.data(), S, F, y2.data());
+        auto t1 = chrono::steady_clock::now(); // End of time measuring;
+        times[i] = chrono::duration<float>(t1 - t0).count() / ((long) REPEAT * S * F);
+    }
+
+    float error = 0;
+    for(long j=0; j<(long) y1.size(); j++)
+        error = fmax(error, fabs(y1[j] - y2[j]));
+    return error;
+}
+
+
+/**************************************************************************************************
+ Main Function:
+ **************************************************************************************************/
+int main(int argc, char *argv[]) {
+
+    // Start by printing the table with time comparisons:
+    cout << "+---------+---------+---------+---------+" << endl;
+    cout << "| Streams | Simple  |  MFCC   | Error   |" << endl;
+    cout << "+---------+---------+---------+---------+" << endl;
+
+    // Try it with the number of streams ranging from 1 to 64:
+    for(int r=0; r<7; r++) {
+
+        // Compute the average execution time per frame:
+        int S = (int) exp2(r);
+        float times[2];
+        float error = measure(S, times);
+
+        // Print the results:
+        cout << "| " << setw(7) <<     S << " ";
+        cout << "| " << setw(7) << setprecision(7) << times[0] << " ";
+        cout << "| " << setw(7) << setprecision(7) << times[1] << " ";
+        cout << "| " << setw(7) << setprecision(7) << error << " |" << endl;
+    }
+
+    cout << "+---------+---------+---------+---------+" << endl;
+    return 0;
+}
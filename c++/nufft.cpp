@@ -0,0 +1,583 @@
+/**************************************************************************************************
+ * Fast Fourier Transform -- C++ Version
+ * This version implements the non-uniform FFT (NUFFT), of type 1 and type 2.
+ *
+ * José Alexandre Nalon
+ **************************************************************************************************
+ * This program doesn't need much to be compiled and run. It can be done, as far as I know, with
+ * any C++ compiler, just remember to link the math and threads libraries. Optimizations should be
+ * turned on, so the compiler can vectorize the inner loops. In my box, I used the command:
+ *
+ * $ g++ -O3 -march=native -o nufft nufft.cpp -lm -lpthread
+ *
+ * It can be run with the command (remember to change permission to execute):
+ *
+ * $ ./nufft
+ *
+ * Obs.: When the samples are not equally spaced, the Fourier transform can't be computed by the
+ *   FFT directly. The transform of type 1 takes M samples c[j] in arbitrary points x[j] of the
+ *   interval [-pi, pi) and computes the N coefficients
+ *
+ *     f[k] = sum_j c[j] exp(-i k x[j]),  for -N/2 <= k < N/2
+ *
+ *   and the transform of type 2 is the opposite, computing the samples in the points from the
+ *   coefficients. Computing the sums directly takes O(NM) operations. The NUFFT spreads every
+ *   sample over a few points of a regular grid with twice the length, using a narrow kernel (the
+ *   "exponential of semicircle", exp(beta (sqrt(1 - z^2) - 1))); computes the FFT of the grid;
+ *   and divides the result by the transform of the kernel, to undo the spreading. The width of
+ *   the kernel is chosen from the tolerance asked by the user: every extra point in the kernel
+ *   gives about one more digit of precision. The spreading is split among threads, each one with
+ *   its own grid.
+ **************************************************************************************************/
+
+/**************************************************************************************************
+ Include necessary libraries:
+ **************************************************************************************************/
+#include <iostream>                            // Input and Output;
+#include <iomanip>                             // I/O Manipulation;
+#include <cmath>                               // Math Functions;
+#include <chrono>                              // Time measurement;
+#include <vector>                              // Buffers;
+#include <functional>                          // Work given to threads;
+#include <thread>                              // Threads;
+
+using namespace std;
+
+
+/**************************************************************************************************
+ Definitions:
+ **************************************************************************************************/
+#define REPEAT 50                              // Number of executions to compute average time;
+#define TOLERANCE 1e-5                         // Tolerance used in the comparisons;
+#define MAX_WIDTH 9                            // Largest width of the kernel (7 digits in float);
+
+
+/**************************************************************************************************
+ Small class to operate with complex numbers:
+ **************************************************************************************************/
+class Complex {
+    public:
+        float r;                               // Real part;
+        float i;                               // Imaginary part;
+        Complex();                             // Constructors;
+        Complex(float re, float im);
+        void set(float re, float im);
+        void set(Complex c);
+        Complex operator+(Complex c);          // Addition (overload + operator);
+        Complex operator-(Complex c);          // Subtraction (overload - operator);
+        Complex operator*(Complex c);          // Product (overload * operator);
+        Complex operator*(float a);            // Product with a scalar;
+        Complex cexp();                        // Complex exponential;
+};
+
+Complex::Complex() {                           // Constructor;
+    r = 0.0;                                   // Real part;
+    i = 0.0;                                   // Imaginary part;
+}
+
+Complex::Complex(float re, float im) {         // Constructor;
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(float re, float im) {
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(Complex c) {
+    r = c.r;                                   // Real part;
+    i = c.i;                                   // Imaginary part;
+}
+
+Complex Complex::operator+(Complex c) {
+    return Complex(r + c.r, i + c.i);
+}
+
+Complex Complex::operator-(Complex c) {
+    return Complex(r - c.r, i - c.i);
+}
+
+Complex Complex::operator*(Complex c) {
+    return Complex(r*c.r - i*c.i, r*c.i + i*c.r);
+}
+
+Complex Complex::operator*(float a) {
+    return Complex(a*r, a*i);
+}
+
+Complex Complex::cexp() {
+    return Complex(exp(r)*cos(i), exp(r)*sin(i));
+}
+
+Complex cexpn(float a) {                       // Convenience function to compute the exponential;
+    return Complex(cos(a), sin(a));
+}
+
+
+/**************************************************************************************************
+ * Function: bit_reverse
+ *   Bit-reversed version of an integer number.
+ *
+ * Parameters:
+ *   k
+ *     The number to be bit-reversed;
+ *   r
+ *     The number of bits to take into consideration when reversing.
+ *
+ * Returns:
+ *   The number k, bit-reversed according to integers with r bits.
+ **************************************************************************************************/
+int bit_reverse(int k, int r)
+{
+    int l = 0;                                 // Accumulate the results;
+    for(int i=0; i<r; i++) {                   // Loop on every bit;
+        l = (l << 1) + (k & 1);                // Test less signficant bit and add;
+        k >>= 1;                               // Test next bit;
+    }
+    return l;
+}
+
+
+/**************************************************************************************************
+ * Function: fft
+ *   Fast Fourier Transform using an iterative in-place decimation in time algorithm, with the
+ *   twiddle factors taken from a table. The inverse transform is computed by conjugation, and it
+ *   is not divided by N.
+ *
+ * Parameters:
+ *   x
+ *     The vector of which the FFT will be computed. It must have a power of two length;
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call, and it can't be the same as the input;
+ *   W
+ *     Table of twiddle factors, W[n] = exp(-2 pi n/N), for n from 0 to N/2;
+ *   N
+ *     The number of elements in the vector;
+ *   inverse
+ *     If true, computes the inverse transform.
+ **************************************************************************************************/
+void fft(Complex x[], Complex X[], Complex W[], int N, bool inverse)
+{
+    int r = (int) floor(log2(N));              // Number of bits;
+    for(int k=0; k<N; k++) {                   // Reorder the vector according to the
+        int l = bit_reverse(k, r);             //   bit-reversed order;
+        X[l] = inverse ? Complex(x[k].r, -x[k].i) : x[k];
+    }
+
+    for(int step=1; step<N; step<<=1) {
+        int stride = N / (2*step);             // Distance between twiddle factors in the table;
+        for(int l=0; l<N; l+=2*step)
+            for(int n=0; n<step; n++) {
+                int p = l + n;
+                int q = p + step;
+                Complex w = W[n*stride] * X[q];
+                X[q] = X[p] - w;               // Recombine results;
+                X[p] = X[p] + w;
+            }
+    }
+
+    if(inverse)                                // Conjugate back;
+        for(int k=0; k<N; k++)
+            X[k].i = -X[k].i;
+}
+
+
+/**************************************************************************************************
+ * Function: direct_nudft
+ *   Non-uniform discrete Fourier transform directly from the definition, an algorithm that has
+ *   O(NM) complexity.
+ *
+ * Parameters:
+ *   x
+ *     The points, in the interval [-pi, pi);
+ *   c
+ *     The samples in the points (type 1), or the vector that will receive them (type 2);
+ *   M
+ *     The number of points;
+ *   f
+ *     The vector that will receive the coefficients (type 1), or the coefficients (type 2).
+ *     Coefficient k is stored in f[k + N/2];
+ *   N
+ *     The number of coefficients;
+ *   type
+ *     The type of the transform, 1 or 2.
+ **************************************************************************************************/
+void direct_nudft(float x[], Complex c[], int M, Complex f[], int N, int type)
+{
+    if(type == 1)
+        for(int k=0; k<N; k++) {
+            f[k] = Complex(0, 0);
+            for(int j=0; j<M; j++)
+                f[k] = f[k] + c[j] * cexpn(-(k - N/2) * x[j]);
+        }
+    else
+        for(int j=0; j<M; j++) {
+            c[j] = Complex(0, 0);
+            for(int k=0; k<N; k++)
+                c[j] = c[j] + f[k] * cexpn((k - N/2) * x[j]);
+        }
+}
+
+
+/**************************************************************************************************
+ * Function: reference_nudft
+ *   The same as direct_nudft, but computed in double precision, to be used as the reference when
+ *   the errors are measured (the errors of direct_nudft in single precision are about as large as
+ *   the tolerance asked to the NUFFT).
+ *
+ * Parameters:
+ *   The same of direct_nudft.
+ **************************************************************************************************/
+void reference_nudft(float x[], Complex c[], int M, Complex f[], int N, int type)
+{
+    if(type == 1)
+        for(int k=0; k<N; k++) {
+            double sr = 0, si = 0;
+            for(int j=0; j<M; j++) {
+                double a = -(k - N/2) * (double) x[j];
+                sr += c[j].r * cos(a) - c[j].i * sin(a);
+                si += c[j].r * sin(a) + c[j].i * cos(a);
+            }
+            f[k] = Complex(sr, si);
+        }
+    else
+        for(int j=0; j<M; j++) {
+            double sr = 0, si = 0;
+            for(int k=0; k<N; k++) {
+                double a = (k - N/2) * (double) x[j];
+                sr += f[k].r * cos(a) - f[k].i * sin(a);
+                si += f[k].r * sin(a) + f[k].i * cos(a);
+            }
+            c[j] = Complex(sr, si);
+        }
+}
+
+
+/**************************************************************************************************
+ Class that implements the NUFFT for a given number of coefficients and tolerance. Everything that
+ doesn't depend on the points or samples is computed when the object is created:
+ **************************************************************************************************/
+class NUFFT {
+    public:
+        NUFFT(int N, float tolerance, int threads);
+        void type1(float x[], Complex c[], int M, Complex f[]);
+        void type2(float x[], Complex c[], int M, Complex f[]);
+    private:
+        int N;                                 // Number of coefficients;
+        int n;                                 // Length of the grid;
+        int w;                                 // Width of the kernel, in points of the grid;
+        float beta;                            // Shape of the kernel;
+        int threads;                           // Number of threads;
+        vector<Complex> W;                     // Twiddle factors of the grid;
+        vector<float> correction;              // Inverse of the transform of the kernel;
+        float kernel(float z);
+        int weights(float x, float k[]);
+};
+
+
+/**************************************************************************************************
+ * Method: NUFFT::NUFFT
+ *   Creates the transform. The grid has at least twice the number of coefficients, the width of
+ *   the kernel is two points more than the number of digits asked, and the transform of the
+ *   kernel is computed by numerical integration.
+ *
+ * Parameters:
+ *   N
+ *     The number of coefficients. It must be even;
+ *   tolerance
+ *     The relative precision asked by the user;
+ *   threads
+ *     The number of threads used in the spreading.
+ **************************************************************************************************/
+NUFFT::NUFFT(int N, float tolerance, int threads)
+{
+    this->N = N;
+    this->threads = threads;
+    w = (int) ceil(-log10(tolerance)) + 2;     // Width and shape of the kernel;
+    w = max(2, min(MAX_WIDTH, w));
+    beta = 2.30 * w;
+    n = 1;
+    while(n < 2*N || n < 2*w)                  // Oversampled grid;
+        n <<= 1;
+
+    W.resize(n/2 + 1);
+    for(int k=0; k<=n/2; k++)                  // Twiddle factors computed directly;
+        W[k] = cexpn(-2*M_PI*k/n);
+
+    int Q = 4 * w + 40;                        // Points of the integration;
+    float alpha = M_PI * w / n;                // Half width of the kernel, in radians;
+    correction.resize(N);
+    for(int k=0; k<N; k++) {                   // Transform of the kernel, midpoint rule;
+        double s = 0;
+        for(int q=0; q<Q; q++) {
+            double z = (q + 0.5) / Q;
+            s = s + kernel(z) * cos((k - N/2) * alpha * z);
+        }
+        double h = 2 * M_PI / n;               // Spacing of the grid;
+        correction[k] = h / (2 * alpha * s / Q);
+    }
+}
+
+
+/**************************************************************************************************
+ * Method: NUFFT::kernel
+ *   The exponential of semicircle kernel.
+ *
+ * Parameters:
+ *   z
+ *     Position, normalized so that the kernel is zero outside [-1, 1].
+ *
+ * Returns:
+ *   The value of the kernel.
+ **************************************************************************************************/
+float NUFFT::kernel(float z)
+{
+    if(fabs(z) >= 1)
+        return 0;
+    return exp(beta * (sqrt(1 - z*z) - 1));
+}
+
+
+/**************************************************************************************************
+ * Method: NUFFT::weights
+ *   Computes the values of the kernel in the points of the grid around a given point. The values
+ *   are computed in two passes, so the second one (with the exponentials) can be vectorized. The
+ *   position in the grid is computed in double precision: in single precision its rounding error
+ *   grows with the length of the grid, and the error of the transform grows with it.
+ *
+ * Parameters:
+ *   x
+ *     The point, in the interval [-pi, pi);
+ *   k
+ *     Receives the w values of the kernel.
+ *
+ * Returns:
+ *   The index of the first point of the grid (it can be negative, and must be taken modulo n).
+ **************************************************************************************************/
+int NUFFT::weights(float x, float k[])
+{
+    double t = x * n / (2*M_PI);               // Position in units of the grid;
+    int l0 = (int) ceil(t - w/2.0);
+    float z[MAX_WIDTH];
+    for(int m=0; m<w; m++) {
+        float u = (l0 + m - t) / (w/2.0);
+        z[m] = fmax(0, 1 - u*u);
+    }
+    for(int m=0; m<w; m++)                     // This loop is vectorized;
+        k[m] = exp(beta * (sqrt(z[m]) - 1));
+    return l0;
+}
+
+
+/**************************************************************************************************
+ * Method: NUFFT::type1
+ *   Computes the transform of type 1, from the samples to the coefficients. Every thread spreads
+ *   a part of the samples over its own grid, and the grids are added at the end.
+ *
+ * Parameters:
+ *   x
+ *     The points, in the interval [-pi, pi);
+ *   c
+ *     The samples in the points;
+ *   M
+ *     The number of points;
+ *   f
+ *     The vector that will receive the coefficients. Coefficient k is stored in f[k + N/2].
+ **************************************************************************************************/
+void NUFFT::type1(float x[], Complex c[], int M, Complex f[])
+{
+    int T = max(1, min(threads, M / 1024));   // Small problems are not worth the threads;
+    vector<vector<Complex>> grids(T, vector<Complex>(n));
+    vector<thread> workers;
+    for(int t=0; t<T; t++) {
+        auto spread = [&, t] {
+            Complex *g = grids[t].data();
+            float k[MAX_WIDTH];
+            for(int j=t*M/T; j<(t+1)*M/T; j++) {
+                int l0 = weights(x[j], k);
+                for(int m=0; m<w; m++) {
+                    int l = (l0 + m) & (n-1);  // Periodic grid;
+                    g[l] = g[l] + c[j] * k[m];
+                }
+            }
+        };
+        if(t == T-1)
+            spread();
+        else
+            workers.push_back(thread(spread));
+    }
+    for(auto &th : workers)
+        th.join();
+    for(int t=1; t<T; t++)                     // Add the grids;
+        for(int l=0; l<n; l++)
+            grids[0][l] = grids[0][l] + grids[t][l];
+
+    vector<Complex> G(n);
+    fft(grids[0].data(), G.data(), W.data(), n, false);
+    for(int k=0; k<N; k++)                     // Undo the spreading;
+        f[k] = G[(k - N/2) & (n-1)] * correction[k];
+}
+
+
+/**************************************************************************************************
+ * Method: NUFFT::type2
+ *   Computes the transform of type 2, from the coefficients to the samples. The coefficients are
+ *   divided by the transform of the kernel, the grid is computed by an inverse transform, and
+ *   every sample is interpolated from the grid. Samples are split among threads.
+ *
+ * Parameters:
+ *   x
+ *     The points, in the interval [-pi, pi);
+ *   c
+ *     The vector that will receive the samples;
+ *   M
+ *     The number of points;
+ *   f
+ *     The coefficients. Coefficient k is stored in f[k + N/2].
+ **************************************************************************************************/
+void NUFFT::type2(float x[], Complex c[], int M, Complex f[])
+{
+    vector<Complex> G(n), g(n);
+    for(int k=0; k<N; k++)                     // Undo the spreading in advance;
+        G[(k - N/2) & (n-1)] = f[k] * correction[k];
+    fft(G.data(), g.data(), W.data(), n, true);
+
+    int T = max(1, min(threads, M / 1024));
+    vector<thread> workers;
+    for(int t=0; t<T; t++) {
+        auto interpolate = [&, t] {
+            float k[MAX_WIDTH];
+            for(int j=t*M/T; j<(t+1)*M/T; j++) {
+                int l0 = weights(x[j], k);
+                Complex s = Complex(0, 0);
+                for(int m=0; m<w; m++)
+                    s = s + g[(l0 + m) & (n-1)] * k[m];
+                c[j] = s;
+            }
+        };
+        if(t == T-1)
+            interpolate();
+        else
+            workers.push_back(thread(interpolate));
+    }
+    for(auto &th : workers)
+        th.join();
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: relative_error
+ *   Relative error between two vectors, in the euclidean norm.
+ *
+ * Parameters:
+ *   a
+ *     The reference vector;
+ *   b
+ *     The vector to be compared;
+ *   n
+ *     Number of elements in the vectors.
+ *
+ * Returns:
+ *   The norm of the difference, divided by the norm of the reference.
+ **************************************************************************************************/
+float relative_error(Complex a[], Complex b[], int n)
+{
+    double e = 0, s = 0;
+    for(int j=0; j<n; j++) {
+        Complex d = a[j] - b[j];
+        e = e + d.r*d.r + d.i*d.i;
+        s = s + a[j].r*a[j].r + a[j].i*a[j].i;
+    }
+    return sqrt(e / s);
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: time_it
+ *   Measure execution time through repeated calls to a transform, with points randomly spread in
+ *   the interval, and computes its error.
+ *
+ * Parameters:
+ *  type
+ *    Type of the transform: 1 or 2, or 0 for the direct type 1 transform;
+ *  size
+ *    Number of points and of coefficients;
+ *  repeat
+ *    Number of times the function will be called;
+ *  error
+ *    Receives the relative error of the result, compared to the direct transform.
+ *
+ * Returns:
+ *   The average execution time for a transform of the given size.
+ **************************************************************************************************/
+float time_it(int type, int size, int repeat, float &error)
+{
+    // Two threads at least, so the threaded paths are checked even in a box with one core:
+    int threads = max(2, (int) thread::hardware_concurrency());
+    vector<float> x(size);
+    vector<Complex> c(size), f(size), r(size);
+    srand(size);
+    for(int j=0; j<size; j++) {                // Random points and values;
+        x[j] = 2*M_PI * rand() / (RAND_MAX + 1.0) - M_PI;
+        c[j] = Complex(j % 7 - 3, j % 5 - 2);
+        f[j] = c[j];
+    }
+    NUFFT nufft(size, TOLERANCE, threads);
+
+    auto t0 = chrono::steady_clock::now();     // Start counting time;
+    for(int j=0; j<repeat; j++)
+        if(type == 0)
+            direct_nudft(x.data(), c.data(), size, f.data(), size, 1);
+        else if(type == 1)
+            nufft.type1(x.data(), c.data(), size, f.data());
+        else
+            nufft.type2(x.data(), c.data(), size, f.data());
+    auto t1 = chrono::steady_clock::now();     // End of time measuring;
+
+    if(type == 2) {
+        reference_nudft(x.data(), r.data(), size, f.data(), size, 2);
+        error = relative_error(r.data(), c.data(), size);
+    } else {
+        reference_nudft(x.data(), c.data(), size, r.data(), size, 1);
+        error = relative_error(r.data(), f.data(), size);
+    }
+    return chrono::duration<float>(t1 - t0).count() / repeat;
+}
+
+
+/**************************************************************************************************
+ Main Function:
+ **************************************************************************************************/
+int main(int argc, char *argv[]) {
+
+    // Start by printing the table with time comparisons:
+    cout << "+---------+---------+---------+---------+---------+---------+" << endl;
+    cout << "|    N    | Direct  | Type 1  | Error 1 | Type 2  | Error 2 |" << endl;
+    cout << "+---------+---------+---------+---------+---------+---------+" << endl;
+
+    // Try it with vectors with size ranging from 32 to 4096 samples (from 2048 samples on, the
+    // spreading is split among threads):
+    for(int r=5; r<13; r++) {
+
+        // Compute the average execution time and errors. The direct transform of the largest
+        // sizes is too slow to be repeated:
+        int n = (int) exp2(r);
+        float e0, e1, e2;
+        float dtime = time_it(0, n, n <= 1024 ? REPEAT : 1, e0);
+        float time1 = time_it(1, n, REPEAT, e1);
+        float time2 = time_it(2, n, REPEAT, e2);
+
+        // Print the results:
+        cout << "| " << setw(7) <<     n << " ";
+        cout << "| " << setw(7) << setprecision(7) << dtime << " ";
+        cout << "| " << setw(7) << setprecision(7) << time1 << " ";
+        cout << "| " << setw(7) << setprecision(7) << e1 << " ";
+        cout << "| " << setw(7) << setprecision(7) << time2 << " ";
+        cout << "| " << setw(7) << setprecision(7) << e2 << " |" << endl;
+    }
+
+    cout << "+---------+---------+---------+---------+---------+---------+" << endl;
+    return 0;
+}
@@ -0,0 +1,671 @@
+/**************************************************************************************************
+ * Fast Fourier Transform -- C++ Version
+ * This version implements a spectral solver for the Poisson and Helmholtz equations in 3D grids.
+ *
+ * José Alexandre Nalon
+ **************************************************************************************************
+ * This program doesn't need much to be compiled and run. It can be done, as far as I know, with
+ * any C++ compiler, just remember to link the math and threads libraries. Optimizations should be
+ * turned on, so the compiler can vectorize the inner loops. In my box, I used the command:
+ *
+ * $ g++ -O3 -march=native -o poisson poisson.cpp -lm -lpthread
+ *
+ * It can be run with the command (remember to change permission to execute):
+ *
+ * $ ./poisson
+ *
+ * Obs.: The equation lap(u) - lambda u = f (the Poisson equation if lambda is zero) becomes a
+ *   division in the frequency domain, since the complex exponentials are eigenfunctions of the
+ *   laplacian: for a periodic grid, the spectrum of u is the spectrum of f divided by
+ *   -(kx^2 + ky^2 + kz^2) - lambda. The grid is real, so the transform along z is computed with
+ *   a complex FFT of half the length, and the transforms along y and x are computed for every
+ *   bin at the same time, with the butterflies applied to whole rows of bins, so the innermost
+ *   loop can be vectorized. The work is split in slabs among threads: the transforms along z
+ *   and y are computed slab by slab, and the transform along x, the division and the inverse
+ *   transform along x are computed together, plane by plane, while the plane is in the cache.
+ *   The solver keeps the plans and the buffers, so it can be used in every step of a simulation.
+ *   For boundaries where the derivative is zero (Neumann conditions), the cosines are the
+ *   eigenfunctions of the discrete laplacian, so the same is done with the discrete cosine
+ *   transform (DCT), computed with complex FFTs of the same length, two real lines at a time.
+ **************************************************************************************************/
+
+/**************************************************************************************************
+ Include necessary libraries:
+ **************************************************************************************************/
+#include <iostream>                            // Input and Output;
+#include <iomanip>                             // I/O Manipulation;
+#include <cmath>                               // Math Functions;
+#include <chrono>                              // Time measurement;
+#include <vector>                              // Buffers;
+#include <functional>                          // Work given to threads;
+#include <thread>                              // Threads;
+
+using namespace std;
+
+
+/**************************************************************************************************
+ Definitions:
+ **************************************************************************************************/
+#define REPEAT 4                               // Number of executions to compute average time;
+#define LAMBDA 0                               // Helmholtz constant used in the tests;
+
+
+/**************************************************************************************************
+ Small class to operate with complex numbers:
+ **************************************************************************************************/
+class Complex {
+    public:
+        float r;                               // Real part;
+        float i;                               // Imaginary part;
+        Complex();                             // Constructors;
+        Complex(float re, float im);
+        void set(float re, float im);
+        void set(Complex c);
+        Complex operator+(Complex c);          // Addition (overload + operator);
+        Complex operator-(Complex c);          // Subtraction (overload - operator);
+        Complex operator*(Complex c);          // Product (overload * operator);
+        Complex operator*(float a);            // Product with a scalar;
+        Complex cexp();                        // Complex exponential;
+};
+
+Complex::Complex() {                           // Constructor;
+    r = 0.0;                                   // Real part;
+    i = 0.0;                                   // Imaginary part;
+}
+
+Complex::Complex(float re, float im) {         // Constructor;
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(float re, float im) {
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(Complex c) {
+    r = c.r;                                   // Real part;
+    i = c.i;                                   // Imaginary part;
+}
+
+Complex Complex::operator+(Complex c) {
+    return Complex(r + c.r, i + c.i);
+}
+
+Complex Complex::operator-(Complex c) {
+    return Complex(r - c.r, i - c.i);
+}
+
+Complex Complex::operator*(Complex c) {
+    return Complex(r*c.r - i*c.i, r*c.i + i*c.r);
+}
+
+Complex Complex::operator*(float a) {
+    return Complex(a*r, a*i);
+}
+
+Complex Complex::cexp() {
+    return Complex(exp(r)*cos(i), exp(r)*sin(i));
+}
+
+Complex cexpn(float a) {                       // Convenience function to compute the exponential;
+    return Complex(cos(a), sin(a));
+}
+
+
+/**************************************************************************************************
+ * Function: bit_reverse
+ *   Bit-reversed version of an integer number.
+ *
+ * Parameters:
+ *   k
+ *     The number to be bit-reversed;
+ *   r
+ *     The number of bits to take into consideration when reversing.
+ *
+ * Returns:
+ *   The number k, bit-reversed according to integers with r bits.
+ **************************************************************************************************/
+int bit_reverse(int k, int r)
+{
+    int l = 0;                                 // Accumulate the results;
+    for(int i=0; i<r; i++) {                   // Loop on every bit;
+        l = (l << 1) + (k & 1);                // Test less signficant bit and add;
+        k >>= 1;                               // Test next bit;
+    }
+    return l;
+}
+
+
+/**************************************************************************************************
+ Plans hold everything that depends only on the length of the transform:
+ **************************************************************************************************/
+struct Plan {
+    int N;                                     // Length of the transform;
+    vector<int> rev;                           // Bit-reversed indices;
+    vector<Complex> W;                         // Twiddle factors, W[n] = exp(-2 pi n/N);
+};
+
+
+/**************************************************************************************************
+ * Function: make_plan
+ *   Computes the plan for a given length.
+ *
+ * Parameters:
+ *   N
+ *     The length of the transform. It must be a power of two.
+ *
+ * Returns:
+ *   The plan.
+ **************************************************************************************************/
+Plan make_plan(int N)
+{
+    Plan plan;
+    plan.N = N;
+    int r = (int) floor(log2(N));              // Number of bits;
+    plan.rev.resize(N);
+    for(int k=0; k<N; k++)                     // Bit-reversed order;
+        plan.rev[k] = bit_reverse(k, r);
+    plan.W.resize(N/2 + 1);
+    for(int n=0; n<=N/2; n++)                  // Twiddle factors computed directly;
+        plan.W[n] = cexpn(-2*M_PI*n/N);
+    return plan;
+}
+
+
+/**************************************************************************************************
+ * Function: fft
+ *   Fast Fourier Transform using an iterative in-place decimation in time algorithm, with the
+ *   twiddle factors taken from the plan.
+ *
+ * Parameters:
+ *   plan
+ *     Plan for the length of the transform;
+ *   x
+ *     The vector of which the FFT will be computed;
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call, and it can't be the same as the input.
+ **************************************************************************************************/
+void fft(Plan &plan, Complex x[], Complex X[])
+{
+    int N = plan.N;
+    for(int k=0; k<N; k++)                     // Reorder the vector according to the
+        X[plan.rev[k]] = x[k];                 //   bit-reversed order;
+
+    for(int step=1; step<N; step<<=1) {
+        int stride = N / (2*step);             // Distance between twiddle factors in the table;
+        for(int l=0; l<N; l+=2*step)
+            for(int n=0; n<step; n++) {
+                int p = l + n;
+                int q = p + step;
+                Complex w = plan.W[n*stride] * X[q];
+                X[q] = X[p] - w;               // Recombine results;
+                X[p] = X[p] + w;
+            }
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: rows
+ *   Transforms, in place, every column of a set of rows: the rows are separated by a given
+ *   distance, and the element c of the row r is in re[r*stride + c] and im[r*stride + c]. The
+ *   rows are reordered in bit-reversed order, and the butterflies combine whole rows, so the
+ *   innermost loop can be vectorized.
+ *
+ * Parameters:
+ *   plan
+ *     Plan for the number of rows;
+ *   re, im
+ *     Real and imaginary parts of the first row;
+ *   stride
+ *     Distance between rows;
+ *   C
+ *     Number of elements in every row;
+ *   inverse
+ *     If true, computes the inverse transform (not divided by the number of rows).
+ **************************************************************************************************/
+void rows(Plan &plan, float re[], float im[], long stride, int C, bool inverse)
+{
+    int P = plan.N;
+    for(int r=0; r<P; r++) {                   // Bit-reversed order of rows;
+        int l = plan.rev[r];
+        if(l > r)
+            for(int c=0; c<C; c++) {
+                swap(re[r*stride + c], re[l*stride + c]);
+                swap(im[r*stride + c], im[l*stride + c]);
+            }
+    }
+
+    for(int step=1; step<P; step<<=1) {
+        int skip = P / (2*step);
+        for(int l=0; l<P; l+=2*step)
+            for(int n=0; n<step; n++) {
+                Complex W = plan.W[n*skip];
+                float wi = inverse ? -W.i : W.i;
+                float *pr = &re[(l+n)*stride], *pi = &im[(l+n)*stride];
+                float *qr = &re[(l+n+step)*stride], *qi = &im[(l+n+step)*stride];
+                for(int c=0; c<C; c++) {       // This loop is vectorized;
+                    float tr = W.r*qr[c] - wi*qi[c];
+                    float ti = W.r*qi[c] + wi*qr[c];
+                    qr[c] = pr[c] - tr;        // Recombine results;
+                    qi[c] = pi[c] - ti;
+                    pr[c] = pr[c] + tr;
+                    pi[c] = pi[c] + ti;
+                }
+            }
+    }
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: parallel_for
+ *   Splits a range of indices among a number of threads, and waits for all of them.
+ *
+ * Parameters:
+ *   n
+ *     Number of indices; they range from 0 to n-1;
+ *   threads
+ *     Number of threads;
+ *   f
+ *     Function to be called by every thread, with the first and one past the last index.
+ **************************************************************************************************/
+void parallel_for(int n, int threads, function<void(int, int)> f)
+{
+    vector<thread> workers;
+    int per = (n + threads - 1) / threads;
+    for(int i=per; i<n; i+=per)                // First part is computed by this thread;
+        workers.push_back(thread(f, i, min(n, i + per)));
+    f(0, min(n, per));
+    for(auto &w : workers)
+        w.join();
+}
+
+
+/**************************************************************************************************
+ Class that solves the equation in a periodic cubic grid:
+ **************************************************************************************************/
+class Periodic {
+    public:
+        Periodic(int N, float L, float lambda, int threads);
+        void solve(float f[], float u[]);
+    private:
+        int N;                                 // Number of points in every direction;
+        int C;                                 // Number of bins along z, N/2 + 1;
+        int threads;                           // Number of threads;
+        float lambda;                          // Helmholtz constant;
+        Plan full, half;                       // Plans for N and N/2;
+        vector<float> k2;                      // Squared wave numbers, by index;
+        vector<float> re, im;                  // Spectrum;
+};
+
+
+/**************************************************************************************************
+ * Method: Periodic::Periodic
+ *   Computes the plans and allocates the spectrum.
+ *
+ * Parameters:
+ *   N
+ *     Number of points in every direction. It must be a power of two;
+ *   L
+ *     Length of the side of the grid;
+ *   lambda
+ *     Helmholtz constant; zero solves the Poisson equation;
+ *   threads
+ *     Number of threads.
+ **************************************************************************************************/
+Periodic::Periodic(int N, float L, float lambda, int threads)
+{
+    this->N = N;
+    this->C = N/2 + 1;
+    this->lambda = lambda;
+    this->threads = threads;
+    full = make_plan(N);
+    half = make_plan(N/2);
+    k2.resize(N);
+    for(int j=0; j<N; j++) {
+        float k = 2*M_PI * ((j <= N/2) ? j : j - N) / L;
+        k2[j] = k * k;
+    }
+    re.resize((long) N*N*C);
+    im.resize((long) N*N*C);
+}
+
+
+/**************************************************************************************************
+ * Method: Periodic::solve
+ *   Solves the equation. The element (x, y, z) of the grids is in the position (x*N + y)*N + z.
+ *   When lambda is zero, the mean of f is ignored and u has zero mean.
+ *
+ * Parameters:
+ *   f
+ *     The right side of the equation;
+ *   u
+ *     Receives the solution. It can be the same as f.
+ **************************************************************************************************/
+void Periodic::solve(float f[], float u[])
+{
+    int H = N/2;
+    long plane = (long) N*C;                   // Size of a slab of the spectrum;
+
+    // Transforms along z and y, slab by slab:
+    parallel_for(N, threads, [&](int x0, int x1) {
+        vector<Complex> z(H), Z(H + 1);
+        for(int x=x0; x<x1; x++) {
+            for(int y=0; y<N; y++) {
+                float *line = f + ((long) x*N + y)*N;
+                float *r = &re[x*plane + y*C], *i = &im[x*plane + y*C];
+                for(int n=0; n<H; n++)         // Pack the real line;
+                    z[n] = Complex(line[2*n], line[2*n+1]);
+                fft(half, z.data(), Z.data());
+                Z[H] = Z[0];
+                for(int k=0; k<=H; k++) {      // Split the spectrum;
+                    Complex a = Z[k];
+                    Complex b = Complex(Z[H-k].r, -Z[H-k].i);
+                    Complex O = a - b;
+                    Complex X = (a + b) * 0.5 + full.W[k] * Complex(O.i * 0.5, -O.r * 0.5);
+                    r[k] = X.r;
+                    i[k] = X.i;
+                }
+            }
+            rows(full, &re[x*plane], &im[x*plane], C, C, false);
+        }
+    });
+
+    // Transform along x, division and inverse, plane by plane:
+    parallel_for(N, threads, [&](int y0, int y1) {
+        for(int y=y0; y<y1; y++) {
+            rows(full, &re[y*C], &im[y*C], plane, C, false);
+            for(int x=0; x<N; x++) {
+                float *r = &re[x*plane + y*C], *i = &im[x*plane + y*C];
+                float kxy = k2[x] + k2[y] + lambda;
+                for(int k=0; k<C; k++) {       // This loop is vectorized;
+                    float d = kxy + k2[k];
+                    float s = (d == 0) ? 0 : -1 / d;
+                    r[k] *= s;
+                    i[k] *= s;
+                }
+            }
+            rows(full, &re[y*C], &im[y*C], plane, C, true);
+        }
+    });
+
+    // Inverse transforms along y and z, slab by slab:
+    float scale = 1.0 / ((float) N*N*N);
+    parallel_for(N, threads, [&](int x0, int x1) {
+        vector<Complex> Z(H), z(H);
+        for(int x=x0; x<x1; x++) {
+            rows(full, &re[x*plane], &im[x*plane], C, C, true);
+            for(int y=0; y<N; y++) {
+                float *r = &re[x*plane + y*C], *i = &im[x*plane + y*C];
+                for(int k=0; k<H; k++) {       // Join the transforms of even and odd samples,
+                    Complex a = Complex(r[k], i[k]);   //   conjugated for the inverse;
+                    Complex b = Complex(r[H-k], -i[H-k]);
+                    Complex E = a + b;
+                    Complex O = (a - b) * Complex(full.W[k].r, -full.W[k].i);
+                    Z[k] = Complex(E.r - O.i, -(E.i + O.r));
+                }
+                fft(half, Z.data(), z.data());
+                float *line = u + ((long) x*N + y)*N;
+                for(int n=0; n<H; n++) {       // Unpack the real line;
+                    line[2*n] = z[n].r * scale;
+                    line[2*n+1] = -z[n].i * scale;
+                }
+            }
+        }
+    });
+}
+
+
+/**************************************************************************************************
+ Class that solves the equation in a cubic grid with Neumann conditions. The points are in the
+ center of the cells, and the laplacian is the usual second difference, with the grid reflected
+ at the boundaries:
+ **************************************************************************************************/
+class Neumann {
+    public:
+        Neumann(int N, float L, float lambda, int threads);
+        void solve(float f[], float u[]);
+    private:
+        int N;                                 // Number of points in every direction;
+        int threads;                           // Number of threads;
+        float lambda;                          // Helmholtz constant;
+        Plan plan;                             // Plan for N;
+        vector<Complex> shift;                 // Phase shifts, exp(-i pi k/(2N));
+        vector<float> eig;                     // Eigenvalues of the second difference;
+        void dct(float d[], int axis, bool inverse);
+};
+
+
+/**************************************************************************************************
+ * Method: Neumann::Neumann
+ *   Computes the plan and the eigenvalues.
+ *
+ * Parameters:
+ *   N
+ *     Number of points in every direction. It must be a power of two;
+ *   L
+ *     Length of the side of the grid;
+ *   lambda
+ *     Helmholtz constant; zero solves the Poisson equation;
+ *   threads
+ *     Number of threads.
+ **************************************************************************************************/
+Neumann::Neumann(int N, float L, float lambda, int threads)
+{
+    this->N = N;
+    this->lambda = lambda;
+    this->threads = threads;
+    plan = make_plan(N);
+    shift.resize(N);
+    eig.resize(N);
+    float h = L / N;
+    for(int k=0; k<N; k++) {
+        shift[k] = cexpn(-M_PI*k/(2*N));
+        eig[k] = (2*cos(M_PI*k/N) - 2) / (h*h);
+    }
+}
+
+
+/**************************************************************************************************
+ * Method: Neumann::dct
+ *   Computes the DCT (type II, or its inverse, type III) of every line of the grid along one
+ *   axis, in place. Every transform uses a complex FFT of the same length, after reordering the
+ *   samples (even samples first, odd samples reversed, by Makhoul's algorithm); two lines are
+ *   put in the real and imaginary parts of the same FFT, and separated after it. The DCT is
+ *
+ *     X[k] = 2 sum_n x[n] cos(pi k (2n + 1)/(2N))
+ *
+ * Parameters:
+ *   d
+ *     The grid;
+ *   axis
+ *     0 for x, 1 for y, 2 for z;
+ *   inverse
+ *     If true, computes the inverse transform.
+ **************************************************************************************************/
+void Neumann::dct(float d[], int axis, bool inverse)
+{
+    long step = (axis == 0) ? (long) N*N : (axis == 1) ? N : 1;
+    long outer = (axis == 0) ? N : (long) N*N; // Distances between the first elements of the
+    long inner = (axis == 2) ? N : 1;          //   lines, in both other axes;
+    parallel_for(N, threads, [&](int a0, int a1) {
+        vector<Complex> v(N), V(N);
+        for(int a=a0; a<a1; a++)
+            for(int b=0; b<N; b+=2) {
+                float *p = d + a*outer + b*inner;
+                float *q = p + inner;
+                if(!inverse) {
+                    for(int n=0; n<N/2; n++) { // Reorder both lines;
+                        v[n] = Complex(p[2*n*step], q[2*n*step]);
+                        v[N-1-n] = Complex(p[(2*n+1)*step], q[(2*n+1)*step]);
+                    }
+                    fft(plan, v.data(), V.data());
+                    for(int k=0; k<N; k++) {   // Separate the lines and shift the phase;
+                        Complex c = V[(N - k) % N];
+                        Complex A = Complex(V[k].r + c.r, V[k].i - c.i) * 0.5;
+                        Complex B = Complex(V[k].i + c.i, c.r - V[k].r) * 0.5;
+                        p[k*step] = 2 * (A * shift[k]).r;
+                        q[k*step] = 2 * (B * shift[k]).r;
+                    }
+                } else {
+                    for(int k=0; k<N; k++) {   // Undo the phase shift of both lines, conjugated
+                        float ap = p[k*step], bp = q[k*step];  //   to compute the inverse;
+                        float am = (k == 0) ? 0 : p[(N-k)*step], bm = (k == 0) ? 0 : q[(N-k)*step];
+                        Complex s = Complex(shift[k].r, -shift[k].i) * 0.5;
+                        Complex A = s * Complex(ap, -am);
+                        Complex B = s * Complex(bp, -bm);
+                        Complex c = A + Complex(-B.i, B.r);
+                        v[k] = Complex(c.r, -c.i);
+                    }
+                    fft(plan, v.data(), V.data());
+                    for(int n=0; n<N/2; n++) { // Undo the reordering;
+                        p[2*n*step] = V[n].r / N;
+                        q[2*n*step] = -V[n].i / N;
+                        p[(2*n+1)*step] = V[N-1-n].r / N;
+                        q[(2*n+1)*step] = -V[N-1-n].i / N;
+                    }
+                }
+            }
+    });
+}
+
+
+/**************************************************************************************************
+ * Method: Neumann::solve
+ *   Solves the equation. The element (x, y, z) of the grids is in the position (x*N + y)*N + z.
+ *   When lambda is zero, the mean of f is ignored and u has zero mean.
+ *
+ * Parameters:
+ *   f
+ *     The right side of the equation;
+ *   u
+ *     Receives the solution. It can be the same as f.
+ **************************************************************************************************/
+void Neumann::solve(float f[], float u[])
+{
+    if(u != f)
+        for(long j=0; j<(long) N*N*N; j++)
+            u[j] = f[j];
+    for(int axis=2; axis>=0; axis--)
+        dct(u, axis, false);
+    parallel_for(N, threads, [&](int x0, int x1) {
+        for(int x=x0; x<x1; x++)
+            for(int y=0; y<N; y++) {
+                float *r = u + ((long) x*N + y)*N;
+                float exy = eig[x] + eig[y] - lambda;
+                for(int z=0; z<N; z++) {       // This loop is vectorized;
+                    float e = exy + eig[z];
+                    r[z] = (e == 0) ? 0 : r[z] / e;
+                }
+            }
+    });
+    for(int axis=0; axis<3; axis++)
+        dct(u, axis, true);
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: measure
+ *   Solves a problem with known solution with both solvers, and measures the time. For the
+ *   periodic grid, the solution is a product of sines and cosines; for the Neumann conditions,
+ *   the right side is the discrete laplacian of a smooth function, so the solution is exact.
+ *
+ * Parameters:
+ *  N
+ *    Number of points in every direction;
+ *  times
+ *    Receives the time of the periodic solver with one thread and with every thread, and of
+ *    the Neumann solver;
+ *  errors
+ *    Receives the largest errors of both solvers.
+ **************************************************************************************************/
+void measure(int N, float times[], float errors[])
+{
+    long M = (long) N*N*N;
+    float L = 2*M_PI, h = L / N;
+    vector<float> f(M), u(M), e(M);
+    for(int x=0; x<N; x++)                     // Periodic problem;
+        for(int y=0; y<N; y++)
+            for(int z=0; z<N; z++) {
+                long j = ((long) x*N + y)*N + z;
+                e[j] = sin(x*h) * cos(2*y*h) * sin(3*z*h + 1);
+                f[j] = -(1 + 4 + 9 + LAMBDA) * e[j];
+            }
+
+    int all = max(1, (int) thread::hardware_concurrency());
+    for(int i=0; i<2; i++) {
+        Periodic solver(N, L, LAMBDA, (i == 0) ? 1 : all);
+        auto t0 = chrono::steady_clock::now(); // Start counting time;
+        for(int r=0; r<REPEAT; r++)
+            solver.solve(f.data(), u.data());
+        auto t1 = chrono::steady_clock::now(); // End of time measuring;
+        times[i] = chrono::duration<float>(t1 - t0).count() / REPEAT;
+    }
+    errors[0] = 0;
+    for(long j=0; j<M; j++)
+        errors[0] = fmax(errors[0], fabs(u[j] - e[j]));
+
+    double mean = 0;
+    for(int x=0; x<N; x++)                     // Neumann problem;
+        for(int y=0; y<N; y++)
+            for(int z=0; z<N; z++) {
+                long j = ((long) x*N + y)*N + z;
+                e[j] = cos(0.5 * (x + 0.5) * h) + (y + 0.5) * (z + 0.5) * h * h;
+                mean += e[j];
+            }
+    for(long j=0; j<M; j++)                    // Solution with zero mean;
+        e[j] -= mean / M;
+    for(int x=0; x<N; x++)                     // Second differences, reflected at the borders;
+        for(int y=0; y<N; y++)
+            for(int z=0; z<N; z++) {
+                long j = ((long) x*N + y)*N + z;
+                float s = -(6 + LAMBDA*h*h) * e[j];
+                s += e[j + ((x > 0) ? -(long) N*N : 0)] + e[j + ((x < N-1) ? (long) N*N : 0)];
+                s += e[j + ((y > 0) ? -N : 0)] + e[j + ((y < N-1) ? N : 0)];
+                s += e[j + ((z > 0) ? -1 : 0)] + e[j + ((z < N-1) ? 1 : 0)];
+                f[j] = s / (h*h);
+            }
+    Neumann solver(N, L, LAMBDA, all);
+    auto t0 = chrono::steady_clock::now();
+    for(int r=0; r<REPEAT; r++)
+        solver.solve(f.data(), u.data());
+    auto t1 = chrono::steady_clock::now();
+    times[2] = chrono::duration<float>(t1 - t0).count() / REPEAT;
+    errors[1] = 0;
+    for(long j=0; j<M; j++)
+        errors[1] = fmax(errors[1], fabs(u[j] - e[j]));
+}
+
+
+/**************************************************************************************************
+ Main Function:
+ **************************************************************************************************/
+int main(int argc, char *argv[]) {
+
+    // Start by printing the table with time comparisons:
+    cout << "+---------+---------+---------+---------+---------+---------+" << endl;
+    cout << "|    N    | Period. | Threads | Neumann | Err. P. | Err. N. |" << endl;
+    cout << "+---------+---------+---------+---------+---------+---------+" << endl;
+
+    // Try it with grids with size ranging from 16^3 to 128^3 points:
+    for(int r=4; r<8; r++) {
+
+        // Compute the average execution time:
+        int n = (int) exp2(r);
+        float times[3], errors[2];
+        measure(n, times, errors);
+
+        // Print the results:
+        cout << "| " << setw(7) <<     n << " ";
+        cout << "| " << setw(7) << setprecision(7) << times[0] << " ";
+        cout << "| " << setw(7) << setprecision(7) << times[1] << " ";
+        cout << "| " << setw(7) << setprecision(7) << times[2] << " ";
+        cout << "| " << setw(7) << setprecision(7) << errors[0] << " ";
+        cout << "| " << setw(7) << setprecision(7) << errors[1] << " |" << endl;
+    }
+
+    cout << "+---------+---------+---------+---------+---------+---------+" << endl;
+    return 0;
+}
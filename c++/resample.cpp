@@ -0,0 +1,536 @@
+/**************************************************************************************************
+ * Fast Fourier Transform -- C++ Version
+ * This version implements resampling and fractional delay in the frequency domain.
+ *
+ * José Alexandre Nalon
+ **************************************************************************************************
+ * This program doesn't need much to be compiled and run. It can be done, as far as I know, with
+ * any C++ compiler, just remember to link the math library. In my box, I used the command:
+ *
+ * $ g++ -o resample resample.cpp -lm
+ *
+ * It can be run with the command (remember to change permission to execute):
+ *
+ * $ ./resample
+ *
+ * Obs.: A block of Nin samples is resampled to Nout samples by computing its spectrum, truncating
+ *   it (if Nout < Nin) or padding it with zeros (if Nout > Nin), and computing the inverse
+ *   transform of length Nout. A delay of a fraction of a sample is just a multiplication of the
+ *   spectrum by a phase ramp, and that is done in the last step of the real transform, so it
+ *   costs almost nothing. Since the signals are real, the transforms are computed with a complex
+ *   FFT of half the length. The ratios between the usual sampling rates (such as 44100 and 48000)
+ *   don't give lengths that are powers of two, so transforms of any length are computed with the
+ *   chirp-z algorithm (Bluestein's algorithm), which uses power of two FFTs. Long signals are
+ *   processed in blocks weighted by a Hann window with 50% of overlap, and the resampled blocks
+ *   are added together.
+ **************************************************************************************************/
+
+/**************************************************************************************************
+ Include necessary libraries:
+ **************************************************************************************************/
+#include <iostream>                            // Input and Output;
+#include <iomanip>                             // I/O Manipulation;
+#include <cmath>                               // Math Functions;
+#include <chrono>                              // Time measurement;
+#include <map>                                 // Plan cache;
+#include <vector>                              // Buffers;
+
+using namespace std;
+
+
+/**************************************************************************************************
+ Definitions:
+ **************************************************************************************************/
+#define SECONDS 4                              // Length of the test signal, in seconds;
+#define BLOCK 16                               // Block length, in units of the rate ratio;
+
+
+/**************************************************************************************************
+ Small class to operate with complex numbers:
+ **************************************************************************************************/
+class Complex {
+    public:
+        float r;                               // Real part;
+        float i;                               // Imaginary part;
+        Complex();                             // Constructors;
+        Complex(float re, float im);
+        void set(float re, float im);
+        void set(Complex c);
+        Complex operator+(Complex c);          // Addition (overload + operator);
+        Complex operator-(Complex c);          // Subtraction (overload - operator);
+        Complex operator*(Complex c);          // Product (overload * operator);
+        Complex operator*(float a);            // Product with a scalar;
+        Complex cexp();                        // Complex exponential;
+};
+
+Complex::Complex() {                           // Constructor;
+    r = 0.0;                                   // Real part;
+    i = 0.0;                                   // Imaginary part;
+}
+
+Complex::Complex(float re, float im) {         // Constructor;
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(float re, float im) {
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(Complex c) {
+    r = c.r;                                   // Real part;
+    i = c.i;                                   // Imaginary part;
+}
+
+Complex Complex::operator+(Complex c) {
+    return Complex(r + c.r, i + c.i);
+}
+
+Complex Complex::operator-(Complex c) {
+    return Complex(r - c.r, i - c.i);
+}
+
+Complex Complex::operator*(Complex c) {
+    return Complex(r*c.r - i*c.i, r*c.i + i*c.r);
+}
+
+Complex Complex::operator*(float a) {
+    return Complex(a*r, a*i);
+}
+
+Complex Complex::cexp() {
+    return Complex(exp(r)*cos(i), exp(r)*sin(i));
+}
+
+Complex cexpn(float a) {                       // Convenience function to compute the exponential;
+    return Complex(cos(a), sin(a));
+}
+
+
+/**************************************************************************************************
+ * Function: bit_reverse
+ *   Bit-reversed version of an integer number.
+ *
+ * Parameters:
+ *   k
+ *     The number to be bit-reversed;
+ *   r
+ *     The number of bits to take into consideration when reversing.
+ *
+ * Returns:
+ *   The number k, bit-reversed according to integers with r bits.
+ **************************************************************************************************/
+int bit_reverse(int k, int r)
+{
+    int l = 0;                                 // Accumulate the results;
+    for(int i=0; i<r; i++) {                   // Loop on every bit;
+        l = (l << 1) + (k & 1);                // Test less signficant bit and add;
+        k >>= 1;                               // Test next bit;
+    }
+    return l;
+}
+
+
+/**************************************************************************************************
+ Plans hold everything that depends only on the length of the transform, and are kept in a cache.
+ Powers of two are computed by the iterative algorithm; any other length is computed by the
+ chirp-z algorithm, that needs a power of two plan and the spectrum of the chirp:
+ **************************************************************************************************/
+struct Plan {
+    int N;                                     // Length of the transform;
+    vector<int> rev;                           // Bit-reversed indices (powers of two);
+    vector<Complex> W;                         // Twiddle factors (powers of two);
+    Plan *inner;                               // Power of two plan (chirp-z);
+    vector<Complex> chirp;                     // Chirp, exp(-i pi n^2/N) (chirp-z);
+    vector<Complex> B;                         // Spectrum of the conjugated chirp (chirp-z);
+};
+
+map<int, Plan *> plans;                        // Cache of plans, indexed by the length;
+
+void fft(Plan *plan, Complex x[], Complex X[]);
+
+
+/**************************************************************************************************
+ * Function: get_plan
+ *   Looks for a plan in the cache, creating it if it doesn't exist.
+ *
+ * Parameters:
+ *   N
+ *     The length of the transform.
+ *
+ * Returns:
+ *   A pointer to the plan. It is owned by the cache and must not be released.
+ **************************************************************************************************/
+Plan *get_plan(int N)
+{
+    auto p = plans.find(N);
+    if(p != plans.end())                       // Plan was already computed;
+        return p->second;
+
+    Plan *plan = new Plan;
+    plan->N = N;
+    plan->inner = NULL;
+    if((N & (N-1)) == 0) {                     // Power of two;
+        int r = (int) floor(log2(N));
+        plan->rev.resize(N);
+        for(int k=0; k<N; k++)
+            plan->rev[k] = bit_reverse(k, r);
+        plan->W.resize(N/2 + 1);
+        for(int n=0; n<=N/2; n++)              // Twiddle factors computed directly;
+            plan->W[n] = cexpn(-2*M_PI*n/N);
+    } else {                                   // Any other length;
+        int M = 1;
+        while(M < 2*N - 1)                     // Room for the linear convolution;
+            M <<= 1;
+        plan->inner = get_plan(M);
+        plan->chirp.resize(N);
+        for(long n=0; n<N; n++)                // Reduce n^2 to keep the precision;
+            plan->chirp[n] = cexpn(-M_PI * ((n*n) % (2*N)) / N);
+        vector<Complex> b(M);
+        for(int n=0; n<N; n++) {               // Conjugated chirp, both sides;
+            b[n] = Complex(plan->chirp[n].r, -plan->chirp[n].i);
+            if(n > 0)
+                b[M-n] = b[n];
+        }
+        plan->B.resize(M);
+        fft(plan->inner, b.data(), plan->B.data());
+    }
+    plans[N] = plan;
+    return plan;
+}
+
+
+/**************************************************************************************************
+ * Function: fft
+ *   Fast Fourier Transform of any length. Powers of two are computed by the iterative in-place
+ *   decimation in time algorithm; other lengths are computed as a convolution with a chirp:
+ *
+ *     X[k] = c[k] sum_n (x[n] c[n]) conj(c[k-n]),  with c[n] = exp(-i pi n^2/N)
+ *
+ *   where the convolution is computed with power of two FFTs.
+ *
+ * Parameters:
+ *   plan
+ *     Plan for the length of the transform;
+ *   x
+ *     The vector of which the FFT will be computed;
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call, and it can't be the same as the input.
+ **************************************************************************************************/
+void fft(Plan *plan, Complex x[], Complex X[])
+{
+    int N = plan->N;
+    if(plan->inner == NULL) {                  // Power of two;
+        for(int k=0; k<N; k++)                 // Reorder the vector according to the
+            X[plan->rev[k]] = x[k];            //   bit-reversed order;
+        for(int step=1; step<N; step<<=1) {
+            int stride = N / (2*step);
+            for(int l=0; l<N; l+=2*step)
+                for(int n=0; n<step; n++) {
+                    int p = l + n;
+                    int q = p + step;
+                    Complex w = plan->W[n*stride] * X[q];
+                    X[q] = X[p] - w;           // Recombine results;
+                    X[p] = X[p] + w;
+                }
+        }
+        return;
+    }
+
+    int M = plan->inner->N;
+    vector<Complex> a(M), A(M);
+    for(int n=0; n<N; n++)                     // Multiply by the chirp;
+        a[n] = x[n] * plan->chirp[n];
+    fft(plan->inner, a.data(), A.data());
+    for(int k=0; k<M; k++) {                   // Convolution, as an inverse transform through
+        Complex c = A[k] * plan->B[k];         //   conjugation;
+        A[k] = Complex(c.r, -c.i);
+    }
+    fft(plan->inner, A.data(), a.data());
+    for(int k=0; k<N; k++) {                   // Multiply by the chirp again;
+        Complex c = Complex(a[k].r/M, -a[k].i/M);
+        X[k] = c * plan->chirp[k];
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: real_fft
+ *   Transform of a real vector of even length N. The even samples are put in the real part and
+ *   the odd samples in the imaginary part of a complex vector of length N/2, and the spectrum is
+ *   separated after the transform. A fractional delay is applied in the same pass, multiplying
+ *   the spectrum by the phase ramp exp(-2 pi k d/N).
+ *
+ * Parameters:
+ *   x
+ *     The real vector of which the FFT will be computed;
+ *   X
+ *     The vector that will receive the first N/2 + 1 bins of the spectrum (the others are the
+ *     complex conjugates of those);
+ *   N
+ *     The number of elements in the vector. It must be even;
+ *   d
+ *     The delay, in samples. It doesn't need to be integer.
+ **************************************************************************************************/
+void real_fft(float x[], Complex X[], int N, float d)
+{
+    int H = N / 2;
+    Plan *plan = get_plan(H);
+    vector<Complex> z(H), Z(H + 1);
+    for(int n=0; n<H; n++)                     // Pack the real vector;
+        z[n] = Complex(x[2*n], x[2*n+1]);
+    fft(plan, z.data(), Z.data());
+    Z[H] = Z[0];
+
+    for(int k=0; k<=H; k++) {                  // Split the spectrum and delay;
+        Complex a = Z[k];
+        Complex b = Complex(Z[H-k].r, -Z[H-k].i);
+        Complex E = (a + b) * 0.5;             // Transform of the even samples;
+        Complex O = a - b;                     // Transform of the odd samples;
+        O = Complex(O.i * 0.5, -O.r * 0.5);
+        Complex Xk = E + cexpn(-2*M_PI*k/N) * O;
+        X[k] = (d == 0) ? Xk : Xk * cexpn(-2*M_PI*k*d/N);
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: real_ifft
+ *   Inverse transform of the spectrum of a real vector of even length N. It is the inverse of the
+ *   `real_fft` above, and the result is divided by N.
+ *
+ * Parameters:
+ *   X
+ *     The first N/2 + 1 bins of the spectrum;
+ *   x
+ *     The real vector that will receive the results;
+ *   N
+ *     The number of elements in the vector. It must be even.
+ **************************************************************************************************/
+void real_ifft(Complex X[], float x[], int N)
+{
+    int H = N / 2;
+    Plan *plan = get_plan(H);
+    vector<Complex> Z(H), z(H);
+    for(int k=0; k<H; k++) {                   // Join the transforms of even and odd samples;
+        Complex b = Complex(X[H-k].r, -X[H-k].i);
+        Complex E = X[k] + b;
+        Complex O = (X[k] - b) * cexpn(2*M_PI*k/N);
+        Z[k] = Complex(E.r - O.i, -(E.i + O.r));   // Conjugated, to compute the inverse;
+    }
+    fft(plan, Z.data(), z.data());
+    for(int n=0; n<H; n++) {                   // Unpack the real vector;
+        x[2*n] = z[n].r / N;
+        x[2*n+1] = -z[n].i / N;
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: resample
+ *   Resamples a block of Nin samples to Nout samples, delaying it by a fraction of a sample. The
+ *   bin at half the sampling rate is discarded if the lengths are different, since it can't be
+ *   split between positive and negative frequencies.
+ *
+ * Parameters:
+ *   x
+ *     The block to be resampled;
+ *   Nin
+ *     The number of samples in the block. It must be even;
+ *   y
+ *     The vector that will receive the resampled block;
+ *   Nout
+ *     The number of samples of the result. It must be even;
+ *   d
+ *     The delay, in samples of the input.
+ **************************************************************************************************/
+void resample(float x[], int Nin, float y[], int Nout, float d)
+{
+    vector<Complex> X(Nin/2 + 1), Y(Nout/2 + 1);
+    real_fft(x, X.data(), Nin, d);
+    int K = min(Nin, Nout) / 2;
+    float g = (float) Nout / Nin;              // Keeps the amplitude;
+    for(int k=0; k<K; k++)                     // Truncate or pad the spectrum;
+        Y[k] = X[k] * g;
+    if(Nin == Nout)
+        Y[K] = Complex(X[K].r, 0);
+    Y[0].i = 0;
+    real_ifft(Y.data(), y, Nout);
+}
+
+
+/**************************************************************************************************
+ Class to resample a stream, block by block. Blocks of the input are weighted by a periodic Hann
+ window with 50% of overlap (so the windows add to one), resampled and added to the output:
+ **************************************************************************************************/
+class Resampler {
+    public:
+        Resampler(int fin, int fout, int m, float d);
+        int process(float x[], int n, float y[]);
+    private:
+        int Nin;                               // Length of the input blocks;
+        int Nout;                              // Length of the output blocks;
+        float d;                               // Delay;
+        bool first;                            // Indicates the first block;
+        vector<float> window;                  // Hann window;
+        vector<float> input;                   // Samples not yet processed;
+        vector<float> output;                  // Output being accumulated;
+};
+
+
+/**************************************************************************************************
+ * Method: Resampler::Resampler
+ *   Creates the resampler. The rates are reduced to the smallest integer ratio p/q, and the
+ *   blocks have 2qm input samples and 2pm output samples.
+ *
+ * Parameters:
+ *   fin
+ *     Sampling rate of the input;
+ *   fout
+ *     Sampling rate of the output;
+ *   m
+ *     Controls the length of the blocks. Longer blocks give sharper filters;
+ *   d
+ *     The delay, in samples of the input.
+ **************************************************************************************************/
+Resampler::Resampler(int fin, int fout, int m, float d)
+{
+    int a = fin, b = fout;
+    while(b != 0) {                            // Greatest common divisor;
+        int t = a % b;
+        a = b;
+        b = t;
+    }
+    Nin = 2 * (fin / a) * m;
+    Nout = 2 * (fout / a) * m;
+    this->d = d;
+    first = true;
+    window.resize(Nin);
+    for(int n=0; n<Nin; n++)
+        window[n] = 0.5 - 0.5*cos(2*M_PI*n/Nin);
+    input.assign(Nin/2, 0);                    // The stream starts in the middle of a block;
+    output.assign(Nout, 0);
+}
+
+
+/**************************************************************************************************
+ * Method: Resampler::process
+ *   Processes a block of samples of the stream. Output samples are produced only when every block
+ *   that overlaps them was processed, so there is a delay of half a block.
+ *
+ * Parameters:
+ *   x
+ *     The samples of the input;
+ *   n
+ *     The number of samples;
+ *   y
+ *     Receives the samples of the output. It must have room for (n/Nin + 1) * Nout samples.
+ *
+ * Returns:
+ *   The number of output samples produced.
+ **************************************************************************************************/
+int Resampler::process(float x[], int n, float y[])
+{
+    int produced = 0;
+    input.insert(input.end(), x, x + n);
+    vector<float> block(Nin), out(Nout);
+    size_t used = 0;
+    while(input.size() - used >= (size_t) Nin) {
+        for(int j=0; j<Nin; j++)               // Weight the block;
+            block[j] = input[used + j] * window[j];
+        resample(block.data(), Nin, out.data(), Nout, d);
+        for(int j=0; j<Nout; j++)              // Overlap and add;
+            output[j] += out[j];
+        if(!first) {                           // First half of the output is complete;
+            for(int j=0; j<Nout/2; j++)
+                y[produced + j] = output[j];
+            produced += Nout/2;
+        }
+        first = false;
+        for(int j=0; j<Nout/2; j++) {          // Slide the output;
+            output[j] = output[j + Nout/2];
+            output[j + Nout/2] = 0;
+        }
+        used += Nin/2;
+    }
+    input.erase(input.begin(), input.begin() + used);
+    return produced;
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: measure
+ *   Resamples a sine wave and measures the rate of the computation and the error of the result,
+ *   compared to the exact sine wave sampled at the new rate.
+ *
+ * Parameters:
+ *  fin
+ *    Sampling rate of the input;
+ *  fout
+ *    Sampling rate of the output;
+ *  d
+ *    Delay, in samples of the input;
+ *  error
+ *    Receives the largest absolute error, ignoring the beginning and the end of the stream.
+ *
+ * Returns:
+ *   The number of input samples processed per second, in millions.
+ **************************************************************************************************/
+float measure(int fin, int fout, float d, float &error)
+{
+    int n = SECONDS * fin;
+    int block = 4096;                          // Samples in every call;
+    vector<float> x(n), y((long) n * fout / fin + 8 * fout);
+    for(int j=0; j<n; j++)
+        x[j] = sin(2*M_PI*1000.0*j/fin);
+
+    Resampler rs(fin, fout, BLOCK, d);
+    int produced = 0;
+    auto t0 = chrono::steady_clock::now();     // Start counting time;
+    for(int j=0; j+block<=n; j+=block)
+        produced += rs.process(&x[j], block, &y[produced]);
+    auto t1 = chrono::steady_clock::now();     // End of time measuring;
+
+    error = 0;
+    for(int j=fout/10; j<produced - fout/10; j++) {
+        float t = (float) j / fout - d / fin;  // Time of the output sample;
+        error = fmax(error, fabs(y[j] - sin(2*M_PI*1000.0*t)));
+    }
+    return n / chrono::duration<float>(t1 - t0).count() / 1e6;
+}
+
+
+/**************************************************************************************************
+ Main Function:
+ **************************************************************************************************/
+int main(int argc, char *argv[]) {
+
+    int RATES[][2] = { { 44100, 48000 }, { 48000, 44100 }, { 48000, 96000 }, { 96000, 48000 },
+                       { 44100, 96000 }, { 48000, 48000 } };
+
+    // Start by printing the table with rates (in millions of samples per second) and errors:
+    cout << "+---------+---------+---------+---------+---------+" << endl;
+    cout << "|   In    |   Out   | Rate    | Error   | Delayed |" << endl;
+    cout << "+---------+---------+---------+---------+---------+" << endl;
+
+    // Try it with every conversion, with and without a delay:
+    for(int i=0; i<6; i++) {
+
+        // Compute the rate and the errors:
+        float error, derror;
+        float rate = measure(RATES[i][0], RATES[i][1], 0, error);
+        measure(RATES[i][0], RATES[i][1], 0.37, derror);
+
+        // Print the results:
+        cout << "| " << setw(7) << RATES[i][0] << " ";
+        cout << "| " << setw(7) << RATES[i][1] << " ";
+        cout << "| " << setw(7) << setprecision(7) << rate << " ";
+        cout << "| " << setw(7) << setprecision(7) << error << " ";
+        cout << "| " << setw(7) << setprecision(7) << derror << " |" << endl;
+    }
+
+    cout << "+---------+---------+---------+---------+---------+" << endl;
+    return 0;
+}
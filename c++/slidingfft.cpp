@@ -0,0 +1,414 @@
+/**************************************************************************************************
+ * Fast Fourier Transform -- C++ Version
+ * This version implements a sliding window transform, updated at every new sample.
+ *
+ * José Alexandre Nalon
+ **************************************************************************************************
+ * This program doesn't need much to be compiled and run. It can be done, as far as I know, with
+ * any C++ compiler, just remember to link the math library. In my box, I used the command:
+ *
+ * $ g++ -o slidingfft slidingfft.cpp -lm
+ *
+ * It can be run with the command (remember to change permission to execute):
+ *
+ * $ ./slidingfft
+ *
+ * Obs.: If the spectrum of the last N samples is needed every time a new sample arrives, then
+ *   computing it with the FFT costs O(N log_2(N)) operations per sample. The sliding DFT, however,
+ *   updates every bin of the previous spectrum with the sample that arrived and the sample that
+ *   left the window, and that costs only O(N) operations per sample. The samples come through a
+ *   lock-free ring buffer, so one thread can produce them while another updates the spectrum. The
+ *   updates accumulate rounding errors, so the spectrum is recomputed from the window with the
+ *   iterative FFT every K samples. When too many samples arrive between two updates, it is
+ *   cheaper to recompute the spectrum than to slide it, and that is what is done.
+ **************************************************************************************************/
+
+/**************************************************************************************************
+ Include necessary libraries:
+ **************************************************************************************************/
+#include <iostream>                            // Input and Output;
+#include <iomanip>                             // I/O Manipulation;
+#include <cmath>                               // Math Functions;
+#include <chrono>                              // Time measurement;
+#include <vector>                              // Buffers;
+#include <atomic>                              // Lock-free ring buffer;
+
+using namespace std;
+
+
+/**************************************************************************************************
+ Definitions:
+ **************************************************************************************************/
+#define REPEAT 500                             // Number of executions to compute average time;
+#define RESYNC 256                             // Samples between resynchronizations;
+
+
+/**************************************************************************************************
+ Small class to operate with complex numbers:
+ **************************************************************************************************/
+class Complex {
+    public:
+        float r;                               // Real part;
+        float i;                               // Imaginary part;
+        Complex();                             // Constructors;
+        Complex(float re, float im);
+        void set(float re, float im);
+        void set(Complex c);
+        Complex operator+(Complex c);          // Addition (overload + operator);
+        Complex operator-(Complex c);          // Subtraction (overload - operator);
+        Complex operator*(Complex c);          // Product (overload * operator);
+        Complex operator*(float a);            // Product with a scalar;
+        Complex cexp();                        // Complex exponential;
+};
+
+Complex::Complex() {                           // Constructor;
+    r = 0.0;                                   // Real part;
+    i = 0.0;                                   // Imaginary part;
+}
+
+Complex::Complex(float re, float im) {         // Constructor;
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(float re, float im) {
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(Complex c) {
+    r = c.r;                                   // Real part;
+    i = c.i;                                   // Imaginary part;
+}
+
+Complex Complex::operator+(Complex c) {
+    return Complex(r + c.r, i + c.i);
+}
+
+Complex Complex::operator-(Complex c) {
+    return Complex(r - c.r, i - c.i);
+}
+
+Complex Complex::operator*(Complex c) {
+    return Complex(r*c.r - i*c.i, r*c.i + i*c.r);
+}
+
+Complex Complex::operator*(float a) {
+    return Complex(a*r, a*i);
+}
+
+Complex Complex::cexp() {
+    return Complex(exp(r)*cos(i), exp(r)*sin(i));
+}
+
+Complex cexpn(float a) {                       // Convenience function to compute the exponential;
+    return Complex(cos(a), sin(a));
+}
+
+
+/**************************************************************************************************
+ * Function: bit_reverse
+ *   Bit-reversed version of an integer number.
+ *
+ * Parameters:
+ *   k
+ *     The number to be bit-reversed;
+ *   r
+ *     The number of bits to take into consideration when reversing.
+ *
+ * Returns:
+ *   The number k, bit-reversed according to integers with r bits.
+ **************************************************************************************************/
+int bit_reverse(int k, int r)
+{
+    int l = 0;                                 // Accumulate the results;
+    for(int i=0; i<r; i++) {                   // Loop on every bit;
+        l = (l << 1) + (k & 1);                // Test less signficant bit and add;
+        k >>= 1;                               // Test next bit;
+    }
+    return l;
+}
+
+
+/**************************************************************************************************
+ * Function: iterative_fft
+ *   Fast Fourier Transform using an iterative in-place decimation in time algorithm. This has
+ *   O(N log_2(N)) complexity, and since there are less function calls, it will probably be
+ *   marginally faster than the recursive versions.
+ *
+ * Parameters:
+ *   x
+ *     The vector of which the FFT will be computed. This should always be called with a vector of
+ *     a power of two length, or it will fail. No checks on this are made.
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call;
+ *   N
+ *     The number of elements in the vector.
+ **************************************************************************************************/
+void iterative_fft(Complex x[], Complex X[], int N)
+{
+    int r = (int) floor(log2(N));              // Number of bits;
+    for(int k=0; k<N; k++) {
+        int l = bit_reverse(k, r);             // Reorder the vector according to the
+        X[l] = x[k];                           //   bit-reversed order;
+    }
+
+    int step = 1;                              // Auxiliary for computation of twiddle factors;
+    for(int k=0; k<r; k++) {
+        for(int l=0; l<N; l+=2*step) {
+            Complex W = cexpn(-M_PI/step);     // Twiddle factors;
+            Complex Wkn = Complex(1, 0);
+            for(int n=0; n<step; n++) {
+                int p = l + n;
+                int q = p + step;
+                X[q] = X[p] - Wkn * X[q];      // Recombine results;
+                X[p] = X[p]*2 - X[q];
+                Wkn = Wkn * W;                 // Update twiddle factors;
+            }
+        }
+        step <<= 1;
+    }
+}
+
+
+/**************************************************************************************************
+ Lock-free ring buffer, for one producer and one consumer. The capacity must be a power of two.
+ The producer only writes the head, and the consumer only writes the tail, so no locks are needed:
+ **************************************************************************************************/
+class RingBuffer {
+    public:
+        RingBuffer(int capacity);
+        bool push(Complex x);                  // Puts a sample, false if the buffer is full;
+        bool pop(Complex &x);                  // Takes a sample, false if the buffer is empty;
+    private:
+        vector<Complex> data;                  // Samples;
+        size_t mask;                           // Capacity minus one;
+        atomic<size_t> head;                   // Next position to be written;
+        atomic<size_t> tail;                   // Next position to be read;
+};
+
+RingBuffer::RingBuffer(int capacity) : data(capacity), head(0), tail(0) {
+    mask = capacity - 1;
+}
+
+bool RingBuffer::push(Complex x) {
+    size_t h = head.load(memory_order_relaxed);
+    if(h - tail.load(memory_order_acquire) > mask)
+        return false;
+    data[h & mask] = x;
+    head.store(h + 1, memory_order_release);   // Publish the sample;
+    return true;
+}
+
+bool RingBuffer::pop(Complex &x) {
+    size_t t = tail.load(memory_order_relaxed);
+    if(t == head.load(memory_order_acquire))
+        return false;
+    x = data[t & mask];
+    tail.store(t + 1, memory_order_release);   // Release the position;
+    return true;
+}
+
+
+/**************************************************************************************************
+ Sliding window transform. The window keeps the last N samples in a circular buffer, and the
+ spectrum is always the DFT of the window, with the oldest sample at index 0:
+ **************************************************************************************************/
+class SlidingFFT {
+    public:
+        SlidingFFT(int N, int resync, int capacity);
+        RingBuffer input;                      // Samples arriving;
+        void update();                         // Consumes the samples that arrived;
+        Complex *spectrum();                   // The spectrum of the last N samples;
+    private:
+        int N;                                 // Length of the window;
+        int r;                                 // Number of bits;
+        int resync;                            // Samples between resynchronizations;
+        int since;                             // Samples since last resynchronization;
+        int pos;                               // Position of the oldest sample in the window;
+        vector<Complex> window;                // Last N samples;
+        vector<Complex> X;                     // Spectrum;
+        vector<Complex> W;                     // Twiddle factors, W[k] = exp(2 pi k/N);
+        vector<Complex> pending;               // Samples taken from the buffer;
+        void recompute();                      // Computes the spectrum from the window;
+};
+
+SlidingFFT::SlidingFFT(int N, int resync, int capacity)
+    : input(capacity), window(N), X(N), W(N), pending(capacity) {
+    this->N = N;
+    this->r = (int) floor(log2(N));
+    this->resync = resync;
+    since = 0;
+    pos = 0;
+    for(int k=0; k<N; k++)                     // Twiddle factors computed directly, so there is
+        W[k] = cexpn(2*M_PI*k/N);              //   no accumulation of errors;
+}
+
+Complex *SlidingFFT::spectrum() {
+    return X.data();
+}
+
+
+/**************************************************************************************************
+ * Method: SlidingFFT::recompute
+ *   Computes the spectrum of the window with the iterative FFT, discarding any rounding errors
+ *   accumulated by the sliding updates.
+ **************************************************************************************************/
+void SlidingFFT::recompute()
+{
+    vector<Complex> x(N);
+    for(int n=0; n<N; n++)                     // Unwrap the circular buffer;
+        x[n] = window[(pos + n) % N];
+    iterative_fft(x.data(), X.data(), N);
+    since = 0;
+}
+
+
+/**************************************************************************************************
+ * Method: SlidingFFT::update
+ *   Takes every sample available in the ring buffer and updates the spectrum. For every sample,
+ *   the bins are updated by
+ *
+ *     X[k] = (X[k] - x_old + x_new) * exp(2 pi k/N)
+ *
+ *   which costs O(N) operations. If more than log_2(N) samples arrived, then sliding is more
+ *   expensive than the FFT, and the spectrum is recomputed instead.
+ **************************************************************************************************/
+void SlidingFFT::update()
+{
+    int M = 0;
+    while(M < (int) pending.size() && input.pop(pending[M]))
+        M++;
+    if(M == 0)
+        return;
+
+    if(M > r) {                                // Too many samples, recompute the spectrum;
+        for(int m=0; m<M; m++) {
+            window[pos] = pending[m];
+            pos = (pos + 1) % N;
+        }
+        recompute();
+        return;
+    }
+
+    for(int m=0; m<M; m++) {
+        Complex d = pending[m] - window[pos];   // Difference between new and old samples;
+        window[pos] = pending[m];
+        pos = (pos + 1) % N;
+        for(int k=0; k<N; k++)                 // Slide every bin;
+            X[k] = (X[k] + d) * W[k];
+        if(++since >= resync)                  // Resynchronize to discard rounding errors;
+            recompute();
+    }
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: time_it
+ *   Measure execution time of the update of the spectrum when a new sample arrives.
+ *
+ * Parameters:
+ *  sliding
+ *    If true, the spectrum is updated by the sliding transform; if false, the spectrum of the
+ *    window is recomputed with the iterative FFT;
+ *  size
+ *    Length of the window;
+ *  repeat
+ *    Number of samples that will arrive.
+ *
+ * Returns:
+ *   The average execution time of an update.
+ **************************************************************************************************/
+float time_it(bool sliding, int size, int repeat)
+{
+    SlidingFFT s(size, RESYNC, 1024);
+    vector<Complex> x(size), X(size);
+
+    auto t0 = chrono::steady_clock::now();     // Start counting time;
+    for(int j=0; j<repeat; j++)
+        if(sliding) {
+            s.input.push(Complex(j, 0));
+            s.update();
+        } else {
+            x[j % size] = Complex(j, 0);
+            iterative_fft(x.data(), X.data(), size);
+        }
+    auto t1 = chrono::steady_clock::now();     // End of time measuring;
+    return chrono::duration<float>(t1 - t0).count() / repeat;
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: max_error
+ *   Largest difference between the spectrum kept by the sliding transform and the one computed
+ *   directly from the last samples.
+ *
+ * Parameters:
+ *  size
+ *    Length of the window;
+ *  resync
+ *    Samples between resynchronizations;
+ *  repeat
+ *    Number of samples that will arrive.
+ *
+ * Returns:
+ *   The largest absolute error over every bin.
+ **************************************************************************************************/
+float max_error(int size, int resync, int repeat)
+{
+    SlidingFFT s(size, resync, 1024);
+    vector<Complex> x(size), X(size);
+
+    for(int j=0; j<repeat; j++) {
+        Complex sample = cexpn(0.1*j) * (float) sin(0.037*j);
+        s.input.push(sample);
+        s.update();
+        x[j % size] = sample;
+    }
+    vector<Complex> y(size);                   // Window, oldest sample first;
+    for(int n=0; n<size; n++)
+        y[n] = x[(repeat + n) % size];
+    iterative_fft(y.data(), X.data(), size);
+
+    float e = 0;
+    Complex *S = s.spectrum();
+    for(int k=0; k<size; k++) {
+        Complex d = S[k] - X[k];
+        e = fmax(e, sqrt(d.r*d.r + d.i*d.i));
+    }
+    return e;
+}
+
+
+/**************************************************************************************************
+ Main Function:
+ **************************************************************************************************/
+int main(int argc, char *argv[]) {
+
+    // Start by printing the table with time comparisons:
+    cout << "+---------+---------+---------+---------+---------+" << endl;
+    cout << "|    N    | Itera.  | Sliding | Error   | No sync |" << endl;
+    cout << "+---------+---------+---------+---------+---------+" << endl;
+
+    // Try it with vectors with size ranging from 32 to 1024 samples:
+    for(int r=5; r<11; r++) {
+
+        // Compute the average execution time:
+        int n = (int) exp2(r);
+        float itime = time_it(false, n, REPEAT);
+        float stime = time_it(true, n, REPEAT);
+        float error = max_error(n, RESYNC, 100*REPEAT);
+        float nosync = max_error(n, 1<<30, 100*REPEAT);
+
+        // Print the results:
+        cout << "| " << setw(7) <<     n << " ";
+        cout << "| " << setw(7) << setprecision(7) << itime << " ";
+        cout << "| " << setw(7) << setprecision(7) << stime << " ";
+        cout << "| " << setw(7) << setprecision(7) << error << " ";
+        cout << "| " << setw(7) << setprecision(7) << nosync << " |" << endl;
+    }
+
+    cout << "+---------+---------+---------+---------+---------+" << endl;
+    return 0;
+}
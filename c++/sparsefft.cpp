@@ -0,0 +1,541 @@
+/**************************************************************************************************
+ * Fast Fourier Transform -- C++ Version
+ * This version implements a sparse FFT, for spectra with only a few significant coefficients.
+ *
+ * José Alexandre Nalon
+ **************************************************************************************************
+ * This program doesn't need much to be compiled and run. It can be done, as far as I know, with
+ * any C++ compiler, just remember to link the math library. In my box, I used the command:
+ *
+ * $ g++ -O3 -march=native -o sparsefft sparsefft.cpp -lm
+ *
+ * It can be run with the command (remember to change permission to execute):
+ *
+ * $ ./sparsefft
+ *
+ * Obs.: If only k coefficients of a spectrum of length N are not zero, it is possible to find
+ *   them without looking at every sample of the signal. The signal is permuted (the sample n is
+ *   taken from the position sigma n + tau, which permutes the spectrum and multiplies it by a
+ *   phase), modulated by a random frequency (so no coefficient always falls in the border of the
+ *   buckets), multiplied by a filter with a flat band and short support, and folded into B
+ *   buckets, so that a FFT of length B gives the sum of the coefficients that fall in every
+ *   bucket. With B a few times larger than k, most of the coefficients fall alone in their
+ *   buckets. The position of a lonely coefficient is given by the phase difference between
+ *   buckets with different shifts tau (first tau = 1 gives a rough estimate, and larger shifts
+ *   refine it), and its value by the bucket itself. Coefficients that are found are subtracted
+ *   from the buckets of the next rounds, which use other permutations, until nothing is left
+ *   ("peeling"). Every round uses O(B log(N)) samples and operations, so the algorithm is
+ *   sublinear in N. The table compares it with the dense FFT as the number of coefficients grows.
+ **************************************************************************************************/
+
+/**************************************************************************************************
+ Include necessary libraries:
+ **************************************************************************************************/
+#include <iostream>                            // Input and Output;
+#include <iomanip>                             // I/O Manipulation;
+#include <cmath>                               // Math Functions;
+#include <chrono>                              // Time measurement;
+#include <map>                                 // Coefficients found, tables;
+#include <vector>                              // Buffers;
+#include <random>                              // Random permutations;
+
+using namespace std;
+
+
+/**************************************************************************************************
+ Definitions:
+ **************************************************************************************************/
+#define REPEAT 3                               // Number of executions to compute average time;
+#define LOG_N 22                               // Length of the spectrum is 2^LOG_N;
+#define ROUNDS 8                               // Maximum number of rounds;
+#define THRESHOLD 1e-3                         // Smallest coefficient, relative to the signal;
+
+
+/**************************************************************************************************
+ Small class to operate with complex numbers:
+ **************************************************************************************************/
+class Complex {
+    public:
+        float r;                               // Real part;
+        float i;                               // Imaginary part;
+        Complex();                             // Constructors;
+        Complex(float re, float im);
+        void set(float re, float im);
+        void set(Complex c);
+        Complex operator+(Complex c);          // Addition (overload + operator);
+        Complex operator-(Complex c);          // Subtraction (overload - operator);
+        Complex operator*(Complex c);          // Product (overload * operator);
+        Complex operator*(float a);            // Product with a scalar;
+        Complex cexp();                        // Complex exponential;
+};
+
+Complex::Complex() {                           // Constructor;
+    r = 0.0;                                   // Real part;
+    i = 0.0;                                   // Imaginary part;
+}
+
+Complex::Complex(float re, float im) {         // Constructor;
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(float re, float im) {
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(Complex c) {
+    r = c.r;                                   // Real part;
+    i = c.i;                                   // Imaginary part;
+}
+
+Complex Complex::operator+(Complex c) {
+    return Complex(r + c.r, i + c.i);
+}
+
+Complex Complex::operator-(Complex c) {
+    return Complex(r - c.r, i - c.i);
+}
+
+Complex Complex::operator*(Complex c) {
+    return Complex(r*c.r - i*c.i, r*c.i + i*c.r);
+}
+
+Complex Complex::operator*(float a) {
+    return Complex(a*r, a*i);
+}
+
+Complex Complex::cexp() {
+    return Complex(exp(r)*cos(i), exp(r)*sin(i));
+}
+
+Complex cexpn(float a) {                       // Convenience function to compute the exponential;
+    return Complex(cos(a), sin(a));
+}
+
+
+/**************************************************************************************************
+ * Function: bit_reverse
+ *   Bit-reversed version of an integer number.
+ *
+ * Parameters:
+ *   k
+ *     The number to be bit-reversed;
+ *   r
+ *     The number of bits to take into consideration when reversing.
+ *
+ * Returns:
+ *   The number k, bit-reversed according to integers with r bits.
+ **************************************************************************************************/
+int bit_reverse(int k, int r)
+{
+    int l = 0;                                 // Accumulate the results;
+    for(int i=0; i<r; i++) {                   // Loop on every bit;
+        l = (l << 1) + (k & 1);                // Test less signficant bit and add;
+        k >>= 1;                               // Test next bit;
+    }
+    return l;
+}
+
+
+/**************************************************************************************************
+ Cache of the tables of twiddle factors, indexed by the length:
+ **************************************************************************************************/
+map<int, vector<Complex>> tables;
+
+
+/**************************************************************************************************
+ * Function: get_twiddles
+ *   Looks for the table of twiddle factors of a length in the cache, computing it if it doesn't
+ *   exist. The factors are computed directly, so errors don't accumulate over long vectors.
+ *
+ * Parameters:
+ *   N
+ *     The length of the transform.
+ *
+ * Returns:
+ *   The table, with N/2 + 1 factors. It is owned by the cache.
+ **************************************************************************************************/
+vector<Complex> &get_twiddles(int N)
+{
+    auto t = tables.find(N);
+    if(t != tables.end())                      // Table was already computed;
+        return t->second;
+
+    vector<Complex> &W = tables[N];
+    W.resize(N/2 + 1);
+    for(int n=0; n<=N/2; n++)
+        W[n] = cexpn(-2*M_PI*n/N);
+    return W;
+}
+
+
+/**************************************************************************************************
+ * Function: fft
+ *   Fast Fourier Transform using an iterative in-place decimation in time algorithm, with the
+ *   twiddle factors taken from a table computed once for every length.
+ *   The inverse transform is computed by conjugation, and it is not divided by N.
+ *
+ * Parameters:
+ *   x
+ *     The vector of which the FFT will be computed. It must have a power of two length;
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call, and it can't be the same as the input;
+ *   N
+ *     The number of elements in the vector;
+ *   inverse
+ *     If true, computes the inverse transform.
+ **************************************************************************************************/
+void fft(Complex x[], Complex X[], int N, bool inverse)
+{
+    int r = (int) floor(log2(N));              // Number of bits;
+    for(int k=0; k<N; k++) {                   // Reorder the vector according to the
+        int l = bit_reverse(k, r);             //   bit-reversed order;
+        X[l] = inverse ? Complex(x[k].r, -x[k].i) : x[k];
+    }
+
+    vector<Complex> &W = get_twiddles(N);
+    for(int step=1; step<N; step<<=1) {
+        int stride = N / (2*step);             // Distance between twiddle factors in the table;
+        for(int l=0; l<N; l+=2*step)
+            for(int n=0; n<step; n++) {
+                int p = l + n;
+                int q = p + step;
+                Complex w = W[n*stride] * X[q];
+                X[q] = X[p] - w;               // Recombine results;
+                X[p] = X[p] + w;
+            }
+    }
+
+    if(inverse)                                // Conjugate back;
+        for(int k=0; k<N; k++)
+            X[k].i = -X[k].i;
+}
+
+
+/**************************************************************************************************
+ Class that implements the sparse FFT for a given length and maximum number of coefficients:
+ **************************************************************************************************/
+class SparseFFT {
+    public:
+        SparseFFT(int N, int k);
+        map<int, Complex> transform(Complex x[]);
+    private:
+        int N;                                 // Length of the spectrum;
+        int B;                                 // Number of buckets;
+        int L;                                 // Width of a bucket, N/B;
+        int w;                                 // Support of the filter;
+        float a;                               // Shape of the transform of the filter;
+        vector<float> g;                       // Filter, centered in w/2;
+        vector<long> shifts;                   // Shifts used to find the positions;
+        mt19937 random;                        // Random number generator;
+        float response(long d);
+        void buckets(Complex x[], Complex h[], long sigma, long tau, Complex Y[]);
+        void subtract(map<int, Complex> &found, long sigma, long beta, long tau, Complex Y[]);
+};
+
+
+/**************************************************************************************************
+ * Method: SparseFFT::SparseFFT
+ *   Creates the transform. The number of buckets is a power of two at least four times the number
+ *   of coefficients. The filter is a sinc with the width of a bucket, multiplied by a gaussian
+ *   window; its transform is the convolution of a box of width N/B with a gaussian of standard
+ *   deviation close to 1/16 of the bucket.
+ *
+ * Parameters:
+ *   N
+ *     The length of the spectrum. It must be a power of two;
+ *   k
+ *     The maximum number of coefficients expected.
+ **************************************************************************************************/
+SparseFFT::SparseFFT(int N, int k) : random(12345)
+{
+    this->N = N;
+    B = 16;
+    while(B < 4*k)
+        B <<= 1;
+    B = min(B, N);
+    L = N / B;
+
+    float s = 16.0 * B / (2*M_PI);             // Standard deviation of the gaussian window;
+    w = 2 * (int) ceil(5 * s);                 // Window is truncated where it is below 4e-6;
+    w = min(w, N);
+    a = sqrt(2.0) * M_PI * s / N;
+    g.resize(w);
+    for(int j=0; j<w; j++) {
+        float n = j - w/2;
+        float sinc = (n == 0) ? 1.0 / B : sin(M_PI*n/B) / (M_PI*n);
+        g[j] = sinc * exp(-n*n / (2*s*s));
+    }
+
+    for(long t=1; t<N; t*=16)                  // Shifts: 0, 1, 16, 256, ...
+        shifts.push_back(t);
+    shifts.insert(shifts.begin(), 0);
+}
+
+
+/**************************************************************************************************
+ * Method: SparseFFT::response
+ *   Transform of the filter, in a distance of d bins from the center of a bucket.
+ *
+ * Parameters:
+ *   d
+ *     Distance from the center of the bucket.
+ *
+ * Returns:
+ *   The response of the filter, which is close to 1 inside the bucket and to 0 outside it.
+ **************************************************************************************************/
+float SparseFFT::response(long d)
+{
+    return 0.5 * (erf(a * (d + L/2.0)) - erf(a * (d - L/2.0)));
+}
+
+
+/**************************************************************************************************
+ * Method: SparseFFT::buckets
+ *   Computes the buckets for a given permutation and shift. The permuted signal is multiplied by
+ *   the modulated filter and folded in B samples, and the FFT of length B gives the buckets:
+ *
+ *     Y[j] = (1/N) sum_f X[f] exp(2 pi f tau/N) G(j L - sigma f - beta)
+ *
+ * Parameters:
+ *   x
+ *     The signal;
+ *   h
+ *     The filter, modulated by exp(2 pi beta n/N);
+ *   sigma
+ *     The permutation. It must be odd;
+ *   tau
+ *     The shift;
+ *   Y
+ *     Receives the buckets.
+ **************************************************************************************************/
+void SparseFFT::buckets(Complex x[], Complex h[], long sigma, long tau, Complex Y[])
+{
+    vector<Complex> y(B);
+    for(int j=0; j<w; j++) {                   // Permute, filter and fold;
+        long n = j - w/2;
+        Complex s = x[(sigma*n + tau) & (N-1)];
+        y[n & (B-1)] = y[n & (B-1)] + s * h[j];
+    }
+    fft(y.data(), Y, B, false);
+}
+
+
+/**************************************************************************************************
+ * Method: SparseFFT::subtract
+ *   Subtracts the coefficients already found from the buckets. Only the bucket where the
+ *   coefficient falls and its neighbours are touched, since the filter is negligible elsewhere.
+ *
+ * Parameters:
+ *   found
+ *     The coefficients already found;
+ *   sigma
+ *     The permutation used in the buckets;
+ *   beta
+ *     The modulation used in the buckets;
+ *   tau
+ *     The shift used in the buckets;
+ *   Y
+ *     The buckets.
+ **************************************************************************************************/
+void SparseFFT::subtract(map<int, Complex> &found, long sigma, long beta, long tau, Complex Y[])
+{
+    for(auto &c : found) {
+        long f = c.first;
+        long p = (sigma*f + beta) & (N-1);     // Position in the permuted spectrum;
+        long j = (p + L/2) / L;                // Nearest bucket;
+        Complex v = c.second * cexpn(2*M_PI * ((f*tau) & (N-1)) / N) * (1.0 / N);
+        for(long m=j-1; m<=j+1; m++) {
+            long d = ((m*L - p) & (N-1));      // Distance to the bucket, modulo N;
+            if(d >= N/2)
+                d = d - N;
+            Y[m & (B-1)] = Y[m & (B-1)] - v * response(d);
+        }
+    }
+}
+
+
+/**************************************************************************************************
+ * Method: SparseFFT::transform
+ *   Computes the sparse transform. In every round, a random permutation is chosen and buckets
+ *   are computed for every shift; the coefficients already found are subtracted, and the buckets
+ *   that still have energy are inspected. A bucket has a single coefficient if every shift only
+ *   changes its phase; the phases give the position of the coefficient, from the coarsest to the
+ *   finest digits. The process stops when a round finds nothing left.
+ *
+ * Parameters:
+ *   x
+ *     The signal. Only a small part of it is read.
+ *
+ * Returns:
+ *   The coefficients found, indexed by their position in the spectrum.
+ **************************************************************************************************/
+map<int, Complex> SparseFFT::transform(Complex x[])
+{
+    map<int, Complex> found;
+    int S = shifts.size();
+    vector<vector<Complex>> Y(S, vector<Complex>(B));
+    vector<Complex> h(w);
+
+    float energy = 0;                          // Level of the signal, from a few samples;
+    for(int j=0; j<w; j++) {
+        Complex s = x[((long) j * (N/w)) & (N-1)];
+        energy = energy + s.r*s.r + s.i*s.i;
+    }
+    float threshold = THRESHOLD * sqrt(energy / w);
+
+    for(int pass=0; pass<ROUNDS; pass++) {
+        long sigma = (random() % N) | 1;       // Odd numbers are invertible modulo N;
+        long beta = random() % L;              // Random offset of the buckets;
+        for(int j=0; j<w; j++)                 // Modulate the filter;
+            h[j] = cexpn(2*M_PI * (((j - w/2) * beta) & (N-1)) / N) * g[j];
+        for(int t=0; t<S; t++) {
+            buckets(x, h.data(), sigma, shifts[t], Y[t].data());
+            subtract(found, sigma, beta, shifts[t], Y[t].data());
+        }
+
+        bool clean = true;
+        for(int j=0; j<B; j++) {
+            Complex y0 = Y[0][j];
+            float m0 = sqrt(y0.r*y0.r + y0.i*y0.i);
+            if(m0 < threshold)                 // Empty bucket;
+                continue;
+            clean = false;
+
+            double f = 0;                      // Find the position, refining with every shift;
+            bool single = true;
+            for(int t=1; t<S && single; t++) {
+                Complex yt = Y[t][j];
+                float mt = sqrt(yt.r*yt.r + yt.i*yt.i);
+                if(fabs(mt - m0) > 0.1 * m0)   // More than one coefficient in the bucket;
+                    single = false;
+                Complex q = yt * Complex(y0.r, -y0.i);
+                double phase = atan2(q.i, q.r);
+                double period = (double) N / shifts[t];
+                double base = phase / (2*M_PI) * period;
+                double m = round((f - base) / period);
+                f = base + m * period;         // Candidate closest to the previous estimate;
+            }
+            long k = ((long) llround(f)) & (N-1);
+            long p = (sigma*k + beta) & (N-1);
+            long d = ((long) j*L - p) & (N-1);
+            if(d >= N/2)
+                d = d - N;
+            float G = response(d);
+            if(!single || labs(d) > L/2 || G < 0.9)    // Try again in another round;
+                continue;
+            Complex v = y0 * ((float) N / G);
+            found[k] = found[k] + v;           // Coefficients can be corrected;
+        }
+        if(clean)
+            break;
+    }
+
+    for(auto c=found.begin(); c!=found.end(); ) // Remove what was cancelled by corrections;
+        if(sqrt(c->second.r*c->second.r + c->second.i*c->second.i) < threshold * N * 0.5)
+            c = found.erase(c);
+        else
+            ++c;
+    return found;
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: make_signal
+ *   Creates a signal with a given number of tones, in random positions and with random phases,
+ *   all of them with the same amplitude.
+ *
+ * Parameters:
+ *  x
+ *    Receives the signal;
+ *  N
+ *    Length of the signal;
+ *  k
+ *    Number of tones;
+ *  X
+ *    Receives the spectrum of the signal.
+ **************************************************************************************************/
+void make_signal(Complex x[], int N, int k, map<int, Complex> &X)
+{
+    mt19937 random(k);
+    vector<Complex> S(N);
+    X.clear();
+    while((int) X.size() < k) {
+        int f = random() % N;
+        X[f] = cexpn(2*M_PI * (random() % 1000) / 1000.0) * (float) N;
+    }
+    for(auto &c : X)
+        S[c.first] = c.second;
+    fft(S.data(), x, N, true);
+    for(int n=0; n<N; n++)
+        x[n] = x[n] * (1.0 / N);
+}
+
+
+/**************************************************************************************************
+ Main Function:
+ **************************************************************************************************/
+int main(int argc, char *argv[]) {
+
+    int N = 1 << LOG_N;
+    vector<Complex> x(N), X(N);
+
+    // Time of the dense transform, which doesn't depend on the number of coefficients. The first
+    // call, which computes the table of twiddle factors, is not timed:
+    for(int n=0; n<N; n++)
+        x[n] = Complex(n % 13, 0);
+    fft(x.data(), X.data(), N, false);
+    auto t0 = chrono::steady_clock::now();
+    for(int j=0; j<REPEAT; j++)
+        fft(x.data(), X.data(), N, false);
+    auto t1 = chrono::steady_clock::now();
+    float dtime = chrono::duration<float>(t1 - t0).count() / REPEAT;
+
+    // Start by printing the table with time comparisons:
+    cout << "+---------+---------+---------+---------+---------+" << endl;
+    cout << "|    k    |  Dense  | Sparse  | Found   | Error   |" << endl;
+    cout << "+---------+---------+---------+---------+---------+" << endl;
+
+    // Try it with the number of coefficients ranging from 1 to 16384:
+    for(int r=0; r<15; r+=2) {
+
+        // Compute the average execution time:
+        int k = (int) exp2(r);
+        map<int, Complex> S, found;
+        make_signal(x.data(), N, k, S);
+        SparseFFT sfft(N, k);
+        t0 = chrono::steady_clock::now();      // Start counting time;
+        for(int j=0; j<REPEAT; j++)
+            found = sfft.transform(x.data());
+        t1 = chrono::steady_clock::now();      // End of time measuring;
+        float stime = chrono::duration<float>(t1 - t0).count() / REPEAT;
+
+        double e = 0, s = 0;                   // Relative error over every coefficient;
+        int correct = 0;
+        for(auto &c : S) {
+            Complex d = c.second;
+            auto f = found.find(c.first);
+            if(f != found.end()) {
+                d = d - f->second;
+                correct++;
+            }
+            e = e + d.r*d.r + d.i*d.i;
+            s = s + c.second.r*c.second.r + c.second.i*c.second.i;
+        }
+        for(auto &c : found)                   // Coefficients that don't exist;
+            if(S.find(c.first) == S.end())
+                e = e + c.second.r*c.second.r + c.second.i*c.second.i;
+
+        // Print the results:
+        cout << "| " << setw(7) <<     k << " ";
+        cout << "| " << setw(7) << setprecision(7) << dtime << " ";
+        cout << "| " << setw(7) << setprecision(7) << stime << " ";
+        cout << "| " << setw(7) << correct << " ";
+        cout << "| " << setw(7) << setprecision(7) << sqrt(e / s) << " |" << endl;
+    }
+
+    cout << "+---------+---------+---------+---------+---------+" << endl;
+    return 0;
+}
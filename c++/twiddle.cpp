@@ -0,0 +1,806 @@
+/**************************************************************************************************
+ * Fast Fourier Transform -- C++ Version
+ * This version compares ways to obtain the twiddle factors of long transforms.
+ *
+ * José Alexandre Nalon
+ **************************************************************************************************
+ * This program doesn't need much to be compiled and run. It can be done, as far as I know, with
+ * any C++ compiler, just remember to link the math library. In my box, I used the command:
+ *
+ * $ g++ -O3 -march=native -o twiddle twiddle.cpp -lm
+ *
+ * It can be run with the command (remember to change permission to execute):
+ *
+ * $ ./twiddle
+ *
+ * Obs.: A table with every twiddle factor of a transform of length N has N/2 complex numbers; for
+ *   2^28 samples, that is 1 GiB, and the first stages read it with a stride so large that every
+ *   factor comes from the memory. Writing n = 2^b h + l, with l < 2^b, the factor W^n is equal to
+ *   W^(2^b h) W^l, so it can be rebuilt from two tables of about sqrt(N) elements, a coarse one
+ *   and a fine one, with one complex multiplication. Both tables fit in the cache, and since they
+ *   are computed in double precision, the product is almost as accurate as the factor itself. The
+ *   tables compare the memory, the time and the error (relative to a transform computed in double
+ *   precision) of the full table, the two-level table and the usual iterative FFT, that computes
+ *   the factors by successive multiplications.
+ *
+ *   Where there is no memory to spare, the plan can keep no table at all. The factors of every
+ *   stage are generated with Singleton's recurrence, that updates the cosine and the sine with
+ *   small increments, instead of multiplying by the same factor again and again (that lets the
+ *   error grow with every step). The recurrence starts again from a factor computed directly at
+ *   the beginning of every chunk of factors, so the error never has time to grow.
+ *
+ *   Plans of long transforms need millions of sines and cosines, and computing them one by one
+ *   with the math library can take longer than the transforms of a short job. Here, they are
+ *   computed in vectorized loops, with the argument reduced exactly (every angle is a fraction of
+ *   a turn) and polynomials in the interval [-pi/4, pi/4]. The same routine computes windows and
+ *   chirps, and the last table shows the time to create them.
+ **************************************************************************************************/
+
+/**************************************************************************************************
+ Include necessary libraries:
+ **************************************************************************************************/
+#include <iostream>                            // Input and Output;
+#include <iomanip>                             // I/O Manipulation;
+#include <cmath>                               // Math Functions;
+#include <chrono>                              // Time measurement;
+#include <map>                                 // Cache of plans;
+#include <vector>                              // Tables;
+
+using namespace std;
+
+
+/**************************************************************************************************
+ Definitions:
+ **************************************************************************************************/
+#define REPEAT 100                             // Number of executions to compute average time;
+#define CHUNK 256                              // Twiddle factors obtained together;
+#define FULL 0                                 // Plan modes: a table with every twiddle factor;
+#define TWO_LEVEL 1                            //   coarse and fine tables;
+#define RECURRENCE 2                           //   no table at all;
+#define ROUND 6755399441055744.0               // 1.5 2^52, rounds a double to an integer;
+
+
+/**************************************************************************************************
+ Small class to operate with complex numbers:
+ **************************************************************************************************/
+class Complex {
+    public:
+        float r;                               // Real part;
+        float i;                               // Imaginary part;
+        Complex();                             // Constructors;
+        Complex(float re, float im);
+        void set(float re, float im);
+        void set(Complex c);
+        Complex operator+(Complex c);          // Addition (overload + operator);
+        Complex operator-(Complex c);          // Subtraction (overload - operator);
+        Complex operator*(Complex c);          // Product (overload * operator);
+        Complex operator*(float a);            // Product with a scalar;
+        Complex cexp();                        // Complex exponential;
+};
+
+Complex::Complex() {                           // Constructor;
+    r = 0.0;                                   // Real part;
+    i = 0.0;                                   // Imaginary part;
+}
+
+Complex::Complex(float re, float im) {         // Constructor;
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(float re, float im) {
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(Complex c) {
+    r = c.r;                                   // Real part;
+    i = c.i;                                   // Imaginary part;
+}
+
+Complex Complex::operator+(Complex c) {
+    return Complex(r + c.r, i + c.i);
+}
+
+Complex Complex::operator-(Complex c) {
+    return Complex(r - c.r, i - c.i);
+}
+
+Complex Complex::operator*(Complex c) {
+    return Complex(r*c.r - i*c.i, r*c.i + i*c.r);
+}
+
+Complex Complex::operator*(float a) {
+    return Complex(a*r, a*i);
+}
+
+Complex Complex::cexp() {
+    return Complex(exp(r)*cos(i), exp(r)*sin(i));
+}
+
+Complex cexpn(float a) {                       // Convenience function to compute the exponential;
+    return Complex(cos(a), sin(a));
+}
+
+
+/**************************************************************************************************
+ * Function: bit_reverse
+ *   Bit-reversed version of an integer number.
+ *
+ * Parameters:
+ *   k
+ *     The number to be bit-reversed;
+ *   r
+ *     The number of bits to take into consideration when reversing.
+ *
+ * Returns:
+ *   The number k, bit-reversed according to integers with r bits.
+ **************************************************************************************************/
+int bit_reverse(int k, int r)
+{
+    int l = 0;                                 // Accumulate the results;
+    for(int i=0; i<r; i++) {                   // Loop on every bit;
+        l = (l << 1) + (k & 1);                // Test less signficant bit and add;
+        k >>= 1;                               // Test next bit;
+    }
+    return l;
+}
+
+
+/**************************************************************************************************
+ * Function: iterative_fft
+ *   Fast Fourier Transform using an iterative in-place decimation in time algorithm. This has
+ *   O(N log_2(N)) complexity, and since there are less function calls, it will probably be
+ *   marginally faster than the recursive versions.
+ *
+ * Parameters:
+ *   x
+ *     The vector of which the FFT will be computed. This should always be called with a vector of
+ *     a power of two length, or it will fail. No checks on this are made.
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call;
+ *   N
+ *     The number of elements in the vector.
+ **************************************************************************************************/
+void iterative_fft(Complex x[], Complex X[], int N)
+{
+    int r = (int) floor(log2(N));              // Number of bits;
+    for(int k=0; k<N; k++) {
+        int l = bit_reverse(k, r);             // Reorder the vector according to the
+        X[l] = x[k];                           //   bit-reversed order;
+    }
+
+    int step = 1;                              // Auxiliary for computation of twiddle factors;
+    for(int k=0; k<r; k++) {
+        for(int l=0; l<N; l+=2*step) {
+            Complex W = cexpn(-M_PI/step);     // Twiddle factors;
+            Complex Wkn = Complex(1, 0);
+            for(int n=0; n<step; n++) {
+                int p = l + n;
+                int q = p + step;
+                X[q] = X[p] - Wkn * X[q];      // Recombine results;
+                X[p] = X[p]*2 - X[q];
+                Wkn = Wkn * W;                 // Update twiddle factors;
+            }
+        }
+        step <<= 1;
+    }
+}
+
+
+/**************************************************************************************************
+ Plans keep the twiddle factors of one length, in one of the modes, and are kept in a cache:
+ **************************************************************************************************/
+struct Plan {
+    int N;                                     // Length of the transform;
+    int mode;                                  // How the twiddle factors are obtained;
+    vector<Complex> W;                         // Full table, W[n] = exp(-2 pi n/N), n < N/2;
+    vector<Complex> coarse;                    // Two-level tables, W^n = coarse[n >> bits] times
+    vector<Complex> fine;                      //   fine[n & mask];
+    int bits;                                  // Bits of the index of the fine table;
+    int mask;                                  // Mask of the index of the fine table;
+};
+
+map<pair<int, int>, Plan *> plans;             // Cache of plans, indexed by length and mode;
+
+
+/**************************************************************************************************
+ * Auxiliary function: exact
+ *   Twiddle factor computed in double precision and rounded to single precision.
+ *
+ * Parameters:
+ *   n
+ *     The exponent of the factor;
+ *   N
+ *     The length of the transform.
+ *
+ * Returns:
+ *   The factor W^n = exp(-2 pi i n/N).
+ **************************************************************************************************/
+Complex exact(long n, int N)
+{
+    double a = -2*M_PI*n / N;
+    return Complex(cos(a), sin(a));
+}
+
+
+/**************************************************************************************************
+ * Function: sincos_fractions
+ *   Cosine and sine of 2 pi p/q for many integers p, in a loop that the compiler vectorizes.
+ *   Twiddle factors, windows and chirps are all of this form. The argument is reduced exactly:
+ *   with o the integer closest to 4p/q, the remainder 4p - oq is an integer, and the angle is
+ *   o pi/2 + t, with |t| <= pi/4 given by (pi/2) (4p - oq)/q. (If 4p/q is rounded to the wrong
+ *   side of a half, t is a little larger than pi/4, and the result is still accurate.) Then
+ *   cos(t) and sin(t) come from Taylor polynomials of degree 12 and 11 (with errors below 1e-11
+ *   in this interval), and the quadrant o mod 4 gives the signs and the order of the results.
+ *   There are no branches and no calls to the math library, so the loop is vectorized.
+ *
+ * Parameters:
+ *   p
+ *     The numerators. They must be integers, smaller than 2^50 in magnitude;
+ *   q
+ *     The denominator;
+ *   c
+ *     Receives the cosines;
+ *   s
+ *     Receives the sines;
+ *   M
+ *     The number of angles.
+ **************************************************************************************************/
+void sincos_fractions(const double p[], double q, float c[], float s[], int M)
+{
+    double f = 4 / q, g = M_PI / (2*q);        // No divisions inside the loop;
+    for(int j=0; j<M; j++) {
+        double o = (p[j]*f + ROUND) - ROUND;   // Nearest quadrant;
+        double t = (4*p[j] - o*q) * g;
+        double t2 = t * t;
+        double ct = 1 + t2*(-1./2 + t2*(1./24 + t2*(-1./720 + t2*(1./40320
+                  + t2*(-1./3628800 + t2*(1./479001600))))));
+        double st = t * (1 + t2*(-1./6 + t2*(1./120 + t2*(-1./5040 + t2*(1./362880
+                  + t2*(-1./39916800))))));
+        int k = (int) o;
+        double u = k & 1, v = 1 - (k & 2);     // Quarter turn, and sign of half a turn;
+        c[j] = v * (ct - u*(ct + st));
+        s[j] = v * (st + u*(ct - st));
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: twiddles
+ *   Fills a table with the twiddle factors W^(a + n d), for n = 0, 1, ..., M-1, computed with
+ *   sincos_fractions in chunks.
+ *
+ * Parameters:
+ *   W
+ *     Receives the factors;
+ *   a
+ *     The first exponent;
+ *   d
+ *     The distance between exponents;
+ *   M
+ *     The number of factors;
+ *   N
+ *     The length of the transform.
+ **************************************************************************************************/
+void twiddles(Complex W[], long a, long d, int M, int N)
+{
+    double p[CHUNK];
+    float c[CHUNK], s[CHUNK];
+    for(int n0=0; n0<M; n0+=CHUNK) {
+        int m = min(CHUNK, M - n0);
+        for(int n=0; n<m; n++)
+            p[n] = -(a + (n0 + n) * d);
+        sincos_fractions(p, N, c, s, m);
+        for(int n=0; n<m; n++)
+            W[n0 + n] = Complex(c[n], s[n]);
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: hann_window
+ *   Periodic Hann window, w[n] = 1/2 - cos(2 pi n/N)/2, with the cosines of sincos_fractions.
+ *
+ * Parameters:
+ *   w
+ *     Receives the window;
+ *   N
+ *     The length of the window.
+ **************************************************************************************************/
+void hann_window(float w[], int N)
+{
+    double p[CHUNK];
+    float c[CHUNK], s[CHUNK];
+    for(int n0=0; n0<N; n0+=CHUNK) {
+        int m = min(CHUNK, N - n0);
+        for(int n=0; n<m; n++)
+            p[n] = n0 + n;
+        sincos_fractions(p, N, c, s, m);
+        for(int n=0; n<m; n++)
+            w[n0 + n] = 0.5f - 0.5f*c[n];
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: chirp
+ *   Chirp used by the chirp-z transform, c[n] = exp(-i pi n^2/N). Since it is equal to
+ *   exp(-2 pi i (n^2 mod 2N)/2N), the numerators are kept modulo 2N, where they are exact.
+ *
+ * Parameters:
+ *   ch
+ *     Receives the chirp;
+ *   N
+ *     The length of the chirp.
+ **************************************************************************************************/
+void chirp(Complex ch[], int N)
+{
+    double p[CHUNK];
+    float c[CHUNK], s[CHUNK];
+    long n2 = 0;                               // n^2 mod 2N, updated with (n+1)^2 = n^2 + 2n + 1;
+    for(int n0=0; n0<N; n0+=CHUNK) {
+        int m = min(CHUNK, N - n0);
+        for(int n=0; n<m; n++) {
+            p[n] = -n2;
+            n2 += 2*(n0 + n) + 1;
+            if(n2 >= 2L*N)
+                n2 -= 2L*N;
+        }
+        sincos_fractions(p, 2.0*N, c, s, m);
+        for(int n=0; n<m; n++)
+            ch[n0 + n] = Complex(c[n], s[n]);
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: new_plan
+ *   Creates a plan. In the two-level mode, the fine table takes half the bits of the index
+ *   (rounded down) and the coarse table the others.
+ *
+ * Parameters:
+ *   N
+ *     The length of the transform. It must be a power of two;
+ *   mode
+ *     FULL, TWO_LEVEL or RECURRENCE (that keeps nothing).
+ *
+ * Returns:
+ *   A pointer to the plan.
+ **************************************************************************************************/
+Plan *new_plan(int N, int mode)
+{
+    Plan *plan = new Plan;
+    plan->N = N;
+    plan->mode = mode;
+    plan->bits = 0;
+    plan->mask = 0;
+    int r = (int) floor(log2(N)) - 1;          // Bits of the index of a factor;
+    if(mode == FULL) {
+        plan->W.resize(N/2);
+        twiddles(plan->W.data(), 0, 1, N/2, N);
+    } else if(mode == TWO_LEVEL) {
+        plan->bits = r / 2;
+        plan->mask = (1 << plan->bits) - 1;
+        plan->fine.resize(plan->mask + 1);
+        plan->coarse.resize(1 << (r - plan->bits));
+        twiddles(plan->fine.data(), 0, 1, plan->fine.size(), N);
+        twiddles(plan->coarse.data(), 0, 1L << plan->bits, plan->coarse.size(), N);
+    }
+    return plan;
+}
+
+
+/**************************************************************************************************
+ * Function: get_plan
+ *   Looks for a plan in the cache, creating it if it doesn't exist.
+ *
+ * Parameters:
+ *   N
+ *     The length of the transform. It must be a power of two;
+ *   mode
+ *     FULL, TWO_LEVEL or RECURRENCE.
+ *
+ * Returns:
+ *   A pointer to the plan. It is owned by the cache and must not be released.
+ **************************************************************************************************/
+Plan *get_plan(int N, int mode)
+{
+    auto p = plans.find(make_pair(N, mode));
+    if(p != plans.end())                       // Plan was already computed;
+        return p->second;
+    Plan *plan = new_plan(N, mode);
+    plans[make_pair(N, mode)] = plan;
+    return plan;
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: plan_memory
+ *   Memory used by the tables of a plan.
+ *
+ * Parameters:
+ *   plan
+ *     The plan.
+ *
+ * Returns:
+ *   The size of the tables, in bytes.
+ **************************************************************************************************/
+long plan_memory(Plan *plan)
+{
+    return (plan->W.size() + plan->coarse.size() + plan->fine.size()) * sizeof(Complex);
+}
+
+
+/**************************************************************************************************
+ * Function: plan_fft
+ *   Fast Fourier Transform using an iterative in-place decimation in time algorithm, with the
+ *   twiddle factors given by the plan. In every stage, the factor of the butterfly n is W^(n s),
+ *   where s is N over the length of the transforms being computed. The factors are obtained in
+ *   chunks of CHUNK elements, that are used by every group of butterflies of the stage, so the
+ *   cost of rebuilding them is paid once per factor, not once per butterfly. Without tables, the
+ *   first factor of a chunk is computed directly, and the others by Singleton's recurrence:
+ *
+ *     cos(a + t) = cos(a) - (A cos(a) + B sin(a)),
+ *     sin(a + t) = sin(a) - (A sin(a) - B cos(a)),
+ *
+ *   with A = 2 sin^2(t/2) and B = sin(t), where t is the angle between factors.
+ *
+ * Parameters:
+ *   MODE
+ *     The mode of the plan;
+ *   plan
+ *     The plan;
+ *   x
+ *     The vector of which the FFT will be computed;
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call.
+ **************************************************************************************************/
+template<int MODE>
+void plan_fft(Plan *plan, Complex x[], Complex X[])
+{
+    int N = plan->N;
+    int r = (int) floor(log2(N));              // Number of bits;
+    for(int k=0; k<N; k++) {
+        int l = bit_reverse(k, r);             // Reorder the vector according to the
+        X[l] = x[k];                           //   bit-reversed order;
+    }
+
+    Complex *W = plan->W.data();
+    Complex *coarse = plan->coarse.data(), *fine = plan->fine.data();
+    int bits = plan->bits, mask = plan->mask;
+    Complex w[CHUNK];                          // Factors of the current chunk;
+    for(int step=1; step<N; step<<=1) {
+        int s = N / (2*step);                  // Stride of the factors in this stage;
+        double t = -M_PI / step;               // Angle between factors in this stage;
+        double A = 2*sin(t/2)*sin(t/2), B = sin(t);
+        for(int n0=0; n0<step; n0+=CHUNK) {
+            int m = min(CHUNK, step - n0);
+            if(MODE == RECURRENCE) {
+                w[0] = cexpn(t * n0);          // Start again from a direct computation;
+                double c = w[0].r, d = w[0].i; // Kept in double, since it is done once per
+                for(int n=1; n<m; n++) {       //   factor, not once per butterfly;
+                    double e = c - (A*c + B*d);
+                    d = d - (A*d - B*c);
+                    c = e;
+                    w[n] = Complex(c, d);
+                }
+            } else
+                for(int n=0; n<m; n++) {
+                    int k = (n0 + n) * s;
+                    if(MODE == FULL)
+                        w[n] = W[k];
+                    else                       // One complex multiplication;
+                        w[n] = coarse[k >> bits] * fine[k & mask];
+                }
+            for(int l=n0; l<N; l+=2*step)
+                for(int n=0; n<m; n++) {
+                    int p = l + n;
+                    int q = p + step;
+                    X[q] = X[p] - w[n] * X[q]; // Recombine results;
+                    X[p] = X[p]*2 - X[q];
+                }
+        }
+    }
+}
+
+
+/**************************************************************************************************
+ * Function: table_fft
+ *   Fast Fourier Transform with a full table of twiddle factors.
+ *
+ * Parameters:
+ *   x
+ *     The vector of which the FFT will be computed. This should always be called with a vector of
+ *     a power of two length, or it will fail. No checks on this are made.
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call;
+ *   N
+ *     The number of elements in the vector.
+ **************************************************************************************************/
+void table_fft(Complex x[], Complex X[], int N)
+{
+    plan_fft<FULL>(get_plan(N, FULL), x, X);
+}
+
+
+/**************************************************************************************************
+ * Function: two_level_fft
+ *   Fast Fourier Transform with the twiddle factors rebuilt from the coarse and fine tables.
+ *
+ * Parameters:
+ *   x
+ *     The vector of which the FFT will be computed. This should always be called with a vector of
+ *     a power of two length, or it will fail. No checks on this are made.
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call;
+ *   N
+ *     The number of elements in the vector.
+ **************************************************************************************************/
+void two_level_fft(Complex x[], Complex X[], int N)
+{
+    plan_fft<TWO_LEVEL>(get_plan(N, TWO_LEVEL), x, X);
+}
+
+
+/**************************************************************************************************
+ * Function: recurrence_fft
+ *   Fast Fourier Transform without tables, with the twiddle factors generated by a recurrence.
+ *
+ * Parameters:
+ *   x
+ *     The vector of which the FFT will be computed. This should always be called with a vector of
+ *     a power of two length, or it will fail. No checks on this are made.
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call;
+ *   N
+ *     The number of elements in the vector.
+ **************************************************************************************************/
+void recurrence_fft(Complex x[], Complex X[], int N)
+{
+    plan_fft<RECURRENCE>(get_plan(N, RECURRENCE), x, X);
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: reference_fft
+ *   Fast Fourier Transform computed in double precision, with every twiddle factor computed
+ *   directly, used to measure the errors of the other transforms.
+ *
+ * Parameters:
+ *   x
+ *     The vector of which the FFT will be computed;
+ *   Xr, Xi
+ *     The vectors that will receive the real and imaginary parts of the results;
+ *   N
+ *     The number of elements in the vector.
+ **************************************************************************************************/
+void reference_fft(Complex x[], vector<double> &Xr, vector<double> &Xi, int N)
+{
+    int r = (int) floor(log2(N));              // Number of bits;
+    Xr.resize(N);
+    Xi.resize(N);
+    for(int k=0; k<N; k++) {
+        int l = bit_reverse(k, r);
+        Xr[l] = x[k].r;
+        Xi[l] = x[k].i;
+    }
+    for(int step=1; step<N; step<<=1)
+        for(int n=0; n<step; n++) {
+            double wr = cos(M_PI*n / step), wi = -sin(M_PI*n / step);
+            for(int p=n; p<N; p+=2*step) {
+                int q = p + step;
+                double tr = wr*Xr[q] - wi*Xi[q], ti = wr*Xi[q] + wi*Xr[q];
+                Xr[q] = Xr[p] - tr;
+                Xi[q] = Xi[p] - ti;
+                Xr[p] += tr;
+                Xi[p] += ti;
+            }
+        }
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: error
+ *   Relative RMS error of a transform, against the transform computed in double precision.
+ *
+ * Parameters:
+ *  f
+ *    Function to be measured, with the same prototype of the transforms;
+ *  x
+ *    The vector to be transformed;
+ *  Xr, Xi
+ *    The transform of the vector computed in double precision;
+ *  N
+ *    Number of elements in the vector.
+ *
+ * Returns:
+ *   The norm of the error divided by the norm of the transform.
+ **************************************************************************************************/
+float error(void (*f)(Complex *, Complex *, int), Complex x[], vector<double> &Xr,
+            vector<double> &Xi, int N)
+{
+    vector<Complex> X(N);
+    (*f)(x, X.data(), N);
+    double e = 0, s = 0;
+    for(int k=0; k<N; k++) {
+        double dr = X[k].r - Xr[k], di = X[k].i - Xi[k];
+        e += dr*dr + di*di;
+        s += Xr[k]*Xr[k] + Xi[k]*Xi[k];
+    }
+    return sqrt(e / s);
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: time_it
+ *   Measure execution time through repeated calls to a (Fast) Fourier Transform function.
+ *
+ * Parameters:
+ *  f
+ *    Function to be called, with the given prototype. The first complex vector is the input
+ *    vector, the second complex vector is the result of the computation, and the integer is the
+ *    number of elements in the vector;
+ *  size
+ *    Number of elements in the vector on which the transform will be applied;
+ *  repeat
+ *    Number of times the function will be called.
+ *
+ * Returns:
+ *   The average execution time for that function with a vector of the given size.
+ **************************************************************************************************/
+float time_it(void (*f)(Complex *, Complex *, int), int size, int repeat)
+{
+    vector<Complex> x(size), X(size);          // Vectors can be larger than the cache;
+
+    for(int j=0; j<size; j++)                  // Initialize the vector;
+        x[j] = Complex(j, 0);
+    auto t0 = chrono::steady_clock::now();     // Start counting time;
+    for(int j=0; j<repeat; j++)
+        (*f)(x.data(), X.data(), size);
+    auto t1 = chrono::steady_clock::now();     // End of time measuring;
+    return chrono::duration<float>(t1 - t0).count() / (float) repeat;
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: time_tables
+ *   Measures the time to create tables of length N: twiddle factors computed one by one with the
+ *   math library (as the plans used to be created), plans with a full or a two-level table, a
+ *   window or a chirp.
+ *
+ * Parameters:
+ *  N
+ *    Length of the transform;
+ *  which
+ *    0 for the factors computed one by one, 1 for a FULL plan, 2 for a TWO_LEVEL plan, 3 for a
+ *    window and 4 for a chirp;
+ *  repeat
+ *    Number of times the tables are created.
+ *
+ * Returns:
+ *   The average time to create the tables.
+ **************************************************************************************************/
+float time_tables(int N, int which, int repeat)
+{
+    vector<Complex> W(N);
+    vector<float> w(N);
+    auto t0 = chrono::steady_clock::now();     // Start counting time;
+    for(int j=0; j<repeat; j++)
+        switch(which) {
+            case 0: {
+                Plan *plan = new Plan;
+                for(int n=0; n<N/2; n++)
+                    plan->W.push_back(exact(n, N));
+                delete plan;
+                break;
+            }
+            case 1: delete new_plan(N, FULL); break;
+            case 2: delete new_plan(N, TWO_LEVEL); break;
+            case 3: hann_window(w.data(), N); break;
+            case 4: chirp(W.data(), N); break;
+        }
+    auto t1 = chrono::steady_clock::now();     // End of time measuring;
+    return chrono::duration<float>(t1 - t0).count() / (float) repeat;
+}
+
+
+/**************************************************************************************************
+ Main Function:
+ **************************************************************************************************/
+int main(int argc, char *argv[]) {
+
+    // Start by printing the table with time comparisons:
+    cout << "+---------+---------+---------+---------+---------+---------+---------+---------+" << endl;
+    cout << "|    N    |  Full   | 2-level | Recur.  | Error   | Error   | Error   | Error   |" << endl;
+    cout << "|         |  (KiB)  |  (KiB)  |  (KiB)  | Itera.  |  Full   | 2-level | Recur.  |" << endl;
+    cout << "+---------+---------+---------+---------+---------+---------+---------+---------+" << endl;
+
+    // Try it with vectors with size ranging from 4096 to 4194304 samples:
+    for(int r=12; r<23; r+=2) {
+
+        // Compute the memory and the errors:
+        int n = (int) exp2(r);
+        vector<Complex> x(n);
+        for(int j=0; j<n; j++)
+            x[j] = Complex(sin(j), cos(3*j));
+        vector<double> Xr, Xi;
+        reference_fft(x.data(), Xr, Xi, n);
+        float ierror = error(iterative_fft, x.data(), Xr, Xi, n);
+        float ferror = error(table_fft, x.data(), Xr, Xi, n);
+        float terror = error(two_level_fft, x.data(), Xr, Xi, n);
+        float rerror = error(recurrence_fft, x.data(), Xr, Xi, n);
+
+        // Print the results:
+        cout << "| " << setw(7) <<     n << " ";
+        cout << "| " << setw(7) << plan_memory(get_plan(n, FULL)) / 1024 << " ";
+        cout << "| " << setw(7) << setprecision(3)
+             << plan_memory(get_plan(n, TWO_LEVEL)) / 1024.0 << " ";
+        cout << "| " << setw(7) << plan_memory(get_plan(n, RECURRENCE)) / 1024 << " ";
+        cout << "| " << setw(7) << setprecision(2) << ierror << " ";
+        cout << "| " << setw(7) << setprecision(2) << ferror << " ";
+        cout << "| " << setw(7) << setprecision(2) << terror << " ";
+        cout << "| " << setw(7) << setprecision(2) << rerror << " |" << endl;
+    }
+
+    cout << "+---------+---------+---------+---------+---------+---------+---------+---------+" << endl;
+
+    // Compare the time of the transforms:
+    cout << "+---------+---------+---------+---------+---------+" << endl;
+    cout << "|    N    | Itera.  |  Full   | 2-level | Recur.  |" << endl;
+    cout << "+---------+---------+---------+---------+---------+" << endl;
+
+    for(int r=12; r<23; r+=2) {
+
+        // Compute the average execution time:
+        int n = (int) exp2(r);
+        int repeat = 1 + REPEAT * 4096 / n;
+        float itime = time_it(iterative_fft, n, repeat);
+        float ftime = time_it(table_fft, n, repeat);
+        float ttime = time_it(two_level_fft, n, repeat);
+        float rtime = time_it(recurrence_fft, n, repeat);
+
+        // Print the results:
+        cout << "| " << setw(7) <<     n << " ";
+        cout << "| " << setw(7) << setprecision(7) << itime << " ";
+        cout << "| " << setw(7) << setprecision(7) << ftime << " ";
+        cout << "| " << setw(7) << setprecision(7) << ttime << " ";
+        cout << "| " << setw(7) << setprecision(7) << rtime << " |" << endl;
+    }
+
+    cout << "+---------+---------+---------+---------+---------+" << endl;
+
+    // Compare the time to create plans and other tables:
+    cout << "+---------+---------+---------+---------+---------+---------+" << endl;
+    cout << "|    N    | Direct  |  Full   | 2-level | Window  |  Chirp  |" << endl;
+    cout << "+---------+---------+---------+---------+---------+---------+" << endl;
+
+    // Try it with sizes ranging from 4096 to 16777216 samples:
+    for(int r=12; r<25; r+=2) {
+
+        // Compute the average execution time:
+        int n = (int) exp2(r);
+        int repeat = 1 + REPEAT * 4096 / n;
+        float dtime = time_tables(n, 0, repeat);
+        float ftime = time_tables(n, 1, repeat);
+        float ttime = time_tables(n, 2, repeat);
+        float wtime = time_tables(n, 3, repeat);
+        float ctime = time_tables(n, 4, repeat);
+
+        // Print the results:
+        cout << "| " << setw(7) <<     n << " ";
+        cout << "| " << setw(7) << setprecision(7) << dtime << " ";
+        cout << "| " << setw(7) << setprecision(7) << ftime << " ";
+        cout << "| " << setw(7) << setprecision(7) << ttime << " ";
+        cout << "| " << setw(7) << setprecision(7) << wtime << " ";
+        cout << "| " << setw(7) << setprecision(7) << ctime << " |" << endl;
+    }
+
+    cout << "+---------+---------+---------+---------+---------+---------+" << endl;
+    return 0;
+}
@@ -0,0 +1,663 @@
+/**************************************************************************************************
+ * Fast Fourier Transform -- C++ Version
+ * This version implements a phase vocoder, to change the duration and the pitch of a sound.
+ *
+ * José Alexandre Nalon
+ **************************************************************************************************
+ * This program doesn't need much to be compiled and run. It can be done, as far as I know, with
+ * any C++ compiler, just remember to link the math library. Optimizations should be turned on, so
+ * the compiler can vectorize the inner loops; the square root is vectorized only if it doesn't
+ * need to set errno. In my box, I used the command:
+ *
+ * $ g++ -O3 -march=native -fno-math-errno -o vocoder vocoder.cpp -lm
+ *
+ * It can be run with the command (remember to change permission to execute):
+ *
+ * $ ./vocoder
+ *
+ * Obs.: The phase vocoder computes the short-time Fourier transform of the signal with frames
+ *   taken every Ha samples, and adds the inverse transforms of the frames every Hs samples, so
+ *   the duration is multiplied by Hs/Ha. The magnitude of every bin is kept, but the phase must
+ *   advance Hs/Ha times faster than in the analysis: the phase difference between frames gives
+ *   the exact frequency of every bin, and the phase of the synthesis is accumulated with it. That
+ *   is done only in the peaks of the spectrum, and the bins around every peak keep the phase
+ *   differences they had to the peak in the analysis (the identity phase locking, by Laroche and
+ *   Dolson), which avoids the "phasiness" of the simple vocoder. The pitch is changed by
+ *   stretching the sound and resampling it. The magnitudes and phases are computed with a fast
+ *   approximation of the arctangent, and the resynthesis with a fast approximation of sine and
+ *   cosine, written without branches so the loops can be vectorized; the spectrum is kept with the
+ *   real and imaginary parts in separate vectors, for the same reason. Every stream has its own
+ *   object, with its buffers allocated only once. The pitch is checked by counting the zero
+ *   crossings of a shifted tone.
+ **************************************************************************************************/
+
+/**************************************************************************************************
+ Include necessary libraries:
+ **************************************************************************************************/
+#include <iostream>                            // Input and Output;
+#include <iomanip>                             // I/O Manipulation;
+#include <cmath>                               // Math Functions;
+#include <chrono>                              // Time measurement;
+#include <vector>                              // Buffers;
+
+using namespace std;
+
+
+/**************************************************************************************************
+ Definitions:
+ **************************************************************************************************/
+#define RATE 44100                             // Sampling rate, in Hz;
+#define SECONDS 2                              // Duration of the test signal;
+#define LENGTH 2048                            // Length of the frames;
+#define STRETCH 1.25                           // Stretch factor used in the tests;
+#define TONE 440                               // Frequency of the tone used to check the pitch;
+#define ROUND 12582912.0f                      // 1.5 2^23, rounds a float to an integer;
+
+
+/**************************************************************************************************
+ Small class to operate with complex numbers:
+ **************************************************************************************************/
+class Complex {
+    public:
+        float r;                               // Real part;
+        float i;                               // Imaginary part;
+        Complex();                             // Constructors;
+        Complex(float re, float im);
+        void set(float re, float im);
+        void set(Complex c);
+        Complex operator+(Complex c);          // Addition (overload + operator);
+        Complex operator-(Complex c);          // Subtraction (overload - operator);
+        Complex operator*(Complex c);          // Product (overload * operator);
+        Complex operator*(float a);            // Product with a scalar;
+        Complex cexp();                        // Complex exponential;
+};
+
+Complex::Complex() {                           // Constructor;
+    r = 0.0;                                   // Real part;
+    i = 0.0;                                   // Imaginary part;
+}
+
+Complex::Complex(float re, float im) {         // Constructor;
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(float re, float im) {
+    r = re;                                    // Real part;
+    i = im;                                    // Imaginary part;
+}
+
+void Complex::set(Complex c) {
+    r = c.r;                                   // Real part;
+    i = c.i;                                   // Imaginary part;
+}
+
+Complex Complex::operator+(Complex c) {
+    return Complex(r + c.r, i + c.i);
+}
+
+Complex Complex::operator-(Complex c) {
+    return Complex(r - c.r, i - c.i);
+}
+
+Complex Complex::operator*(Complex c) {
+    return Complex(r*c.r - i*c.i, r*c.i + i*c.r);
+}
+
+Complex Complex::operator*(float a) {
+    return Complex(a*r, a*i);
+}
+
+Complex Complex::cexp() {
+    return Complex(exp(r)*cos(i), exp(r)*sin(i));
+}
+
+Complex cexpn(float a) {                       // Convenience function to compute the exponential;
+    return Complex(cos(a), sin(a));
+}
+
+
+/**************************************************************************************************
+ * Function: wrap
+ *   Reduces an angle to the interval [-pi, pi]. The nearest multiple of 2 pi is found by adding
+ *   and subtracting a large constant instead of calling floor, which the compiler doesn't
+ *   vectorize. It is exact for angles smaller than 2^21 pi.
+ *
+ * Parameters:
+ *   a
+ *     The angle.
+ *
+ * Returns:
+ *   The angle, reduced.
+ **************************************************************************************************/
+inline float wrap(float a)
+{
+    float n = (a * 0.159154943f + ROUND) - ROUND;
+    return a - 6.28318531f * n;
+}
+
+
+/**************************************************************************************************
+ * Function: fast_atan2
+ *   Approximation of the arctangent of y/x, in the four quadrants, with error smaller than 1e-5.
+ *   The arctangent is computed in the first octant by a polynomial and moved to the right
+ *   quadrant by symmetry, using only selections, so the compiler can vectorize it.
+ *
+ * Parameters:
+ *   y, x
+ *     The coordinates of the point.
+ *
+ * Returns:
+ *   The angle of the point, between -pi and pi.
+ **************************************************************************************************/
+inline float fast_atan2(float y, float x)
+{
+    float ax = fabs(x), ay = fabs(y);
+    float a = (ax < ay) ? ax / (ay + 1e-30f) : ay / (ax + 1e-30f);
+    float s = a * a;
+    float r = ((-0.0464964749f * s + 0.15931422f) * s - 0.327622764f) * s * a + a;
+    r = (ay > ax) ? 1.57079637f - r : r;
+    r = (x < 0) ? 3.14159274f - r : r;
+    return (y < 0) ? -r : r;
+}
+
+
+/**************************************************************************************************
+ * Function: fast_sin, fast_sincos
+ *   Approximation of sine and cosine, with error smaller than 1e-6. The angle is reduced to the
+ *   interval [-pi, pi], then to [-pi/2, pi/2] by symmetry, where the sine is computed by a
+ *   polynomial; the cosine is the sine of the angle plus pi/2.
+ *
+ * Parameters:
+ *   a
+ *     The angle;
+ *   s, c
+ *     Receive the sine and the cosine.
+ **************************************************************************************************/
+inline float fast_sin(float a)
+{
+    a = wrap(a);
+    a = (a > 1.57079633f) ? 3.14159265f - a : a;
+    a = (a < -1.57079633f) ? -3.14159265f - a : a;
+    float s = a * a;
+    return a * (1 + s * (-1.66666667e-1f + s * (8.33333333e-3f + s * (-1.98412698e-4f
+             + s * (2.75573192e-6f + s * -2.50521084e-8f)))));
+}
+
+inline void fast_sincos(float a, float &s, float &c)
+{
+    s = fast_sin(a);
+    c = fast_sin(a + 1.57079633f);
+}
+
+
+/**************************************************************************************************
+ * Function: bit_reverse
+ *   Bit-reversed version of an integer number.
+ *
+ * Parameters:
+ *   k
+ *     The number to be bit-reversed;
+ *   r
+ *     The number of bits to take into consideration when reversing.
+ *
+ * Returns:
+ *   The number k, bit-reversed according to integers with r bits.
+ **************************************************************************************************/
+int bit_reverse(int k, int r)
+{
+    int l = 0;                                 // Accumulate the results;
+    for(int i=0; i<r; i++) {                   // Loop on every bit;
+        l = (l << 1) + (k & 1);                // Test less signficant bit and add;
+        k >>= 1;                               // Test next bit;
+    }
+    return l;
+}
+
+
+/**************************************************************************************************
+ Plans hold everything that depends only on the length of the transform:
+ **************************************************************************************************/
+struct Plan {
+    int N;                                     // Length of the transform;
+    vector<int> rev;                           // Bit-reversed indices;
+    vector<Complex> W;                         // Twiddle factors, W[n] = exp(-2 pi n/N);
+};
+
+
+/**************************************************************************************************
+ * Function: make_plan
+ *   Computes the plan for a given length.
+ *
+ * Parameters:
+ *   N
+ *     The length of the transform. It must be a power of two.
+ *
+ * Returns:
+ *   The plan.
+ **************************************************************************************************/
+Plan make_plan(int N)
+{
+    Plan plan;
+    plan.N = N;
+    int r = (int) floor(log2(N));              // Number of bits;
+    plan.rev.resize(N);
+    for(int k=0; k<N; k++)                     // Bit-reversed order;
+        plan.rev[k] = bit_reverse(k, r);
+    plan.W.resize(N/2 + 1);
+    for(int n=0; n<=N/2; n++)                  // Twiddle factors computed directly;
+        plan.W[n] = cexpn(-2*M_PI*n/N);
+    return plan;
+}
+
+
+/**************************************************************************************************
+ * Function: fft
+ *   Fast Fourier Transform using an iterative in-place decimation in time algorithm, with the
+ *   twiddle factors taken from the plan.
+ *
+ * Parameters:
+ *   plan
+ *     Plan for the length of the transform;
+ *   x
+ *     The vector of which the FFT will be computed;
+ *   X
+ *     The vector that will receive the results of the computation. It needs to be allocated prior
+ *     to the function call, and it can't be the same as the input.
+ **************************************************************************************************/
+void fft(Plan &plan, Complex x[], Complex X[])
+{
+    int N = plan.N;
+    for(int k=0; k<N; k++)                     // Reorder the vector according to the
+        X[plan.rev[k]] = x[k];                 //   bit-reversed order;
+
+    for(int step=1; step<N; step<<=1) {
+        int stride = N / (2*step);             // Distance between twiddle factors in the table;
+        for(int l=0; l<N; l+=2*step)
+            for(int n=0; n<step; n++) {
+                int p = l + n;
+                int q = p + step;
+                Complex w = plan.W[n*stride] * X[q];
+                X[q] = X[p] - w;               // Recombine results;
+                X[p] = X[p] + w;
+            }
+    }
+}
+
+
+/**************************************************************************************************
+ Class that implements the phase vocoder for one stream. Every call takes Ha samples of the input
+ and gives the samples of the output that are ready:
+ **************************************************************************************************/
+class Vocoder {
+    public:
+        Vocoder(int N, float stretch, float pitch, bool fast);
+        int hop();
+        int process(float x[], float y[]);
+    private:
+        int N;                                 // Length of the frames;
+        int Ha;                                // Analysis hop;
+        int Hs;                                // Synthesis hop;
+        int Ho;                                // Output samples per call, after resampling;
+        bool fast;                             // Use the fast approximations;
+        bool first;                            // Indicates the first frame;
+        float gain;                            // Compensates the overlap of the windows;
+        float last;                            // Last sample of the previous block (resampling);
+        Plan half;                             // Plan for the real transforms (length N/2);
+        vector<Complex> split;                 // Twiddle factors to split the spectrum;
+        vector<float> window;                  // Hann window;
+        vector<float> in, out;                 // Input frame and overlap-add buffer;
+        vector<Complex> z, Z;                  // Buffers for the transforms;
+        vector<float> re, im;                  // Spectrum of the frame, in separate parts;
+        vector<float> mag, phase, last_phase;  // Analysis, in every bin;
+        vector<float> psi, cand;               // Synthesis phases, accumulated and candidate;
+        vector<int> peak;                      // Peak that owns every bin;
+        vector<float> frame;                   // Synthesized frame;
+        void analyze();
+        void synthesize();
+};
+
+
+/**************************************************************************************************
+ * Method: Vocoder::Vocoder
+ *   Allocates the buffers and computes the tables.
+ *
+ * Parameters:
+ *   N
+ *     Length of the frames. It must be a power of two;
+ *   stretch
+ *     Factor by which the duration is multiplied;
+ *   pitch
+ *     Factor by which the frequencies are multiplied;
+ *   fast
+ *     If true, uses the fast approximations of the arctangent, sine and cosine.
+ **************************************************************************************************/
+Vocoder::Vocoder(int N, float stretch, float pitch, bool fast)
+{
+    this->N = N;
+    this->fast = fast;
+    Ha = N / 8;
+    Ho = (int) round(Ha * stretch);            // Stretch by stretch*pitch, resample by 1/pitch;
+    Hs = (int) round(Ha * stretch * pitch);
+    first = true;
+    last = 0;
+    half = make_plan(N/2);
+    split.resize(N/2 + 1);
+    for(int k=0; k<=N/2; k++)
+        split[k] = cexpn(-2*M_PI*k/N);
+    window.resize(N);
+    float w2 = 0;
+    for(int n=0; n<N; n++) {
+        window[n] = 0.5 - 0.5 * cos(2*M_PI*n/N);
+        w2 += window[n] * window[n];
+    }
+    gain = Hs / w2;                            // Analysis and synthesis windows overlapped;
+    in.resize(N);
+    out.resize(N + Hs);
+    z.resize(N/2 + 1);
+    Z.resize(N/2 + 1);
+    re.resize(N/2 + 1);
+    im.resize(N/2 + 1);
+    mag.resize(N/2 + 1);
+    phase.resize(N/2 + 1);
+    last_phase.resize(N/2 + 1);
+    psi.resize(N/2 + 1);
+    cand.resize(N/2 + 1);
+    peak.resize(N/2 + 1);
+    frame.resize(N);
+}
+
+
+/**************************************************************************************************
+ * Method: Vocoder::hop
+ *   Number of input samples taken by every call.
+ **************************************************************************************************/
+int Vocoder::hop()
+{
+    return Ha;
+}
+
+
+/**************************************************************************************************
+ * Method: Vocoder::analyze
+ *   Computes the magnitude and the phase of the spectrum of the input frame. The frame is real,
+ *   so it is transformed by a complex FFT of half the length.
+ **************************************************************************************************/
+void Vocoder::analyze()
+{
+    int H = N / 2;
+    for(int n=0; n<H; n++)                     // Window and pack the real frame;
+        z[n] = Complex(in[2*n] * window[2*n], in[2*n+1] * window[2*n+1]);
+    fft(half, z.data(), Z.data());
+    Z[H] = Z[0];
+
+    for(int k=0; k<=H; k++) {                  // Split the spectrum;
+        Complex a = Z[k];
+        Complex b = Complex(Z[H-k].r, -Z[H-k].i);
+        Complex O = a - b;
+        Complex c = (a + b) * 0.5 + split[k] * Complex(O.i * 0.5, -O.r * 0.5);
+        re[k] = c.r;
+        im[k] = c.i;
+    }
+
+    if(fast)                                   // This loop is vectorized;
+        for(int k=0; k<=H; k++) {
+            mag[k] = sqrtf(re[k]*re[k] + im[k]*im[k]);
+            phase[k] = fast_atan2(im[k], re[k]);
+        }
+    else
+        for(int k=0; k<=H; k++) {
+            mag[k] = sqrtf(re[k]*re[k] + im[k]*im[k]);
+            phase[k] = atan2(im[k], re[k]);
+        }
+}
+
+
+/**************************************************************************************************
+ * Method: Vocoder::synthesize
+ *   Computes the phases of the synthesis, with identity phase locking, and the inverse transform
+ *   of the frame.
+ **************************************************************************************************/
+void Vocoder::synthesize()
+{
+    int H = N / 2;
+    if(first) {                                // First frame keeps its phases;
+        for(int k=0; k<=H; k++)
+            psi[k] = phase[k];
+        first = false;
+    } else {
+        float r = (float) Hs / Ha;
+        float dw = 2*M_PI*Ha / N;              // Expected advance between bins;
+        for(int k=0; k<=H; k++) {              // Phase advance of every bin (vectorized);
+            float w = dw * k;                  // Expected advance;
+            float d = wrap(phase[k] - last_phase[k] - w);
+            cand[k] = wrap(psi[k] + r * (w + d));
+        }
+
+        int prev = -1;                         // Peaks, and the bins they own (up to the
+        for(int k=0; k<=H; k++) {              //   middle between peaks);
+            bool is_peak = (k == 0 || mag[k] > mag[k-1]) && (k == H || mag[k] >= mag[k+1]);
+            if(is_peak) {
+                int from = (prev < 0) ? 0 : (prev + k) / 2 + 1;
+                for(int j=from; j<=k; j++)
+                    peak[j] = k;
+                prev = k;
+            } else
+                peak[k] = max(prev, 0);
+        }
+
+        for(int k=0; k<=H; k++) {              // Keep the phase relations to the peak;
+            int q = peak[k];
+            psi[k] = cand[q] + phase[k] - phase[q];
+        }
+    }
+    for(int k=0; k<=H; k++)
+        last_phase[k] = phase[k];
+
+    if(fast)                                   // Back to rectangular form (vectorized);
+        for(int k=0; k<=H; k++) {
+            float s, c;
+            fast_sincos(psi[k], s, c);
+            re[k] = mag[k] * c;
+            im[k] = mag[k] * s;
+        }
+    else
+        for(int k=0; k<=H; k++) {
+            re[k] = mag[k] * cos(psi[k]);
+            im[k] = mag[k] * sin(psi[k]);
+        }
+
+    for(int k=0; k<H; k++) {                   // Join the transforms of even and odd samples,
+        Complex a = Complex(re[k], im[k]);     //   conjugated to compute the inverse;
+        Complex b = Complex(re[H-k], -im[H-k]);
+        Complex E = a + b;
+        Complex O = (a - b) * Complex(split[k].r, -split[k].i);
+        Z[k] = Complex(E.r - O.i, -(E.i + O.r));
+    }
+    fft(half, Z.data(), z.data());
+    for(int n=0; n<H; n++) {                   // Unpack the real frame;
+        frame[2*n] = z[n].r / N;
+        frame[2*n+1] = -z[n].i / N;
+    }
+}
+
+
+/**************************************************************************************************
+ * Method: Vocoder::process
+ *   Takes Ha samples of the input, computes one frame and adds it to the output. If the pitch is
+ *   changed, the Hs samples that are ready are resampled by linear interpolation; the last sample
+ *   of the previous block is kept, so blocks are joined without gaps.
+ *
+ * Parameters:
+ *   x
+ *     Ha samples of the input;
+ *   y
+ *     Receives the output.
+ *
+ * Returns:
+ *   The number of samples written in the output.
+ **************************************************************************************************/
+int Vocoder::process(float x[], float y[])
+{
+    for(int n=0; n<N-Ha; n++)                  // Slide the input frame;
+        in[n] = in[n + Ha];
+    for(int n=0; n<Ha; n++)
+        in[N - Ha + n] = x[n];
+
+    analyze();
+    synthesize();
+    for(int n=0; n<N; n++)                     // Overlap and add;
+        out[n] += frame[n] * window[n] * gain;
+
+    if(Ho == Hs)
+        for(int n=0; n<Hs; n++)
+            y[n] = out[n];
+    else {
+        float step = (float) Hs / Ho;
+        for(int n=0; n<Ho; n++) {              // Positions from -1 to Hs - 1;
+            float t = n * step - 1;
+            int i = (int) floor(t);
+            float f = t - i;
+            float a = (i < 0) ? last : out[i];
+            y[n] = a + f * (out[i + 1] - a);
+        }
+        last = out[Hs - 1];
+    }
+
+    for(int n=0; n<N; n++)                     // Slide the output buffer;
+        out[n] = out[n + Hs];
+    for(int n=N; n<N+Hs; n++)
+        out[n] = 0;
+    return Ho;
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: measure
+ *   Stretches a number of streams, with the exact and the fast functions, and measures the time.
+ *
+ * Parameters:
+ *  S
+ *    Number of streams;
+ *  times
+ *    Receives the time to process one second of one stream, with the exact and fast functions.
+ *
+ * Returns:
+ *   The largest difference between the results, relative to the largest sample.
+ **************************************************************************************************/
+float measure(int S, float times[])
+{
+    int L = RATE * SECONDS;
+    vector<float> x(L);
+    for(int n=0; n<L; n++)                     // A chord with vibrato;
+        x[n] = 0.3*sin(2*M_PI*220*n/RATE + 3*sin(2*M_PI*5*n/RATE))
+             + 0.2*sin(2*M_PI*330*n/RATE) + 0.1*sin(2*M_PI*440*n/RATE);
+    vector<vector<float>> y(2, vector<float>(2*L));
+    vector<float> scratch(LENGTH);
+
+    for(int i=0; i<2; i++) {
+        vector<Vocoder> v(S, Vocoder(LENGTH, STRETCH, 1, i == 1));
+        int Ha = v[0].hop();
+        auto t0 = chrono::steady_clock::now(); // Start counting time;
+        long o = 0;
+        for(int n=0; n+Ha<=L; n+=Ha) {         // Streams interleaved, frame by frame; only the
+            int m = 0;                         //   first stream is kept;
+            for(int s=0; s<S; s++)
+                m = v[s].process(&x[n], (s == 0) ? &y[i][o] : scratch.data());
+            o += m;
+        }
+        auto t1 = chrono::steady_clock::now(); // End of time measuring;
+        times[i] = chrono::duration<float>(t1 - t0).count() / (S * SECONDS);
+    }
+
+    float error = 0, peak = 0;
+    for(long n=0; n<(long) y[0].size(); n++) {
+        error = fmax(error, fabs(y[0][n] - y[1][n]));
+        peak = fmax(peak, fabs(y[0][n]));
+    }
+    return error / peak;
+}
+
+
+/**************************************************************************************************
+ * Auxiliary function: frequency
+ *   Shifts the pitch of a tone, with the fast functions, and estimates the frequency of the
+ *   result by the zero crossings. The beginning and the end of the output are not used, so the
+ *   transients don't change the estimate.
+ *
+ * Parameters:
+ *  pitch
+ *    Factor by which the frequencies are multiplied.
+ *
+ * Returns:
+ *   The frequency of the output, in Hz.
+ **************************************************************************************************/
+float frequency(float pitch)
+{
+    int L = RATE * SECONDS;
+    vector<float> x(L), y(2*L);
+    for(int n=0; n<L; n++)
+        x[n] = 0.5*sin(2*M_PI*TONE*n/RATE);
+
+    Vocoder v(LENGTH, 1, pitch, true);
+    int Ha = v.hop();
+    long o = 0;
+    for(int n=0; n+Ha<=L; n+=Ha)
+        o += v.process(&x[n], &y[o]);
+
+    double t0 = -1, t1 = 0;                    // First and last crossings, interpolated;
+    int count = 0;
+    for(long n=o/4; n<3*o/4; n++)
+        if(y[n] < 0 && y[n+1] >= 0) {
+            double t = n + y[n] / (y[n] - y[n+1]);
+            if(t0 < 0)
+                t0 = t;
+            t1 = t;
+            count++;
+        }
+    return (count - 1) * RATE / (t1 - t0);
+}
+
+
+/**************************************************************************************************
+ Main Function:
+ **************************************************************************************************/
+int main(int argc, char *argv[]) {
+
+    // Start by printing the table with time comparisons:
+    cout << "+---------+---------+---------+---------+---------+" << endl;
+    cout << "| Streams |  Libm   |  Fast   | x Real  | Error   |" << endl;
+    cout << "+---------+---------+---------+---------+---------+" << endl;
+
+    // Try it with the number of streams ranging from 1 to 32:
+    for(int r=0; r<6; r++) {
+
+        // Compute the time to process one second of one stream:
+        int S = (int) exp2(r);
+        float times[2];
+        float error = measure(S, times);
+
+        // Print the results:
+        cout << "| " << setw(7) <<     S << " ";
+        cout << "| " << setw(7) << setprecision(7) << times[0] << " ";
+        cout << "| " << setw(7) << setprecision(7) << times[1] << " ";
+        cout << "| " << setw(7) << setprecision(7) << 1 / (S * times[1]) << " ";
+        cout << "| " << setw(7) << setprecision(7) << error << " |" << endl;
+    }
+
+    cout << "+---------+---------+---------+---------+---------+" << endl;
+
+    // Check the pitch shift, with a tone:
+    cout << endl;
+    cout << "+---------+---------+---------+" << endl;
+    cout << "|  Pitch  | Expect. |  Freq.  |" << endl;
+    cout << "+---------+---------+---------+" << endl;
+    float pitches[] = { 0.75, 1.25, 1.5 };
+    for(float p : pitches) {
+        cout << "| " << setw(7) << setprecision(7) << p << " ";
+        cout << "| " << setw(7) << setprecision(7) << p * TONE << " ";
+        cout << "| " << setw(7) << setprecision(7) << frequency(p) << " |" << endl;
+    }
+    cout << "+---------+---------+---------+" << endl;
+    return 0;
+}